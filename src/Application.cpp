@@ -13,15 +13,24 @@
 #include "Gui.h"
 #include "Timer.h"
 #include "Scene.h"
+#include "JobSystem.h"
+#include "RenderSnapshot.h"
 #include "Utils.h"
 #include "Logger.h"
 
-Application::Application()
+#include <thread>
+
+Application::Application(unsigned int seed, Threading threading, int framesInFlight)
     : m_sound(std::make_unique<SoundEngine>())
     , m_camera(std::make_unique<Camera>())
     , m_timer(std::make_unique<Timer>())
     , m_physics(std::make_unique<PhysicsEngine>())
-    , m_game(std::make_unique<Game>(*m_camera, *m_physics))
+    , m_game(std::make_unique<Game>(*m_camera, *m_physics, *m_sound, seed))
+    , m_jobs(std::make_unique<JobSystem>())
+    , m_snapshots(std::make_unique<SnapshotBuffer>())
+    , m_running(false)
+    , m_threading(threading)
+    , m_framesInFlight(framesInFlight)
 {
 }
 
@@ -31,32 +40,197 @@ void Application::Run()
 {
     m_sound->PlayMusic(SoundEngine::GAME);
 
+    switch (m_threading)
+    {
+    case PIPELINED:
+        RunPipelined();
+        break;
+    case RENDER_THREAD:
+        RunRenderThread();
+        break;
+    default:
+        RunSequential();
+        break;
+    }
+}
+
+void Application::RunSequential()
+{
+    while(m_engine->IsRunning())
+    {
+        UpdateInput();
+        TickSimulation();
+        Render();
+        m_engine->EndRender();
+    }
+}
+
+void Application::RunPipelined()
+{
+    LogInfo("Application: Running pipelined simulation");
+
+    m_running = true;
+    std::thread simulation([this]()
+    {
+        // Simulation may only run one frame ahead of the renderer
+        while (m_running && m_snapshots->WaitForAcquire())
+        {
+            std::unique_lock<std::mutex> lock(m_simulationMutex);
+            ApplyInput();
+
+            // The tweak bar reads and writes the simulation directly so
+            // the tick only overlaps rendering while it is hidden
+            if (!m_gui->IsShown())
+            {
+                lock.unlock();
+            }
+            TickSimulation();
+        }
+    });
+
     while(m_engine->IsRunning())
     {
-        m_timer->UpdateTimer();
+        {
+            std::lock_guard<std::mutex> lock(m_simulationMutex);
+            PollInput();
+        }
+
+        Render();
+        m_engine->EndRender();
+    }
+
+    m_running = false;
+    m_snapshots->Stop();
+    simulation.join();
+}
+
+void Application::RunRenderThread()
+{
+    LogInfo("Application: Running render thread with " + 
+        std::to_string(m_framesInFlight) + " frames in flight");
+
+    // The context can only be current on one thread at a time
+    m_engine->MakeContextCurrent(false);
+
+    std::thread renderer([this]()
+    {
+        m_engine->MakeContextCurrent(true);
+        while (m_engine->SubmitFrame())
+        {
+            if (m_gui->IsShown())
+            {
+                // The tweak bar reads values owned by the simulation
+                std::lock_guard<std::mutex> lock(m_simulationMutex);
+                m_gui->Render();
+            }
+
+            // Waiting for the swap no longer holds up the simulation
+            m_engine->PresentFrame();
+        }
+        m_engine->MakeContextCurrent(false);
+    });
+
+    // Window events must be processed on the main thread
+    while (m_engine->IsRunning())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_simulationMutex);
+            m_engine->PollEvents();
+            UpdateInput();
+
+            // Only the tweak bar is drawn from the render thread under the lock
+            if (!m_gui->IsShown())
+            {
+                lock.unlock();
+            }
+            TickSimulation();
+        }
+
+        if (!m_engine->RecordFrame(m_snapshots->Acquire()))
+        {
+            break;
+        }
+    }
+
+    m_engine->StopRenderQueue();
+    renderer.join();
+
+    // Resources are released on the main thread
+    m_engine->MakeContextCurrent(true);
+}
+
+void Application::UpdateInput()
+{
+    PollInput();
+    ApplyInput();
+}
+
+void Application::PollInput()
+{
+    // Window input must be processed on the main thread
+    m_input->Poll();
+    m_aspectRatio = m_engine->AspectRatio();
+}
+
+void Application::ApplyInput()
+{
+    m_input->Dispatch();
+    m_gui->Update(*m_input);
+    m_camera->SetAspectRatio(m_aspectRatio);
+}
 
-        const float deltaTime = m_timer->GetDeltaTime();
+void Application::TickSimulation()
+{
+    m_timer->UpdateTimer();
+
+    const float deltaTime = m_timer->GetDeltaTime();
+
+    const float physicsDeltaTime = PhysicsEngine::GetPhysicsDeltaTime(deltaTime);
+    const float physicsTimeStep = PhysicsEngine::GetTimeStep(physicsDeltaTime);
 
-        // These values are taken from the previous implementation of this game
-        const float physicsDeltaTime = ConvertRange(Clamp(
-            deltaTime, 0.2f, 20.0f), 0.2f, 20.0f, 0.02f, 0.4f);
-        const float physicsTimeStep = Clamp(
-            physicsDeltaTime * 0.075f, 0.001f, 0.01f);
+    m_sound->Update();
 
-        m_sound->Update();
-        m_input->Update();       
-        m_gui->Update(*m_input);
-        m_scene->Tick();
-        m_game->PrePhysicsTick(deltaTime, physicsDeltaTime);
+    const auto prePhysics = m_game->AddPrePhysicsJobs(
+        *m_jobs, deltaTime, physicsDeltaTime, {});
+
+    const auto camera = m_jobs->Add("Camera", [this, deltaTime]()
+    {
         m_camera->Update(*m_input, deltaTime);
+    }, { prePhysics });
 
+    const auto physics = m_jobs->Add("Physics", [this, physicsTimeStep]()
+    {
         m_physics->Tick(physicsTimeStep);
-        m_game->PostPhysicsTick(deltaTime);
+    }, { camera });
 
-        m_engine->RenderScene();
-        m_gui->Render();
-        m_engine->EndRender();
+    const auto postPhysics = m_game->AddPostPhysicsJobs(
+        *m_jobs, deltaTime, { physics });
+
+    // Transforms are updated once physics has exported the new positions
+    m_scene->AddTickJobs(*m_jobs, { postPhysics });
+    m_jobs->Execute();
+
+    auto& snapshot = m_snapshots->GetWriteSnapshot();
+    snapshot.viewProjection = m_camera->ViewProjection();
+    snapshot.projection = m_camera->Projection();
+    snapshot.cameraPosition = m_camera->Position();
+    m_scene->FillSnapshot(snapshot);
+    m_snapshots->Publish();
+}
+
+void Application::Render()
+{
+    const RenderSnapshot& snapshot = m_snapshots->Acquire();
+
+    // Input and the gui change render settings and the tweak bar reads values
+    // owned by the simulation, which only holds the lock to apply them
+    std::unique_lock<std::mutex> lock(m_simulationMutex, std::defer_lock);
+    if (m_threading == PIPELINED)
+    {
+        lock.lock();
     }
+    m_engine->RenderScene(snapshot);
+    m_gui->Render();
 }
 
 void Application::Release()
@@ -72,8 +246,8 @@ void Application::Release()
 bool Application::Initialise()
 {
     m_scene = std::make_unique<Scene>();
-    m_engine = std::make_unique<OpenGLEngine>(
-        m_scene->GetSceneData(), *m_camera);
+    m_engine = std::make_unique<OpenGLEngine>(m_scene->GetSceneData());
+    m_engine->SetFramesInFlight(m_framesInFlight);
 
     if (!m_engine->Initialise())
     {
@@ -81,7 +255,7 @@ bool Application::Initialise()
         return false;
     }
 
-    if (!m_scene->Initialise(*m_physics))
+    if (!m_scene->Initialise(*m_physics, *m_jobs))
     {
         LogError("Could not initialise scene");
         return false;
@@ -93,11 +267,18 @@ bool Application::Initialise()
         return false;
     }
 
+    // Requires the static batches created by the game
+    if (!m_engine->InitialiseScene())
+    {
+        LogError("Could not initialise render engine scene");
+        return false;
+    }
+
     InitialiseInput();
 
     // Requires application to be fully initialiseds
     m_gui = std::make_unique<Gui>(
-        *m_scene, *m_game, *m_camera, *m_input, *m_timer);
+        *m_scene, *m_game, *m_camera, *m_input, *m_timer, *m_jobs, *m_engine);
 
     return true;
 }
@@ -5,8 +5,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <atomic>
 
 class PhysicsEngine;
+class JobSystem;
 class SoundEngine;
 class OpenGLEngine;
 class Camera;
@@ -15,6 +18,7 @@ class Timer;
 class Gui;
 class Scene;
 class Game;
+class SnapshotBuffer;
 
 /**
 * Main application class
@@ -23,7 +27,27 @@ class Application
 {
 public:
 
-    Application();
+    /**
+    * How the simulation and rendering are spread across threads
+    */
+    enum Threading
+    {
+        SEQUENTIAL,      ///< Simulates and renders each frame on the main thread
+        PIPELINED,       ///< Simulates the next frame on a separate thread while rendering
+        RENDER_THREAD    ///< Submits recorded frames on a separate thread which owns the context
+    };
+
+    /**
+    * Constructor
+    * @param seed The seed for all random values in the game
+    * @param threading How the simulation and rendering are spread across threads
+    * @param framesInFlight The number of frames which can be recorded ahead of the GPU
+    */
+    Application(unsigned int seed, Threading threading = SEQUENTIAL, int framesInFlight = 3);
+
+    /**
+    * Destructor
+    */
     ~Application();
 
     /**
@@ -55,6 +79,46 @@ private:
     */
     void InitialiseInput();
 
+    /**
+    * Simulates and renders each frame one after the other
+    */
+    void RunSequential();
+
+    /**
+    * Simulates the next frame on a separate thread while rendering the current
+    */
+    void RunPipelined();
+
+    /**
+    * Simulates and records frames on the main thread while a render thread submits them
+    */
+    void RunRenderThread();
+
+    /**
+    * Updates the window input and gui
+    */
+    void UpdateInput();
+
+    /**
+    * Reads the window input and size which are only known on the main thread
+    */
+    void PollInput();
+
+    /**
+    * Applies the last polled input to the gui and simulation
+    */
+    void ApplyInput();
+
+    /**
+    * Simulates a single frame and publishes the result for rendering
+    */
+    void TickSimulation();
+
+    /**
+    * Renders the last published frame
+    */
+    void Render();
+
 private:
 
     std::unique_ptr<PhysicsEngine> m_physics;       ///< Physics world
@@ -66,4 +130,11 @@ private:
     std::unique_ptr<Timer> m_timer;                 ///< Keeps track of time between ticks and simulation
     std::unique_ptr<Scene> m_scene;                 ///< Manager of game objects
     std::unique_ptr<Game> m_game;                   ///< Game objects build on scene elements
+    std::unique_ptr<JobSystem> m_jobs;              ///< Runs the frame update across threads
+    std::unique_ptr<SnapshotBuffer> m_snapshots;    ///< Handoff of frames from simulation to rendering
+    std::mutex m_simulationMutex;                   ///< Guards the simulation from input and gui changes
+    std::atomic<bool> m_running;                    ///< Whether the simulation thread should keep running
+    float m_aspectRatio = 1.0f;                     ///< Window aspect ratio at the last input poll
+    const Threading m_threading = SEQUENTIAL;       ///< How the frame is spread across threads
+    const int m_framesInFlight = 3;                 ///< Frames which can be recorded ahead of the GPU
 };
\ No newline at end of file
@@ -7,7 +7,7 @@
 #include "GameData.h"
 #include "SceneData.h"
 #include "GlmHelper.h"
-#include "SoundEngine.h"
+#include "SoundSink.h"
 
 namespace
 {
@@ -21,10 +21,12 @@ namespace
 
 BulletManager::BulletManager(PhysicsEngine& physics,
                              GameData& gameData,
-                             SceneData& sceneData)
+                             SceneData& sceneData,
+                             SoundSink& sound)
     : m_physics(physics)
     , m_gameData(gameData)
     , m_sceneData(sceneData)
+    , m_sound(sound)
 {
 }
 
@@ -109,7 +111,7 @@ void BulletManager::FireBullet(const Tank& tank)
                 bullet->Reset();
                 bullet->SetIsAlive(true);
 
-                SoundEngine::PlaySoundEffect(SoundEngine::SHOOT);
+                m_sound.PlaySoundEffect(SoundSink::SHOOT);
 
                 glm::mat4 world = tank.GetGunWorldMatrix();
                 const glm::vec3 up = glm::matrix_get_up(world);
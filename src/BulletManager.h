@@ -7,6 +7,7 @@
 class Tank;
 class Bullet;
 class PhysicsEngine;
+class SoundSink;
 struct SceneData;
 struct GameData;
 
@@ -22,10 +23,12 @@ public:
     * @param physics The physics world
     * @param gameData Objects from the game to update
     * @param sceneData Meshes from the scene to update
+    * @param sound Plays sounds for the game
     */
     BulletManager(PhysicsEngine& physics,
                   GameData& gameData,
-                  SceneData& sceneData);
+                  SceneData& sceneData,
+                  SoundSink& sound);
 
     /**
     * Destructor
@@ -70,4 +73,5 @@ private:
     PhysicsEngine& m_physics;  ///< The physics world to update from
     GameData& m_gameData;      ///< Objects from the game to update
     SceneData& m_sceneData;    ///< Meshes from the scene to update
+    SoundSink& m_sound;        ///< Plays sounds for the game
 };
@@ -15,7 +15,6 @@ namespace
     const float FRUSTRUM_NEAR = 1.0f;
     const float FRUSTRUM_FAR = 1000.0f;
     const float FIELD_OF_VIEW = 45.0f;
-    const float RATIO = WINDOW_WIDTH / static_cast<float>(WINDOW_HEIGHT);
 }
 
 Camera::Camera()
@@ -31,7 +30,17 @@ Camera::Camera()
     , m_requiresUpdate(true)
     , m_useFlyCamera(false)
 {
-    m_projection = glm::perspective(FIELD_OF_VIEW, RATIO, FRUSTRUM_NEAR, FRUSTRUM_FAR);
+    SetAspectRatio(WINDOW_WIDTH / static_cast<float>(WINDOW_HEIGHT));
+}
+
+void Camera::SetAspectRatio(float ratio)
+{
+    if (ratio != m_aspectRatio)
+    {
+        m_aspectRatio = ratio;
+        m_projection = glm::perspective(FIELD_OF_VIEW, ratio, FRUSTRUM_NEAR, FRUSTRUM_FAR);
+        m_requiresUpdate = true;
+    }
 }
 
 void Camera::AddToTweaker(Tweaker& tweaker)
@@ -127,6 +136,11 @@ void Camera::Update(const Input& input, float deltatime)
         }
     }
 
+    UpdateView();
+}
+
+void Camera::UpdateView()
+{
     if (m_requiresUpdate)
     {
         m_requiresUpdate = false;
@@ -36,6 +36,11 @@ public:
     */
     void Update(const Input& input, float deltatime);
 
+    /**
+    * Recalculates the view matrix if the camera has moved since the last update
+    */
+    void UpdateView();
+
     /**
     * Resets the camera to the initial state
     */
@@ -101,6 +106,12 @@ public:
     */
     void Rotate(const glm::vec2& direction, float value);
 
+    /**
+    * Sets the width of the view relative to its height
+    * @param ratio The width divided by the height
+    */
+    void SetAspectRatio(float ratio);
+
     /**
     * @return the view projection glm::mat4
     */
@@ -156,6 +167,7 @@ private:
     float m_yaw = 0.0f;                  ///< Degrees amount of yaw
     float m_pitch = 0.0f;                ///< Degrees amount of pitch
     float m_roll = 0.0f;                 ///< Degrees amount of roll
+    float m_aspectRatio = 0.0f;          ///< Width of the view relative to its height
     float m_rotationSpeed = 0.0f;        ///< Speed to rotate the camera by
     float m_translateSpeed = 0.0f;       ///< Speed to translate the camera by
     float m_forwardSpeed = 0.0f;         ///< Speed to move foward with
@@ -7,7 +7,7 @@
 #include "GameData.h"
 #include "SceneData.h"
 #include "DataIDs.h"
-#include "SoundEngine.h"
+#include "SoundSink.h"
 
 namespace
 {
@@ -18,10 +18,12 @@ namespace
 
 CollisionManager::CollisionManager(PhysicsEngine& physics,
                                    GameData& gameData,
-                                   SceneData& sceneData)
+                                   SceneData& sceneData,
+                                   SoundSink& sound)
     : m_physics(physics)
     , m_gameData(gameData)
     , m_sceneData(sceneData)
+    , m_sound(sound)
 {
 }
 
@@ -94,7 +96,7 @@ void CollisionManager::IncrementCollisionGroupIndex()
 
 Tank* CollisionManager::GetTank(int instanceID) const
 {
-    if (instanceID == Instance::PLAYER)
+    if (instanceID == m_gameData.player->GetInstance())
     {
         return m_gameData.player.get();
     }
@@ -148,12 +150,12 @@ void CollisionManager::TankCollisionLogic(const CollisionEvent* collisionEvent)
 
     if (meshA == MeshID::TANK && meshB == MeshID::TANK)
     {
-        SoundEngine::PlaySoundEffect(SoundEngine::BANG);
+        m_sound.PlaySoundEffect(SoundSink::BANG);
     }
     else if ((meshA == MeshID::TANK && meshB == MeshID::WALL) ||
         (meshB == MeshID::TANK && meshA == MeshID::WALL))
     {
-        SoundEngine::PlaySoundEffect(SoundEngine::WALLBANG);
+        m_sound.PlaySoundEffect(SoundSink::WALLBANG);
     }
 }
 
@@ -277,6 +279,6 @@ void CollisionManager::BulletCollisionLogic(const CollisionEvent* collisionEvent
 
     if (bulletDestroyed)
     {
-        SoundEngine::PlaySoundEffect(SoundEngine::EXPLODE);
+        m_sound.PlaySoundEffect(SoundSink::EXPLODE);
     }
 }
\ No newline at end of file
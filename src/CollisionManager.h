@@ -11,6 +11,7 @@
 
 class Tank;
 class PhysicsEngine;
+class SoundSink;
 struct SceneData;
 struct GameData;
 
@@ -26,10 +27,12 @@ public:
     * @param physics The physics world to update from
     * @param gameData Objects from the game to update
     * @param sceneData Meshes from the scene to update
+    * @param sound Plays sounds for the game
     */
     CollisionManager(PhysicsEngine& physics,
                      GameData& gameData,
-                     SceneData& sceneData);
+                     SceneData& sceneData,
+                     SoundSink& sound);
 
     /**
     * Destructor
@@ -94,6 +97,7 @@ private:
     PhysicsEngine& m_physics;             ///< The physics world to update from
     GameData& m_gameData;                 ///< Objects from the game to update
     SceneData& m_sceneData;               ///< Meshes from the scene to update
+    SoundSink& m_sound;                   ///< Plays sounds for the game
     std::vector<CollisionEvent> m_events; ///< List of currently occuring collision events
     int m_collisionGroupIndex = 0;        ///< Current index for collision groups
 };
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - CommandLine.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CommandLine.h"
+
+#include <limits>
+#include <stdexcept>
+
+bool ReadInt(const std::string& value, int& number)
+{
+    try
+    {
+        std::size_t used = 0;
+        const int result = std::stoi(value, &used);
+        if (used != value.size())
+        {
+            return false;
+        }
+        number = result;
+        return true;
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+}
+
+bool ReadUnsigned(const std::string& value, unsigned int& number)
+{
+    try
+    {
+        // Conversion accepts a sign and wraps negative values
+        std::size_t used = 0;
+        const unsigned long result = std::stoul(value, &used);
+        if (used != value.size() || value.front() == '-' || 
+            result > std::numeric_limits<unsigned int>::max())
+        {
+            return false;
+        }
+        number = static_cast<unsigned int>(result);
+        return true;
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+}
+
+bool ReadFloat(const std::string& value, float& number)
+{
+    try
+    {
+        std::size_t used = 0;
+        const float result = std::stof(value, &used);
+        if (used != value.size())
+        {
+            return false;
+        }
+        number = result;
+        return true;
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+}
\ No newline at end of file
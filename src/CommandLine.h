@@ -0,0 +1,31 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - CommandLine.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+
+/**
+* Converts a command line value which must be entirely an integer
+* @param value The text of the value
+* @param number Set to the converted value if valid
+* @return whether the value was valid
+*/
+bool ReadInt(const std::string& value, int& number);
+
+/**
+* Converts a command line value which must be entirely an unsigned integer
+* @param value The text of the value
+* @param number Set to the converted value if valid
+* @return whether the value was valid
+*/
+bool ReadUnsigned(const std::string& value, unsigned int& number);
+
+/**
+* Converts a command line value which must be entirely a float
+* @param value The text of the value
+* @param number Set to the converted value if valid
+* @return whether the value was valid
+*/
+bool ReadFloat(const std::string& value, float& number);
\ No newline at end of file
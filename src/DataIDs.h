@@ -26,6 +26,19 @@ namespace MeshID
     };
 }
 
+/**
+* Lower detail meshes used to cast shadows
+*/
+namespace ShadowID
+{
+    enum ID
+    {
+        TANK,
+        GUN,
+        MAX
+    };
+}
+
 /**
 * Avaliable effects in the game
 */
@@ -70,8 +83,15 @@ namespace ShaderID
         PROXY,
         SHADOW,
         TEXTURE,
-        POST,
+        POST,            ///< Post shaders follow the order of PostProcessing::Map
+        POST_SCENE,
+        POST_NORMAL,
+        POST_TOONLINE,
+        TOONLINE,
+        FXAA,
         GRADIENT,
+        TOON_INDIRECT,
+        SHADOW_INSTANCED,
         MAX
     };
 }
@@ -10,8 +10,9 @@ const float DISTANCE_TO_MOVE_FORWARD = 10.0f;
 const float MAX_DISTANCE_TO_SHOOT = 20.0f;
 const float MIN_DISTANCE_TO_SHOOT = 5.0f;
 
-Enemy::Enemy(MeshGroup& tankmesh, int instance)
+Enemy::Enemy(MeshGroup& tankmesh, int instance, unsigned int seed)
     : Tank(tankmesh, instance)
+    , m_generator(seed)
 {  
 }
 
@@ -40,12 +41,18 @@ void Enemy::Update(float deltatime)
     }
 }
 
+int Enemy::GenerateRandom(int max)
+{
+    std::uniform_int_distribution<int> distribution(0, max - 1);
+    return distribution(m_generator);
+}
+
 void Enemy::CreateAIMovement()
 {
-    const int direction = rand() % 6;
-    const int rotation = rand() % 8;
-    const int gunrotation = rand() % 8;
-    const int shoot = rand() % 10;
+    const int direction = GenerateRandom(6);
+    const int rotation = GenerateRandom(8);
+    const int gunrotation = GenerateRandom(8);
+    const int shoot = GenerateRandom(10);
 
     if (shoot == 0)
     {
@@ -8,6 +8,8 @@
 
 #include "glm/matrix.hpp"
 
+#include <random>
+
 /**
 * Enemy AI controlled tank
 */
@@ -19,8 +21,9 @@ public:
     * Constructor
     * @param mesh Tankmesh Holds each piece of the tank
     * @param instance Which instance this tank is to access the mesh parts
+    * @param seed The seed for the AI decisions
     */
-    Enemy(MeshGroup& tankmesh, int instance);
+    Enemy(MeshGroup& tankmesh, int instance, unsigned int seed);
 
     /**
     * Adds data for this element to be tweaked by the gui
@@ -46,7 +49,14 @@ private:
     */
     void CreateAIMovement();
 
+    /**
+    * @return a random int between 0 and max-1
+    * @note each enemy owns its generator so enemies can update in parallel
+    */
+    int GenerateRandom(int max);
+
 private:
 
-    float m_aiTimePassed = 0.0f; ///< Time passed to generate next ai mov
+    float m_aiTimePassed = 0.0f;              ///< Time passed to generate next ai mov
+    std::default_random_engine m_generator;   ///< Generator for the AI decisions
 };
\ No newline at end of file
@@ -11,10 +11,18 @@
 #include "SceneData.h"
 #include "Tweaker.h"
 #include "Camera.h"
+#include "RandomGenerator.h"
 
-Game::Game(Camera& camera, PhysicsEngine& physicsEngine)
+#include <algorithm>
+
+Game::Game(Camera& camera, 
+           PhysicsEngine& physicsEngine, 
+           SoundSink& sound, 
+           unsigned int seed)
     : m_camera(camera)
     , m_physicsEngine(physicsEngine)
+    , m_sound(sound)
+    , m_random(std::make_unique<Random>(seed))
     , m_data(std::make_unique<GameData>())
     , m_builder(std::make_unique<GameBuilder>())
 {
@@ -22,49 +30,89 @@ Game::Game(Camera& camera, PhysicsEngine& physicsEngine)
 
 Game::~Game() = default;
 
-void Game::PrePhysicsTick(float deltaTime, float physicsDeltaTime)
+JobSystem::JobID Game::AddPrePhysicsJobs(JobSystem& jobs,
+                                         float deltaTime, 
+                                         float physicsDeltaTime,
+                                         const JobSystem::Dependencies& dependencies)
 {
-    m_data->player->Update(deltaTime);
-    for (auto& enemy : m_data->enemies)
+    const int grain = 1;
+    const int enemies = static_cast<int>(m_data->enemies.size());
+
+    // Each tank only modifies its own state so can be updated in parallel
+    const auto tanks = jobs.AddParallelFor("Tank Update", enemies + 1, grain, 
+        [this, enemies, deltaTime](int index)
+        {
+            if (index < enemies)
+            {
+                m_data->enemies[index]->Update(deltaTime);
+            }
+            else
+            {
+                m_data->player->Update(deltaTime);
+            }
+        }, dependencies);
+
+    // Managers modify the physics world which must be done serially
+    const auto tankManager = jobs.Add("Tank Manager", [this, physicsDeltaTime]()
     {
-        enemy->Update(deltaTime);
-    } 
-
-    m_tankManager->PrePhysicsTick(physicsDeltaTime);
-    m_bulletManager->PrePhysicsTick();
+        m_tankManager->PrePhysicsTick(physicsDeltaTime);
+    }, { tanks });
 
-    // Fix the camera to the player
-    if (!m_camera.IsFlyCamera())
+    const auto bulletManager = jobs.Add("Bullet Manager", [this]()
     {
-        const float cameraOffset = 20.0f;
-        const glm::vec3 tankPosition = m_data->player->GetPosition();
-        const glm::vec3 cameraPosition(
-            tankPosition.x - cameraOffset,
-            tankPosition.y + cameraOffset,
-            tankPosition.z - cameraOffset);
-
-        m_camera.SetPosition(cameraPosition);
-        m_camera.SetTarget(tankPosition);
-    }
-
-    // Reset movement requests
-    m_data->player->ResetMovementRequest();
-    for (auto& enemy : m_data->enemies)
+        m_bulletManager->PrePhysicsTick();
+    }, { tankManager });
+
+    return jobs.Add("Game Camera", [this]()
     {
-        enemy->ResetMovementRequest();
-    } 
+        // Fix the camera to the player
+        if (!m_camera.IsFlyCamera())
+        {
+            const float cameraOffset = 20.0f;
+            const glm::vec3 tankPosition = m_data->player->GetPosition();
+            const glm::vec3 cameraPosition(
+                tankPosition.x - cameraOffset,
+                tankPosition.y + cameraOffset,
+                tankPosition.z - cameraOffset);
+
+            m_camera.SetPosition(cameraPosition);
+            m_camera.SetTarget(tankPosition);
+        }
+
+        // Reset movement requests
+        m_data->player->ResetMovementRequest();
+        for (auto& enemy : m_data->enemies)
+        {
+            enemy->ResetMovementRequest();
+        } 
+    }, { bulletManager });
 }
 
-void Game::PostPhysicsTick(float deltaTime)
+JobSystem::JobID Game::AddPostPhysicsJobs(JobSystem& jobs,
+                                          float deltaTime,
+                                          const JobSystem::Dependencies& dependencies)
 {
-    m_tankManager->PostPhysicsTick();
-    m_bulletManager->PostPhysicsTick();
+    const int grain = 1;
 
-    m_collisionManager->CollisionDetection();
-    m_collisionManager->CollisionResolution();
+    const auto physicsExport = jobs.Add("Physics Export", [this]()
+    {
+        m_tankManager->PostPhysicsTick();
+        m_bulletManager->PostPhysicsTick();
+    }, dependencies);
+
+    const auto collision = jobs.Add("Collision", [this]()
+    {
+        m_collisionManager->CollisionDetection();
+        m_collisionManager->CollisionResolution();
+    }, { physicsExport });
 
     // Do after collision resolution as it will enable/disable instances
-    m_data->toonText->Tick(m_camera, deltaTime);
+    auto& toonText = *m_data->toonText;
+    return jobs.AddParallelFor("Toon Text", toonText.Instances(), grain,
+        [this, &toonText, deltaTime](int index)
+        {
+            toonText.Tick(m_camera, deltaTime, index);
+        }, { collision });
 }
 
 bool Game::Initialise(SceneData& data)
@@ -73,17 +121,18 @@ bool Game::Initialise(SceneData& data)
         m_physicsEngine, *m_data, data);
 
     m_bulletManager = std::make_unique<BulletManager>(
-        m_physicsEngine, *m_data, data);
+        m_physicsEngine, *m_data, data, m_sound);
 
     m_collisionManager = std::make_unique<CollisionManager>(
-        m_physicsEngine, *m_data, data);
+        m_physicsEngine, *m_data, data, m_sound);
 
     return Reset(data);
 }
 
 bool Game::Reset(SceneData& data)
 {
-    return m_builder->Initialise(*m_data, data, m_physicsEngine, *m_collisionManager);
+    return m_builder->Initialise(*m_data, data, 
+        m_physicsEngine, *m_collisionManager, *m_random);
 }
 
 void Game::AddToTweaker(Tweaker& tweaker, std::function<void(void)> reset)
@@ -117,4 +166,15 @@ void Game::RotatePlayerGun(bool left)
 void Game::MovePlayer(bool forwards)
 {
     m_data->player->Move(forwards);
+}
+
+bool Game::IsPlayerAlive() const
+{
+    return m_data->player->IsAlive();
+}
+
+int Game::GetEnemiesAlive() const
+{
+    return static_cast<int>(std::count_if(m_data->enemies.begin(), m_data->enemies.end(),
+        [](const std::unique_ptr<Enemy>& enemy) { return enemy->IsAlive(); }));
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Postprocessing.h"
+#include "JobSystem.h"
 
 #include "glm/glm.hpp"
 
@@ -20,6 +21,8 @@ class GameBuilder;
 class PhysicsEngine;
 class Tweaker;
 class Camera;
+class SoundSink;
+class Random;
 struct SceneData;
 struct GameData;
 
@@ -34,8 +37,13 @@ public:
     * Constructor
     * @param camera The main view camera
     * @param physicsEngine Controls the game physics
+    * @param sound Plays sounds for the game
+    * @param seed The seed for all random values in the game
     */
-    Game(Camera& camera, PhysicsEngine& physicsEngine);
+    Game(Camera& camera, 
+         PhysicsEngine& physicsEngine, 
+         SoundSink& sound, 
+         unsigned int seed);
 
     /**
     * Destructor
@@ -43,14 +51,28 @@ public:
     ~Game();
 
     /**
-    * Ticks the game before the physics engine has updated
+    * Adds the jobs to tick the game before the physics engine has updated
+    * @param jobs The job system to add to
+    * @param deltaTime The time passed since last frame
+    * @param physicsDeltaTime The time passed scaled for the physics engine
+    * @param dependencies Jobs which must complete before ticking
+    * @return the ID of the final job
     */
-    void PrePhysicsTick(float deltaTime, float physicsDeltaTime);
+    JobSystem::JobID AddPrePhysicsJobs(JobSystem& jobs,
+                                       float deltaTime, 
+                                       float physicsDeltaTime,
+                                       const JobSystem::Dependencies& dependencies);
 
     /**
-    * Ticks the game once the physics engine has updated
+    * Adds the jobs to tick the game once the physics engine has updated
+    * @param jobs The job system to add to
+    * @param deltaTime The time passed since last frame
+    * @param dependencies Jobs which must complete before ticking
+    * @return the ID of the final job
     */
-    void PostPhysicsTick(float deltaTime);
+    JobSystem::JobID AddPostPhysicsJobs(JobSystem& jobs,
+                                        float deltaTime,
+                                        const JobSystem::Dependencies& dependencies);
 
     /**
     * Initialises the game
@@ -98,6 +120,16 @@ public:
     */
     void MovePlayer(bool forwards);
 
+    /**
+    * @return whether the player is still alive
+    */
+    bool IsPlayerAlive() const;
+
+    /**
+    * @return the number of enemies still alive
+    */
+    int GetEnemiesAlive() const;
+
 private:
 
     /**
@@ -110,6 +142,8 @@ private:
 
     Camera& m_camera;                                      ///< Main camera
     PhysicsEngine& m_physicsEngine;                        ///< Controls the game physics
+    SoundSink& m_sound;                                    ///< Plays sounds for the game
+    std::unique_ptr<Random> m_random;                      ///< Generator for random values in the game
     std::unique_ptr<GameBuilder> m_builder;                ///< Constructs the game
     std::unique_ptr<CollisionManager> m_collisionManager;  ///< Managers detection and resolve of collisions
     std::unique_ptr<TankManager> m_tankManager;            ///< Controls the movement of the tanks
@@ -5,8 +5,14 @@
 #include "GameBuilder.h"
 #include "GameData.h"
 #include "SceneData.h"
+#include "StaticBatch.h"
 #include "PhysicsEngine.h"
 #include "CollisionManager.h"
+#include "RandomGenerator.h"
+
+#include <climits>
+#include <cmath>
+#include <algorithm>
 
 GameBuilder::GameBuilder() = default;
 GameBuilder::~GameBuilder() = default;
@@ -14,12 +20,13 @@ GameBuilder::~GameBuilder() = default;
 bool GameBuilder::Initialise(GameData& gamedata,
                              SceneData& scenedata, 
                              PhysicsEngine& physics,
-                             CollisionManager& collisionManager)
+                             CollisionManager& collisionManager,
+                             Random& random)
 {
     physics.ResetSimulation();
 
     return InitialiseWorld(gamedata, scenedata, physics, collisionManager) &&
-        InitialiseTanks(gamedata, scenedata, physics, collisionManager) &&
+        InitialiseTanks(gamedata, scenedata, physics, collisionManager, random) &&
         InitialiseBullets(gamedata, scenedata, physics, collisionManager);
 }
 
@@ -56,6 +63,15 @@ bool GameBuilder::InitialiseWorld(GameData& gamedata,
 
     ground.UpdateTransforms();
     wall.UpdateTransforms();
+    wallbox.UpdateTransforms();
+
+    // The arena never moves so is drawn from world space batches after the first build
+    if (scenedata.batches.empty() && !StaticBatch::Build({ &ground, &wall, &wallbox }, 
+        ground.HasBuffers(), scenedata.batches))
+    {
+        LogError("Could not batch the arena");
+        return false;
+    }
 
     const int environmentGroup = collisionManager.GetCollisionGroupIndex();
 
@@ -83,16 +99,16 @@ bool GameBuilder::InitialiseWorld(GameData& gamedata,
 bool GameBuilder::InitialiseTanks(GameData& gamedata,
                                   SceneData& scenedata, 
                                   PhysicsEngine& physics,
-                                  CollisionManager& collisionManager)
-
+                                  CollisionManager& collisionManager,
+                                  Random& random)
 {
     const int enemyHealth = 2;
     const int enemyDamage = 2;
-    const int enemyAmount = 5;
     const int playerHealth = 6;
     const int playerDamage = 2;
     const glm::vec3 spawnPosition(0, 0, 0);
-    const float spawnSize = 10.0f;
+    const float maxSpawnSize = 10.0f;
+    const float maxSpawnArea = 40.0f;
     const float tankMass = 500.0f;
     const float tankPartMass = tankMass / 3.0f;
     const float gunMass = 20.0f;
@@ -104,17 +120,22 @@ bool GameBuilder::InitialiseTanks(GameData& gamedata,
     auto& tankp4 = *scenedata.meshes[MeshID::TANKP4];
     auto& tankGun = *scenedata.meshes[MeshID::TANKGUN];
 
+    // Player is always the last instance of the tank meshes
+    const int tanks = tankBody.Instances();
+    const int playerInstance = tanks - 1;
+
     if (!gamedata.tankMesh)
     {
         gamedata.tankMesh = std::make_unique<Tank::MeshGroup>(
             tankBody, tankGun, tankp1, tankp2, tankp3, tankp4);
 
-        for (int i = 0; i < Instance::ENEMIES; ++i)
+        for (int i = 0; i < playerInstance; ++i)
         {
             gamedata.enemies.push_back(
-                std::make_unique<Enemy>(*gamedata.tankMesh, i));
+                std::make_unique<Enemy>(*gamedata.tankMesh, i, 
+                    static_cast<unsigned int>(random.Generate(0, INT_MAX))));
         }
-        gamedata.player = std::make_unique<Player>(*gamedata.tankMesh, Instance::PLAYER);
+        gamedata.player = std::make_unique<Player>(*gamedata.tankMesh, playerInstance);
     }
     else
     {
@@ -125,12 +146,16 @@ bool GameBuilder::InitialiseTanks(GameData& gamedata,
         }
     }
 
-    int index = Instance::PLAYER;
-    const int spawnRows = 2;
-    const int spawnColumns = 3;
+    // Grid is widened and tightened for larger tank counts to stay within the walls
+    const int spawnColumns = std::max(3, static_cast<int>(std::ceil(std::sqrt(tanks))));
+    const int spawnRows = (tanks + spawnColumns - 1) / spawnColumns;
+    const float spawnSize = std::min(maxSpawnSize, 
+        maxSpawnArea / std::max(spawnRows, spawnColumns));
+
+    int index = playerInstance;
     for(int r = 0; r < spawnRows; r++)
     {
-        for(int c = 0; c < spawnColumns; c++)
+        for(int c = 0; c < spawnColumns && index >= 0; c++)
         {
             const float x = spawnPosition.x + (r * spawnSize);
             const float y = 0.0f;
@@ -228,11 +253,11 @@ bool GameBuilder::InitialiseTanks(GameData& gamedata,
         return IDs;
     };
 
-    for (int i = 0; i < Instance::ENEMIES; ++i)
+    for (int i = 0; i < playerInstance; ++i)
     {
         gamedata.enemies[i]->SetPhysicsIDs(CreateTankPhysics(i));
     }
-    gamedata.player->SetPhysicsIDs(CreateTankPhysics(Instance::PLAYER));
+    gamedata.player->SetPhysicsIDs(CreateTankPhysics(playerInstance));
 
     return true;
 }
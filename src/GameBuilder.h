@@ -8,6 +8,7 @@
 
 class PhysicsEngine;
 class CollisionManager;
+class Random;
 struct SceneData;
 struct GameData;
 
@@ -27,12 +28,14 @@ public:
     * @param gamedata All information for the game
     * @param physics The physics engine
     * @param collisionManager Manages interaction between physics bodies
+    * @param random The generator for the game
     * @return Whether the initialization was successful
     */
     bool Initialise(GameData& gamedata, 
                     SceneData& scenedata, 
                     PhysicsEngine& physics,
-                    CollisionManager& collisionManager);
+                    CollisionManager& collisionManager,
+                    Random& random);
 
 private:
 
@@ -61,12 +64,14 @@ private:
     * @param gamedata All information for the game
     * @param physics The physics world
     * @param collisionManager Manages interaction between physics bodies
+    * @param random The generator for the game
     * @return Whether the initialization was successful
     */
     bool InitialiseTanks(GameData& gamedata,
                          SceneData& scenedata, 
                          PhysicsEngine& physics,
-                         CollisionManager& collisionManager);
+                         CollisionManager& collisionManager,
+                         Random& random);
 
     /**
     * Initialises the tank bullets
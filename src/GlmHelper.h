@@ -87,4 +87,14 @@ namespace glm
         matrix[0][1] = vec.y;
         matrix[0][2] = vec.z;
     }
+
+    /**
+    * Creates a matrix that flattens points onto a plane away from a light
+    * @param plane The plane as a normal and distance from the origin
+    * @param light The light position, or direction towards it if w is zero
+    */
+    inline glm::mat4 matrix_planar_projection(const glm::vec4& plane, const glm::vec4& light)
+    {
+        return glm::dot(plane, light) * glm::mat4(1.0f) - glm::outerProduct(light, plane);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - GpuTimer.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GpuTimer.h"
+
+GpuTimer::~GpuTimer()
+{
+    if (m_queries[0] != 0)
+    {
+        glDeleteQueries(QUERIES, m_queries.data());
+    }
+}
+
+bool GpuTimer::Initialise()
+{
+    glGenQueries(QUERIES, m_queries.data());
+
+    if (HasCallFailed())
+    {
+        LogError("GpuTimer: Failed to create queries");
+        return false;
+    }
+    return true;
+}
+
+void GpuTimer::Begin()
+{
+    // The query was last used several frames ago so has usually finished
+    const GLuint query = m_queries[m_current];
+    if (m_pending[m_current])
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            m_milliseconds = static_cast<float>(nanoseconds / 1000000.0);
+        }
+        m_pending[m_current] = false;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+}
+
+void GpuTimer::End()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_current] = true;
+    m_current = (m_current + 1) % QUERIES;
+}
+
+float GpuTimer::Milliseconds() const
+{
+    return m_milliseconds;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - GpuTimer.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OpenGL.h"
+
+#include <array>
+
+/**
+* Measures the GPU time taken by a section of a frame
+* Results are read frames later once available so the CPU never waits
+*/
+class GpuTimer
+{
+public:
+
+    /**
+    * Constructor
+    */
+    GpuTimer() = default;
+
+    /**
+    * Destructor
+    */
+    ~GpuTimer();
+
+    /**
+    * Creates the queries used for timing
+    * @return whether initialisation was successful
+    */
+    bool Initialise();
+
+    /**
+    * Starts timing the commands that follow
+    * @note timers can't be nested
+    */
+    void Begin();
+
+    /**
+    * Stops timing the commands since Begin
+    */
+    void End();
+
+    /**
+    * @return the last available time in milliseconds
+    */
+    float Milliseconds() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    static const int QUERIES = 3;  ///< Number of frames that can be in flight
+
+private:
+
+    std::array<GLuint, QUERIES> m_queries = {};     ///< Time elapsed query for each frame
+    std::array<bool, QUERIES> m_pending = {};       ///< Whether each query has an unread result
+    int m_current = 0;                              ///< Query used for the current frame
+    float m_milliseconds = 0.0f;                    ///< Last available time
+};
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "Input.h"
 #include "Camera.h"
 #include "Timer.h"
+#include "JobSystem.h"
+#include "OpenGLEngine.h"
 #include "Game.h"
 #include "Scene.h"
 #include "Utils.h"
@@ -18,11 +20,15 @@ Gui::Gui(Scene& scene,
          Game& game,
          Camera& camera,
          Input& input,
-         Timer& timer)
+         Timer& timer,
+         JobSystem& jobs,
+         OpenGLEngine& engine)
     : m_game(game)
     , m_camera(camera)
     , m_scene(scene)
     , m_timer(timer)
+    , m_jobs(jobs)
+    , m_engine(engine)
 {
     TwInit(TW_OPENGL_CORE, nullptr);
     TwWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
@@ -87,13 +93,34 @@ Gui::~Gui()
 void Gui::Toggle()
 {
     m_show = !m_show;
+
+    // Job timings are only known once they have run
+    if (m_show)
+    {
+        FillTweakBar();
+    }
+}
+
+bool Gui::IsShown() const
+{
+    return m_show;
 }
 
 void Gui::Render()
 {
     if (m_show)
     {
+        if (m_width != m_engine.WindowWidth() || m_height != m_engine.WindowHeight())
+        {
+            m_width = m_engine.WindowWidth();
+            m_height = m_engine.WindowHeight();
+            TwWindowSize(m_width, m_height);
+        }
+
         TwDraw();
+
+        // The tweak bar binds its own textures behind the cache
+        ResetTextureBindings();
     }
 }
 
@@ -126,4 +153,6 @@ void Gui::FillTweakBar()
     m_game.AddToTweaker(*m_tweaker, [this](){ FillTweakBar(); });
     m_camera.AddToTweaker(*m_tweaker);
     m_timer.AddToTweaker(*m_tweaker);
+    m_jobs.AddToTweaker(*m_tweaker);
+    m_engine.AddToTweaker(*m_tweaker);
 }
\ No newline at end of file
@@ -6,11 +6,14 @@
 
 #include <memory>
 #include <functional>
+#include <atomic>
 
 struct CTwBar;
 class Input;
 class Tweaker;
 class Timer;
+class OpenGLEngine;
+class JobSystem;
 class Camera;
 class Scene;
 class Game;
@@ -29,12 +32,16 @@ public:
     * @param camera Allows modifying the camera
     * @param input Allows adding key callbacks
     * @param timer Allows viewing the application times
+    * @param jobs Allows viewing the job timings
+    * @param engine Allows viewing the render diagnostics
     */
     Gui(Scene& scene,
         Game& game,
         Camera& camera, 
         Input& input,
-        Timer& timer);
+        Timer& timer,
+        JobSystem& jobs,
+        OpenGLEngine& engine);
 
     /**
     * Destructor
@@ -56,6 +63,12 @@ public:
     */
     void Toggle();
 
+    /**
+    * @return whether the tweak bar is shown
+    * @note can be called without holding the simulation lock
+    */
+    bool IsShown() const;
+
 private:
 
     /**
@@ -75,7 +88,11 @@ private:
     Scene& m_scene;                        ///< Holds and manages scene data
     Camera& m_camera;                      ///< Allows modifying the view
     Timer& m_timer;                        ///< Allows viewing the application times
+    JobSystem& m_jobs;                     ///< Allows viewing the job timings
+    OpenGLEngine& m_engine;                ///< Allows viewing the render diagnostics
     CTwBar* m_tweakbar = nullptr;          ///< Tweak bar for manipulating the scene
-    bool m_show = false;                   ///< Whether the GUI is displayed
+    std::atomic<bool> m_show{ false };     ///< Whether the GUI is displayed, read by the render thread
+    int m_width = 0;                       ///< Window width the tweak bar is laid out for
+    int m_height = 0;                      ///< Window height the tweak bar is laid out for
     std::unique_ptr<Tweaker> m_tweaker;    ///< Helper for modifying the tweak bar
 };                     
\ No newline at end of file
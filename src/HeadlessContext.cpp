@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - HeadlessContext.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessContext.h"
+#include "Logger.h"
+
+#ifdef HEADLESS_EGL
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+    const EGLint CONTEXT_MAJOR_VERSION = 4;  ///< Matches the functions loaded by the engine
+    const EGLint CONTEXT_MINOR_VERSION = 4;
+
+    /**
+    * @return the display to create the context on, preferring one without any surface
+    */
+    EGLDisplay GetDisplay()
+    {
+        const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+        if (extensions && getPlatformDisplay &&
+            std::strstr(extensions, "EGL_MESA_platform_surfaceless"))
+        {
+            EGLDisplay display = getPlatformDisplay(
+                EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+            if (display != EGL_NO_DISPLAY)
+            {
+                return display;
+            }
+        }
+
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (m_display)
+    {
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_context)
+        {
+            eglDestroyContext(m_display, m_context);
+            m_context = nullptr;
+        }
+        eglTerminate(m_display);
+        m_display = nullptr;
+    }
+}
+
+bool HeadlessContext::IsSupported()
+{
+    return true;
+}
+
+bool HeadlessContext::Initialise()
+{
+    EGLDisplay display = GetDisplay();
+    EGLint major = 0, minor = 0;
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        LogError("Headless: Could not initialise EGL display");
+        return false;
+    }
+
+    m_display = display;
+
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions || !std::strstr(extensions, "EGL_KHR_surfaceless_context"))
+    {
+        LogError("Headless: EGL display does not support surfaceless contexts");
+        return false;
+    }
+
+    // Configs default to needing window surfaces which a surfaceless display doesn't have
+    const EGLint configAttributes[] =
+    {
+        EGL_SURFACE_TYPE, 0,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglBindAPI(EGL_OPENGL_API) ||
+        !eglChooseConfig(display, configAttributes, &config, 1, &configCount) ||
+        configCount == 0)
+    {
+        LogError("Headless: No EGL config supports desktop OpenGL");
+        return false;
+    }
+
+    const EGLint contextAttributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, CONTEXT_MAJOR_VERSION,
+        EGL_CONTEXT_MINOR_VERSION, CONTEXT_MINOR_VERSION,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    m_context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (m_context == EGL_NO_CONTEXT)
+    {
+        m_context = nullptr;
+        LogError("Headless: Could not create OpenGL " + std::to_string(CONTEXT_MAJOR_VERSION) +
+            "." + std::to_string(CONTEXT_MINOR_VERSION) + " context");
+        return false;
+    }
+
+    // Without a surface there is no default framebuffer, only render targets
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+    {
+        LogError("Headless: Could not make context current");
+        return false;
+    }
+
+    LogInfo("Headless: Created surfaceless context on " +
+        std::string(eglQueryString(display, EGL_VENDOR)) + " EGL " +
+        std::to_string(major) + "." + std::to_string(minor));
+    return true;
+}
+
+bool HeadlessContext::MakeCurrent(bool current)
+{
+    return m_context && eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+        current ? m_context : EGL_NO_CONTEXT);
+}
+
+#else
+
+HeadlessContext::~HeadlessContext()
+{
+}
+
+bool HeadlessContext::IsSupported()
+{
+    return false;
+}
+
+bool HeadlessContext::Initialise()
+{
+    LogError("Headless: Built without HEADLESS_EGL");
+    return false;
+}
+
+bool HeadlessContext::MakeCurrent(bool)
+{
+    return false;
+}
+
+#endif
\ No newline at end of file
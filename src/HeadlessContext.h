@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - HeadlessContext.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/**
+* OpenGL context without a window or display for rendering on servers
+* Created through EGL with no surface, so a software driver such as llvmpipe
+* can render when there is no GPU and all drawing goes into render targets
+* @note only available in builds with HEADLESS_EGL defined
+*/
+class HeadlessContext
+{
+public:
+
+    /**
+    * Constructor
+    */
+    HeadlessContext() = default;
+
+    /**
+    * Destructor
+    */
+    ~HeadlessContext();
+
+    /**
+    * @return whether the build can create headless contexts
+    */
+    static bool IsSupported();
+
+    /**
+    * Creates the context and makes it current on the calling thread
+    * @return whether initialisation was successful
+    */
+    bool Initialise();
+
+    /**
+    * Moves the context to or from the calling thread
+    * @param current Whether to make the context current or release it
+    * @return whether the context was changed
+    */
+    bool MakeCurrent(bool current);
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+private:
+
+    void* m_display = nullptr;   ///< EGL display the context was created for
+    void* m_context = nullptr;   ///< EGL context made current
+};
\ No newline at end of file
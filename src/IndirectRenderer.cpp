@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - IndirectRenderer.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IndirectRenderer.h"
+#include "Mesh.h"
+#include "StreamBuffer.h"
+#include "RenderCommandList.h"
+
+#include <tuple>
+#include <numeric>
+#include <algorithm>
+
+namespace
+{
+    const unsigned int MIN_INSTANCES = 256;  ///< Instance indices initially allocated
+}
+
+IndirectRenderer::~IndirectRenderer()
+{
+    if (m_vaoID != 0)
+    {
+        glDeleteVertexArrays(1, &m_vaoID);
+        glDeleteBuffers(1, &m_vboID);
+        glDeleteBuffers(1, &m_iboID);
+        glDeleteBuffers(1, &m_instanceIndexID);
+    }
+}
+
+bool IndirectRenderer::IsSupported()
+{
+    const int version = ogl_GetMajorVersion() * 10 + ogl_GetMinorVersion();
+    return version >= 43 && glMultiDrawElementsIndirect != nullptr;
+}
+
+bool IndirectRenderer::Initialise(const std::vector<const Mesh*>& meshes)
+{
+    if (meshes.empty())
+    {
+        return false;
+    }
+
+    // All meshes share one vertex layout so must have the same components
+    const int componentCount = meshes[0]->VertexComponentCount();
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+
+    for (const Mesh* mesh : meshes)
+    {
+        if (mesh->VertexComponentCount() != componentCount)
+        {
+            LogInfo("Indirect: " + mesh->Name() + " vertices don't match");
+            continue;
+        }
+
+        MeshRange range;
+        range.baseVertex = static_cast<GLint>(vertices.size()) / componentCount;
+        range.firstIndex = static_cast<GLuint>(indices.size());
+        m_ranges[mesh] = range;
+
+        vertices.insert(vertices.end(), mesh->Vertices().begin(), mesh->Vertices().end());
+        indices.insert(indices.end(), mesh->Indices().begin(), mesh->Indices().end());
+    }
+
+    glGenVertexArrays(1, &m_vaoID);
+    glGenBuffers(1, &m_vboID);
+    glGenBuffers(1, &m_iboID);
+    glGenBuffers(1, &m_instanceIndexID);
+
+    glBindVertexArray(m_vaoID);
+
+    std::vector<char> buffer;
+    m_format.Initialise(vertices, componentCount);
+
+    m_format.PackVertices(vertices, buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
+    glBufferData(GL_ARRAY_BUFFER, buffer.size(), buffer.data(), GL_STATIC_DRAW);
+    m_format.EnableAttributes(~0u);
+
+    m_format.PackIndices(indices, buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iboID);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, buffer.size(), buffer.data(), GL_STATIC_DRAW);
+
+    // Base instance offsets this attribute, giving each instance its data index
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceIndexID);
+    glEnableVertexAttribArray(VertexFormat::INSTANCE);
+    glVertexAttribIPointer(VertexFormat::INSTANCE, 1, GL_UNSIGNED_INT, 0, nullptr);
+    glVertexAttribDivisor(VertexFormat::INSTANCE, 1);
+    ReserveInstances(MIN_INSTANCES);
+
+    glBindVertexArray(0);
+
+    if (HasCallFailed())
+    {
+        LogError("Indirect: Failed to create shared buffers");
+        return false;
+    }
+
+    LogInfo("Indirect: Shared buffers hold " + std::to_string(m_ranges.size()) +
+        " meshes, " + std::to_string(vertices.size() / componentCount) + " vertices");
+    return true;
+}
+
+void IndirectRenderer::ReserveInstances(unsigned int instances)
+{
+    if (instances <= m_instanceCapacity)
+    {
+        return;
+    }
+
+    m_instanceCapacity = std::max(MIN_INSTANCES, m_instanceCapacity);
+    while (m_instanceCapacity < instances)
+    {
+        m_instanceCapacity *= 2;
+    }
+
+    std::vector<GLuint> indices(m_instanceCapacity);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceIndexID);
+    glBufferData(GL_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+}
+
+bool IndirectRenderer::Contains(const Mesh& mesh) const
+{
+    return m_ranges.find(&mesh) != m_ranges.end();
+}
+
+void IndirectRenderer::Add(const Mesh& mesh, int level, int texture, int layer, const glm::mat4& world)
+{
+    m_layered |= layer >= 0;
+
+    Draw draw;
+    draw.texture = texture;
+    draw.layer = layer;
+    draw.backfaceCull = mesh.BackfaceCull();
+    draw.mesh = &mesh;
+    draw.level = level;
+    draw.world = world;
+    m_draws.push_back(draw);
+}
+
+int IndirectRenderer::Record(StreamBuffer& stream, RenderCommandList& commands, PrepareGroup prepareGroup)
+{
+    if (m_draws.empty())
+    {
+        return 0;
+    }
+
+    // World matrices are written straight into the mapped storage buffer
+    const GLsizeiptr instanceBytes = m_draws.size() * sizeof(glm::mat4);
+    GLintptr instanceOffset = 0;
+    glm::mat4* instances = static_cast<glm::mat4*>(stream.Allocate(
+        instanceBytes, stream.StorageAlignment(), instanceOffset));
+
+    // Layers are only written when textures are packed into arrays
+    const GLsizeiptr layerBytes = m_layered ? m_draws.size() * sizeof(float) : 0;
+    GLintptr layerOffset = 0;
+    float* layers = m_layered ? static_cast<float*>(stream.Allocate(
+        layerBytes, stream.StorageAlignment(), layerOffset)) : nullptr;
+
+    if (!instances || (m_layered && !layers))
+    {
+        m_draws.clear();
+        m_layered = false;
+        return 0;
+    }
+
+    // Instances of the same mesh and level become a single command
+    std::sort(m_draws.begin(), m_draws.end(), [](const Draw& d1, const Draw& d2)
+    {
+        return std::tie(d1.texture, d1.backfaceCull, d1.mesh, d1.level) <
+               std::tie(d2.texture, d2.backfaceCull, d2.mesh, d2.level);
+    });
+
+    m_commands.clear();
+    m_groups.clear();
+
+    for (unsigned int i = 0; i < m_draws.size(); ++i)
+    {
+        const Draw& draw = m_draws[i];
+        const Draw* previous = i > 0 ? &m_draws[i - 1] : nullptr;
+
+        if (!previous ||
+            previous->texture != draw.texture ||
+            previous->backfaceCull != draw.backfaceCull)
+        {
+            DrawGroup group;
+            group.texture = draw.texture;
+            group.backfaceCull = draw.backfaceCull;
+            group.firstCommand = static_cast<unsigned int>(m_commands.size());
+            m_groups.push_back(group);
+        }
+
+        DrawGroup& group = m_groups.back();
+        if (group.commandCount == 0 ||
+            previous->mesh != draw.mesh ||
+            previous->level != draw.level)
+        {
+            const MeshRange& range = m_ranges.at(draw.mesh);
+
+            DrawCommand command;
+            command.count = draw.mesh->IndexCount(draw.level);
+            command.firstIndex = range.firstIndex + draw.mesh->IndexOffset(draw.level);
+            command.baseVertex = range.baseVertex;
+            command.baseInstance = i;
+            m_commands.push_back(command);
+            ++group.commandCount;
+        }
+
+        ++m_commands.back().instanceCount;
+        instances[i] = draw.world;
+
+        if (layers)
+        {
+            layers[i] = static_cast<float>(std::max(draw.layer, 0));
+        }
+    }
+
+    const int instanceCount = static_cast<int>(m_draws.size());
+    m_draws.clear();
+    m_layered = false;
+
+    GLintptr commandOffset = 0;
+    if (!stream.Write(m_commands.data(), m_commands.size() * sizeof(DrawCommand),
+        sizeof(GLuint), commandOffset))
+    {
+        return 0;
+    }
+
+    commands.BindStorageBlock(INSTANCE_BINDING, instanceOffset, instanceBytes);
+    if (layers)
+    {
+        commands.BindStorageBlock(LAYER_BINDING, layerOffset, layerBytes);
+    }
+    commands.BindIndirect(instanceCount);
+
+    for (const DrawGroup& group : m_groups)
+    {
+        prepareGroup(group.texture, group.backfaceCull);
+        commands.DrawIndirect(commandOffset + group.firstCommand * sizeof(DrawCommand),
+            group.commandCount);
+    }
+
+    return static_cast<int>(m_groups.size());
+}
+
+void IndirectRenderer::Bind(const StreamBuffer& stream, int instances)
+{
+    glBindVertexArray(m_vaoID);
+    ReserveInstances(instances);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, stream.GetID());
+}
+
+void IndirectRenderer::Submit(GLintptr offset, int commands) const
+{
+    glMultiDrawElementsIndirect(GL_TRIANGLES, m_format.IndexType(),
+        BufferOffset(offset), commands, 0);
+
+    if (HasCallFailed())
+    {
+        LogError("Indirect: Failed to submit draws");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - IndirectRenderer.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OpenGL.h"
+#include "VertexFormat.h"
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+class Mesh;
+class StreamBuffer;
+class RenderCommandList;
+
+/**
+* Renders meshes from a shared vertex and index buffer using multi-draw indirect
+* Instances are sorted so each texture is submitted with a single call, with
+* textures packed into the same array sharing a call and reading their layer
+*/
+class IndirectRenderer
+{
+public:
+
+    /**
+    * Callback to record the state for drawing a group of instances
+    * @param texture The ID of the texture used by the group
+    * @param backfaceCull Whether the group culls back facing polygons
+    */
+    typedef std::function<void(int texture, bool backfaceCull)> PrepareGroup;
+
+    /**
+    * Constructor
+    */
+    IndirectRenderer() = default;
+
+    /**
+    * Destructor
+    */
+    ~IndirectRenderer();
+
+    /**
+    * @return whether the OpenGL context supports indirect rendering
+    * @note also requires a stream buffer to write the instance data into
+    * @note requires an OpenGL context to be created
+    */
+    static bool IsSupported();
+
+    /**
+    * Copies the geometry of the meshes into the shared buffers
+    * @param meshes The meshes to draw through the renderer
+    * @return whether initialisation was successful
+    * @note meshes whose vertices don't match the first mesh are not added
+    */
+    bool Initialise(const std::vector<const Mesh*>& meshes);
+
+    /**
+    * @return whether the mesh can be drawn through the renderer
+    */
+    bool Contains(const Mesh& mesh) const;
+
+    /**
+    * Adds an instance to draw at the next render
+    * @param mesh The mesh to draw, must be contained by the renderer
+    * @param level The level of detail to draw
+    * @param texture The ID of the texture to draw with
+    * @param layer The layer of the texture array to draw with or -1 if not packed
+    * @param world The world matrix of the instance
+    */
+    void Add(const Mesh& mesh, int level, int texture, int layer, const glm::mat4& world);
+
+    /**
+    * Writes all instances added since the last record into the stream buffer
+    * and records the commands to draw them, without calling OpenGL
+    * @param stream The buffer to write the instance data and commands into
+    * @param commands The list to record into
+    * @param prepareGroup Called before each group of instances is recorded
+    * @return the number of draw calls recorded
+    */
+    int Record(StreamBuffer& stream, RenderCommandList& commands, PrepareGroup prepareGroup);
+
+    /**
+    * Binds the shared buffers for drawing
+    * @param stream The buffer the commands were written into
+    * @param instances The number of instances the commands read
+    */
+    void Bind(const StreamBuffer& stream, int instances);
+
+    /**
+    * Draws commands written into the stream buffer
+    * @param offset The offset of the first command in the stream buffer
+    * @param commands The number of commands to draw
+    */
+    void Submit(GLintptr offset, int commands) const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    IndirectRenderer(const IndirectRenderer&) = delete;
+    IndirectRenderer& operator=(const IndirectRenderer&) = delete;
+
+    /**
+    * Grows the buffer of instance indices to hold at least the given instances
+    * @param instances The number of instances required
+    */
+    void ReserveInstances(unsigned int instances);
+
+    /**
+    * Location of a mesh within the shared buffers
+    */
+    struct MeshRange
+    {
+        GLint baseVertex = 0;            ///< First vertex of the mesh
+        GLuint firstIndex = 0;           ///< First index of the mesh
+    };
+
+    /**
+    * Single instance added for rendering
+    */
+    struct Draw
+    {
+        int texture = 0;                 ///< ID of the texture to draw with
+        int layer = -1;                  ///< Layer of the texture array to draw with
+        bool backfaceCull = true;        ///< Whether back facing polygons are culled
+        const Mesh* mesh = nullptr;      ///< Mesh to draw
+        int level = 0;                   ///< Level of detail to draw
+        glm::mat4 world;                 ///< World matrix of the instance
+    };
+
+    /**
+    * Layout of a command read by glMultiDrawElementsIndirect
+    */
+    struct DrawCommand
+    {
+        GLuint count = 0;                ///< Number of indices to draw
+        GLuint instanceCount = 0;        ///< Number of instances to draw
+        GLuint firstIndex = 0;           ///< First index to draw
+        GLint baseVertex = 0;            ///< Added to each index
+        GLuint baseInstance = 0;         ///< First element of the instance data
+    };
+
+    /**
+    * Commands submitted together with a single call
+    */
+    struct DrawGroup
+    {
+        int texture = 0;                 ///< ID of the texture to draw with
+        bool backfaceCull = true;        ///< Whether back facing polygons are culled
+        unsigned int firstCommand = 0;   ///< First command in the group
+        unsigned int commandCount = 0;   ///< Number of commands in the group
+    };
+
+private:
+
+    VertexFormat m_format;                             ///< How the shared buffers are packed
+    std::unordered_map<const Mesh*, MeshRange> m_ranges; ///< Location of each mesh in the buffers
+    std::vector<Draw> m_draws;                         ///< Instances to draw at the next render
+    std::vector<DrawCommand> m_commands;               ///< Commands in the order drawn
+    std::vector<DrawGroup> m_groups;                   ///< Groups of commands in the order drawn
+    unsigned int m_instanceCapacity = 0;               ///< Number of instance indices allocated
+    bool m_layered = false;                            ///< Whether any instance draws with a layer
+    GLuint m_vaoID = 0;                                ///< Vertex array for the shared buffers
+    GLuint m_vboID = 0;                                ///< Shared vertex buffer
+    GLuint m_iboID = 0;                                ///< Shared index buffer
+    GLuint m_instanceIndexID = 0;                      ///< Index of each instance as a vertex attribute
+};
\ No newline at end of file
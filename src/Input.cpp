@@ -14,11 +14,10 @@ void Input::UpdateMouse()
 {
     m_mouseState = NO_STATE;
 
-    m_rightMousePressed = glfwGetMouseButton(
-        &m_window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+    m_rightMousePressed = m_polledRightDown;
 
-    const bool leftPressed = glfwGetMouseButton(
-        &m_window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    const bool leftPressed = m_polledLeftDown || m_polledLeftPress;
+    m_polledLeftPress = false;
 
     if (leftPressed && !m_leftMousePressed)
     {
@@ -31,11 +30,8 @@ void Input::UpdateMouse()
 
     m_leftMousePressed = leftPressed;
 
-    double xPosition = 0.0, yPosition = 0.0;
-    glfwGetCursorPos(&m_window, &xPosition, &yPosition);
-
-    const int x = static_cast<int>(xPosition);
-    const int y = static_cast<int>(yPosition);
+    const int x = m_polledMouseX;
+    const int y = m_polledMouseY;
 
     m_mouseDirection.x = static_cast<float>(m_mouseX) - x;
     m_mouseDirection.y = static_cast<float>(m_mouseY) - y;
@@ -53,12 +49,41 @@ void Input::UpdateMouse()
 }
 
 void Input::Update()
+{
+    Poll();
+    Dispatch();
+}
+
+void Input::Poll()
+{
+    m_polledRightDown = glfwGetMouseButton(
+        &m_window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+
+    m_polledLeftDown = glfwGetMouseButton(
+        &m_window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    m_polledLeftPress |= m_polledLeftDown;
+
+    double xPosition = 0.0, yPosition = 0.0;
+    glfwGetCursorPos(&m_window, &xPosition, &yPosition);
+
+    m_polledMouseX = static_cast<int>(xPosition);
+    m_polledMouseY = static_cast<int>(yPosition);
+
+    for(auto& key : m_keys)
+    {
+        key.polledDown = glfwGetKey(&m_window, key.key) == GLFW_PRESS;
+        key.polledPress |= key.polledDown;
+    }
+}
+
+void Input::Dispatch()
 {
     UpdateMouse();
 
     for(auto& key : m_keys)
     {
-        const bool pressed = glfwGetKey(&m_window, key.key) == GLFW_PRESS;
+        const bool pressed = key.polledDown || key.polledPress;
+        key.polledPress = false;
         UpdateKey(pressed, key.state);
 
         const bool keyDown = key.continuous ? 
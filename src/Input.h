@@ -27,10 +27,22 @@ public:
     Input(GLFWwindow& window);
 
     /**
-    * Updates the input states
+    * Polls and dispatches the input states
     */
     void Update();
 
+    /**
+    * Reads the window input for the next dispatch
+    * @note must be called on the main thread
+    */
+    void Poll();
+
+    /**
+    * Updates the input states from the last poll and calls the key callbacks
+    * Keys pressed and released between dispatches are still dispatched once
+    */
+    void Dispatch();
+
     /**
     * Adds a callback for when the key is down
     * @param key The GLFW keyboard code
@@ -105,7 +117,7 @@ private:
     void UpdateKey(bool pressed, unsigned int& state);
 
     /**
-    * Updates the mouse state
+    * Updates the mouse state from the last poll
     */
     void UpdateMouse();
 
@@ -128,6 +140,8 @@ private:
         unsigned int state = 0;   ///< Current state of the key
         KeyFn onKeyFn = nullptr;  ///< Function to call if key is down
         bool continuous = false;  ///< Whether key should look at continous or not
+        bool polledDown = false;  ///< Whether the key was down at the last poll
+        bool polledPress = false; ///< Whether the key was down at any poll since dispatch
     };
 
     /**
@@ -151,4 +165,9 @@ private:
     bool m_leftMousePressed = false;      ///< Whether the mouse is currently being pressed
     bool m_rightMousePressed = false;     ///< Whether the mouse is currently being pressed
     unsigned int m_mouseState = NO_STATE; ///< State of the mouse for this tick
+    int m_polledMouseX = 0;               ///< X screen coordinate of the mouse at the last poll
+    int m_polledMouseY = 0;               ///< Y screen coordinate of the mouse at the last poll
+    bool m_polledLeftDown = false;        ///< Whether the left mouse was down at the last poll
+    bool m_polledLeftPress = false;       ///< Whether the left mouse was down at any poll since dispatch
+    bool m_polledRightDown = false;       ///< Whether the right mouse was down at the last poll
 };
\ No newline at end of file
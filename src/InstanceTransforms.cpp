@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - InstanceTransforms.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "InstanceTransforms.h"
+#include "GlmHelper.h"
+
+#include <emmintrin.h>
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    const int BLOCK_SIZE = 4;             ///< Instances updated by a single SSE block
+    const int DIRTY_BITS = InstanceTransforms::RANGE_SIZE; ///< Instances tracked by a single dirty word
+    const float DEG_TO_RAD = 0.01745329251994329577f;
+    const float TWO_OVER_PI = 0.63661977236758134308f;
+
+    // Pi/2 split into three parts for accurate range reduction
+    const float PI_OVER_TWO_A = 1.5703125f;
+    const float PI_OVER_TWO_B = 4.837512969970703125e-4f;
+    const float PI_OVER_TWO_C = 7.54978995489188216e-8f;
+
+    // Minimax coefficients for sin and cos in the range [-pi/4, pi/4]
+    const float SIN_C1 = -1.6666654611e-1f;
+    const float SIN_C2 = 8.3321608736e-3f;
+    const float SIN_C3 = -1.9515295891e-4f;
+    const float COS_C1 = 4.166664568298827e-2f;
+    const float COS_C2 = -1.388731625493765e-3f;
+    const float COS_C3 = 2.443315711809948e-5f;
+
+    /**
+    * Calculates the sine and cosine of four angles at once
+    * @param angle The angles in radians
+    * @param sin The sine of each angle
+    * @param cos The cosine of each angle
+    */
+    void SinCos(__m128 angle, __m128& sin, __m128& cos)
+    {
+        // Reduce into [-pi/4, pi/4] and find which quadrant the angle is in
+        const __m128i quadrant = _mm_cvtps_epi32(
+            _mm_mul_ps(angle, _mm_set1_ps(TWO_OVER_PI)));
+        const __m128 q = _mm_cvtepi32_ps(quadrant);
+
+        __m128 x = _mm_sub_ps(angle, _mm_mul_ps(q, _mm_set1_ps(PI_OVER_TWO_A)));
+        x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(PI_OVER_TWO_B)));
+        x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(PI_OVER_TWO_C)));
+        const __m128 x2 = _mm_mul_ps(x, x);
+
+        __m128 s = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(SIN_C3)), _mm_set1_ps(SIN_C2));
+        s = _mm_add_ps(_mm_mul_ps(x2, s), _mm_set1_ps(SIN_C1));
+        s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(x2, x), s), x);
+
+        __m128 c = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(COS_C3)), _mm_set1_ps(COS_C2));
+        c = _mm_add_ps(_mm_mul_ps(x2, c), _mm_set1_ps(COS_C1));
+        c = _mm_mul_ps(_mm_mul_ps(x2, x2), c);
+        c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(x2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+        // Odd quadrants swap sine and cosine
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+        sin = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+        cos = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+        // Shift bit 1 of the quadrant into the sign bit
+        const __m128i two = _mm_set1_epi32(2);
+        const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(
+            _mm_and_si128(quadrant, two), 30));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+            _mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+
+        sin = _mm_xor_ps(sin, sinSign);
+        cos = _mm_xor_ps(cos, cosSign);
+    }
+}
+
+void InstanceTransforms::Resize(int instances)
+{
+    // Rotation and scale are padded so a block can always be loaded
+    const int padded = (instances + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+    m_size = instances;
+    m_position.resize(instances, glm::vec3(0, 0, 0));
+    m_world.resize(instances, glm::mat4());
+    m_rotationX.resize(padded, 0.0f);
+    m_rotationY.resize(padded, 0.0f);
+    m_rotationZ.resize(padded, 0.0f);
+    m_scaleX.resize(padded, 1.0f);
+    m_scaleY.resize(padded, 1.0f);
+    m_scaleZ.resize(padded, 1.0f);
+
+    // Atomics can't be moved so the words are copied into a new allocation
+    const int words = (instances + DIRTY_BITS - 1) / DIRTY_BITS;
+    std::unique_ptr<std::atomic<uint64_t>[]> dirty(new std::atomic<uint64_t>[words]);
+    for (int word = 0; word < words; ++word)
+    {
+        dirty[word] = word < m_dirtyWords ? m_dirty[word].load() : 0;
+    }
+    m_dirty = std::move(dirty);
+    m_dirtyWords = words;
+}
+
+int InstanceTransforms::Size() const
+{
+    return m_size;
+}
+
+void InstanceTransforms::Update()
+{
+    Update(0, m_size);
+}
+
+void InstanceTransforms::Update(int begin, int end)
+{
+    assert(begin % DIRTY_BITS == 0);
+
+    const int lastWord = std::min((end + DIRTY_BITS - 1) / DIRTY_BITS, m_dirtyWords);
+    for (int word = begin / DIRTY_BITS; word < lastWord; ++word)
+    {
+        uint64_t bits = m_dirty[word].exchange(0, std::memory_order_relaxed);
+
+        for (int index = word * DIRTY_BITS; bits != 0; index += BLOCK_SIZE)
+        {
+            const unsigned int mask = static_cast<unsigned int>(bits & 0xF);
+            if (mask != 0)
+            {
+                UpdateBlock(index, mask);
+            }
+            bits >>= BLOCK_SIZE;
+        }
+    }
+}
+
+void InstanceTransforms::UpdateBlock(int index, unsigned int mask)
+{
+    const __m128 toRadians = _mm_set1_ps(DEG_TO_RAD);
+
+    __m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+    SinCos(_mm_mul_ps(_mm_loadu_ps(&m_rotationX[index]), toRadians), sinX, cosX);
+    SinCos(_mm_mul_ps(_mm_loadu_ps(&m_rotationY[index]), toRadians), sinY, cosY);
+    SinCos(_mm_mul_ps(_mm_loadu_ps(&m_rotationZ[index]), toRadians), sinZ, cosZ);
+
+    const __m128 scaleX = _mm_loadu_ps(&m_scaleX[index]);
+    const __m128 scaleY = _mm_loadu_ps(&m_scaleY[index]);
+    const __m128 scaleZ = _mm_loadu_ps(&m_scaleZ[index]);
+
+    // Expanded form of translate * (rotateZ * rotateX * rotateY) * scale
+    const __m128 sinXsinY = _mm_mul_ps(sinX, sinY);
+    const __m128 sinXcosY = _mm_mul_ps(sinX, cosY);
+
+    __m128 columns[3][4];
+    columns[0][0] = _mm_mul_ps(scaleX, _mm_sub_ps(_mm_mul_ps(cosZ, cosY), _mm_mul_ps(sinZ, sinXsinY)));
+    columns[0][1] = _mm_mul_ps(scaleX, _mm_add_ps(_mm_mul_ps(sinZ, cosY), _mm_mul_ps(cosZ, sinXsinY)));
+    columns[0][2] = _mm_mul_ps(scaleX, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(cosX, sinY)));
+    columns[0][3] = _mm_setzero_ps();
+
+    columns[1][0] = _mm_mul_ps(scaleY, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sinZ, cosX)));
+    columns[1][1] = _mm_mul_ps(scaleY, _mm_mul_ps(cosZ, cosX));
+    columns[1][2] = _mm_mul_ps(scaleY, sinX);
+    columns[1][3] = _mm_setzero_ps();
+
+    columns[2][0] = _mm_mul_ps(scaleZ, _mm_add_ps(_mm_mul_ps(cosZ, sinY), _mm_mul_ps(sinZ, sinXcosY)));
+    columns[2][1] = _mm_mul_ps(scaleZ, _mm_sub_ps(_mm_mul_ps(sinZ, sinY), _mm_mul_ps(cosZ, sinXcosY)));
+    columns[2][2] = _mm_mul_ps(scaleZ, _mm_mul_ps(cosX, cosY));
+    columns[2][3] = _mm_setzero_ps();
+
+    // Each register holds one element for four instances, transpose to one column per instance
+    for (int column = 0; column < 3; ++column)
+    {
+        __m128* c = columns[column];
+        _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+
+        for (int lane = 0; lane < BLOCK_SIZE; ++lane)
+        {
+            if (mask & (1 << lane))
+            {
+                _mm_storeu_ps(&m_world[index + lane][column][0], c[lane]);
+            }
+        }
+    }
+
+    for (int lane = 0; lane < BLOCK_SIZE; ++lane)
+    {
+        if (mask & (1 << lane))
+        {
+            m_world[index + lane][3] = glm::vec4(m_position[index + lane], 1.0f);
+        }
+    }
+}
+
+bool InstanceTransforms::IsDirty(int index) const
+{
+    return (m_dirty[index / DIRTY_BITS].load(std::memory_order_relaxed) & 
+        (uint64_t(1) << (index % DIRTY_BITS))) != 0;
+}
+
+void InstanceTransforms::SetDirty(int index, bool dirty)
+{
+    const uint64_t bit = uint64_t(1) << (index % DIRTY_BITS);
+    auto& word = m_dirty[index / DIRTY_BITS];
+
+    // Parallel jobs tick instances that share a word so each change must be atomic
+    if (dirty)
+    {
+        word.fetch_or(bit, std::memory_order_relaxed);
+    }
+    else
+    {
+        word.fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+const glm::vec3& InstanceTransforms::Position(int index) const
+{
+    return m_position[index];
+}
+
+void InstanceTransforms::Position(const glm::vec3& position, int index)
+{
+    m_position[index] = position;
+    SetDirty(index, true);
+}
+
+glm::vec3 InstanceTransforms::Rotation(int index) const
+{
+    return glm::vec3(m_rotationX[index], m_rotationY[index], m_rotationZ[index]);
+}
+
+void InstanceTransforms::Rotation(const glm::vec3& rotation, int index)
+{
+    m_rotationX[index] = rotation.x;
+    m_rotationY[index] = rotation.y;
+    m_rotationZ[index] = rotation.z;
+    SetDirty(index, true);
+}
+
+glm::vec3 InstanceTransforms::Scale(int index) const
+{
+    return glm::vec3(m_scaleX[index], m_scaleY[index], m_scaleZ[index]);
+}
+
+void InstanceTransforms::Scale(const glm::vec3& scale, int index)
+{
+    m_scaleX[index] = scale.x;
+    m_scaleY[index] = scale.y;
+    m_scaleZ[index] = scale.z;
+    SetDirty(index, true);
+}
+
+const glm::mat4& InstanceTransforms::World(int index) const
+{
+    return m_world[index];
+}
+
+void InstanceTransforms::World(const glm::mat4& world, int index)
+{
+    m_world[index] = world;
+    m_position[index] = glm::matrix_get_position(world);
+    SetDirty(index, false);
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - InstanceTransforms.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+/**
+* Transform data for all instances of a mesh stored as structure of arrays
+* World matrices for dirty instances are rebuilt four at a time using SSE
+*/
+class InstanceTransforms
+{
+public:
+
+    static const int RANGE_SIZE = 64; ///< Instances sharing a dirty word, ranges updated in parallel start on a multiple
+
+    /**
+    * Sets the number of instances
+    * @param instances The amount of instances to hold
+    */
+    void Resize(int instances);
+
+    /**
+    * @return the amount of instances held
+    */
+    int Size() const;
+
+    /**
+    * Rebuilds the world matrix of all dirty instances
+    */
+    void Update();
+
+    /**
+    * Rebuilds the world matrix of dirty instances within a range
+    * @param begin The first instance, which must be a multiple of RANGE_SIZE
+    * @param end One past the last instance
+    * @note ranges which don't overlap can be updated from different threads
+    */
+    void Update(int begin, int end);
+
+    /**
+    * @return whether the instance requires its world matrix rebuilt
+    */
+    bool IsDirty(int index) const;
+
+    /**
+    * @return the position of the instance
+    */
+    const glm::vec3& Position(int index) const;
+
+    /**
+    * Sets the position of the instance
+    */
+    void Position(const glm::vec3& position, int index);
+
+    /**
+    * @return the degrees rotated around each axis of the instance
+    */
+    glm::vec3 Rotation(int index) const;
+
+    /**
+    * Sets the degrees rotated around each axis of the instance
+    */
+    void Rotation(const glm::vec3& rotation, int index);
+
+    /**
+    * @return the scale of the instance
+    */
+    glm::vec3 Scale(int index) const;
+
+    /**
+    * Sets the scale of the instance
+    */
+    void Scale(const glm::vec3& scale, int index);
+
+    /**
+    * @return the world matrix of the instance
+    */
+    const glm::mat4& World(int index) const;
+
+    /**
+    * Explicitly set the world matrix
+    * @note does not set rotation/scale components
+    */
+    void World(const glm::mat4& world, int index);
+
+private:
+
+    /**
+    * Marks whether the instance requires its world matrix rebuilt
+    * @note instances sharing a dirty word can be set from different threads
+    */
+    void SetDirty(int index, bool dirty);
+
+    /**
+    * Rebuilds the world matrices for a block of four instances
+    * @param index The first instance of the block
+    * @param mask Bit per instance in the block that requires updating
+    */
+    void UpdateBlock(int index, unsigned int mask);
+
+private:
+
+    int m_size = 0;                         ///< Number of instances held
+    std::vector<glm::vec3> m_position;      ///< Position of each instance
+    std::vector<float> m_rotationX;         ///< Degrees rotated around the x axis
+    std::vector<float> m_rotationY;         ///< Degrees rotated around the y axis
+    std::vector<float> m_rotationZ;         ///< Degrees rotated around the z axis
+    std::vector<float> m_scaleX;            ///< Scale along the x axis
+    std::vector<float> m_scaleY;            ///< Scale along the y axis
+    std::vector<float> m_scaleZ;            ///< Scale along the z axis
+    std::vector<glm::mat4> m_world;         ///< World matrix of each instance
+    std::unique_ptr<std::atomic<uint64_t>[]> m_dirty; ///< Bit per instance requiring a rebuild
+    int m_dirtyWords = 0;                   ///< Number of dirty words allocated
+};
@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - JobSystem.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+#include "Tweaker.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+namespace
+{
+    const float TIMING_SMOOTHING = 0.1f;  ///< Weighting of the newest timing sample
+
+    /**
+    * @return the current time in nanoseconds
+    */
+    long long Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+}
+
+JobSystem::JobSystem(int workers)
+    : m_pendingJobs(0)
+    , m_queuedTasks(0)
+    , m_running(true)
+{
+    if (workers < 0)
+    {
+        const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        workers = std::max(hardware - 1, 0);
+    }
+
+    // Final queue is owned by the thread that calls Execute
+    for (int i = 0; i <= workers; ++i)
+    {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    for (int i = 0; i < workers; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    LogInfo("JobSystem: Initialised with " + std::to_string(Threads()) + " threads");
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_signalMutex);
+        m_running = false;
+    }
+    m_signal.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::AddToTweaker(Tweaker& tweaker)
+{
+    tweaker.SetGroup("Jobs");
+    tweaker.AddIntEntry("Threads", [this](){ return Threads(); });
+
+    for (auto& timing : m_timings)
+    {
+        tweaker.AddEntry(timing.first + " (ms)", &timing.second, TW_TYPE_FLOAT, true);
+    }
+}
+
+int JobSystem::Threads() const
+{
+    return static_cast<int>(m_queues.size());
+}
+
+float JobSystem::GetTiming(const std::string& name) const
+{
+    auto itr = m_timings.find(name);
+    return itr != m_timings.end() ? itr->second : 0.0f;
+}
+
+const std::map<std::string, double>& JobSystem::GetTotalTimings() const
+{
+    return m_totalTimings;
+}
+
+JobSystem::JobID JobSystem::Add(const std::string& name,
+                                JobFn job,
+                                const Dependencies& dependencies)
+{
+    return AddJob(name, job, nullptr, 1, 1, dependencies);
+}
+
+JobSystem::JobID JobSystem::AddParallelFor(const std::string& name,
+                                           int count,
+                                           int grain,
+                                           ParallelFn job,
+                                           const Dependencies& dependencies)
+{
+    return AddJob(name, nullptr, job, count, std::max(grain, 1), dependencies);
+}
+
+JobSystem::JobID JobSystem::AddJob(const std::string& name,
+                                   JobFn single,
+                                   ParallelFn parallel,
+                                   int count,
+                                   int grain,
+                                   const Dependencies& dependencies)
+{
+    const JobID ID = static_cast<JobID>(m_jobs.size());
+    m_jobs.push_back(std::make_unique<Job>());
+
+    auto& job = *m_jobs[ID];
+    job.name = name;
+    job.single = single;
+    job.parallel = parallel;
+    job.count = count;
+    job.grain = grain;
+    job.tasks = 0;
+    job.started = std::numeric_limits<long long>::max();
+    job.dependencies = static_cast<int>(dependencies.size());
+
+    for (JobID dependency : dependencies)
+    {
+        assert(dependency >= 0 && dependency < ID);
+        m_jobs[dependency]->dependents.push_back(ID);
+    }
+
+    return ID;
+}
+
+void JobSystem::Execute()
+{
+    if (m_jobs.empty())
+    {
+        return;
+    }
+
+    const int caller = Threads() - 1;
+    m_pendingJobs = static_cast<int>(m_jobs.size());
+
+    // Find all roots before scheduling as running jobs will modify dependency counts
+    std::vector<JobID> roots;
+    for (JobID ID = 0; ID < static_cast<JobID>(m_jobs.size()); ++ID)
+    {
+        if (m_jobs[ID]->dependencies == 0)
+        {
+            roots.push_back(ID);
+        }
+    }
+
+    for (JobID ID : roots)
+    {
+        Schedule(caller, ID);
+    }
+
+    while (m_pendingJobs > 0)
+    {
+        if (!RunTask(caller))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (const auto& job : m_jobs)
+    {
+        const long long nanoseconds = job->finished > job->started ? 
+            job->finished - job->started : 0;
+
+        const float milliseconds = nanoseconds / 1000000.0f;
+        m_totalTimings[job->name] += nanoseconds / 1000000.0;
+
+        auto itr = m_timings.find(job->name);
+        if (itr == m_timings.end())
+        {
+            m_timings[job->name] = milliseconds;
+        }
+        else
+        {
+            itr->second += (milliseconds - itr->second) * TIMING_SMOOTHING;
+        }
+    }
+
+    m_jobs.clear();
+}
+
+void JobSystem::Schedule(int index, JobID ID)
+{
+    auto& job = *m_jobs[ID];
+
+    if (job.count <= 0)
+    {
+        CompleteJob(index, ID);
+        return;
+    }
+
+    const int tasks = (job.count + job.grain - 1) / job.grain;
+    job.tasks = tasks;
+
+    {
+        auto& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (int i = 0; i < tasks; ++i)
+        {
+            Task task;
+            task.job = ID;
+            task.begin = i * job.grain;
+            task.end = std::min(task.begin + job.grain, job.count);
+            queue.tasks.push_back(task);
+        }
+    }
+
+    m_queuedTasks += tasks;
+
+    // Lock required so a worker cannot miss the signal between checking and waiting
+    {
+        std::lock_guard<std::mutex> lock(m_signalMutex);
+    }
+    m_signal.notify_all();
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+    while (m_running)
+    {
+        if (!RunTask(index))
+        {
+            std::unique_lock<std::mutex> lock(m_signalMutex);
+            m_signal.wait(lock, [this]()
+            {
+                return m_queuedTasks > 0 || !m_running;
+            });
+        }
+    }
+}
+
+bool JobSystem::FindTask(int index, Task& task)
+{
+    // Newest tasks from the owned queue are the most likely to be in cache
+    {
+        auto& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest task from the other queues
+    const int queues = Threads();
+    for (int i = 1; i < queues; ++i)
+    {
+        auto& queue = *m_queues[(index + i) % queues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::RunTask(int index)
+{
+    Task task;
+    if (m_queuedTasks <= 0 || !FindTask(index, task))
+    {
+        return false;
+    }
+
+    --m_queuedTasks;
+
+    auto& job = *m_jobs[task.job];
+
+    // Tasks of a parallel job overlap so the job is timed across all of them
+    const long long start = Now();
+    long long started = job.started.load(std::memory_order_relaxed);
+    while (start < started && !job.started.compare_exchange_weak(started, start))
+    {
+    }
+
+    if (job.single)
+    {
+        job.single();
+    }
+    else
+    {
+        for (int i = task.begin; i < task.end; ++i)
+        {
+            job.parallel(i);
+        }
+    }
+
+    const long long finished = Now();
+    if (--job.tasks == 0)
+    {
+        // Only the last task to finish reaches here
+        job.finished = finished;
+        CompleteJob(index, task.job);
+    }
+
+    return true;
+}
+
+void JobSystem::CompleteJob(int index, JobID ID)
+{
+    for (JobID dependent : m_jobs[ID]->dependents)
+    {
+        if (--m_jobs[dependent]->dependencies == 0)
+        {
+            Schedule(index, dependent);
+        }
+    }
+
+    --m_pendingJobs;
+}
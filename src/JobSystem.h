@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - JobSystem.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+
+class Tweaker;
+
+/**
+* Work-stealing thread pool that executes a graph of dependent jobs
+* Jobs are added each frame and run when Execute is called
+*/
+class JobSystem
+{
+public:
+
+    typedef int JobID;
+    typedef std::function<void(void)> JobFn;
+    typedef std::function<void(int)> ParallelFn;
+    typedef std::vector<JobID> Dependencies;
+
+    /**
+    * Constructor
+    * @param workers The number of worker threads, negative will use the hardware concurrency
+    */
+    JobSystem(int workers = -1);
+
+    /**
+    * Destructor
+    */
+    ~JobSystem();
+
+    /**
+    * Adds data for this element to be tweaked by the gui
+    * @param tweaker The helper for adding tweakable entries
+    */
+    void AddToTweaker(Tweaker& tweaker);
+
+    /**
+    * Adds a single job to the graph
+    * @param name The name of the job used for timings
+    * @param job The function to run
+    * @param dependencies Jobs which must complete before this job can run
+    * @return the ID of the job
+    */
+    JobID Add(const std::string& name,
+              JobFn job,
+              const Dependencies& dependencies = Dependencies());
+
+    /**
+    * Adds a job to the graph which calls the function for every index in [0, count)
+    * @param name The name of the job used for timings
+    * @param count The number of indices to process
+    * @param grain The number of indices processed by a single task
+    * @param job The function to run for each index
+    * @param dependencies Jobs which must complete before this job can run
+    * @return the ID of the job
+    */
+    JobID AddParallelFor(const std::string& name,
+                         int count,
+                         int grain,
+                         ParallelFn job,
+                         const Dependencies& dependencies = Dependencies());
+
+    /**
+    * Runs all added jobs and waits for them to complete
+    * The calling thread also participates in running the jobs
+    * @note the graph is cleared once complete
+    */
+    void Execute();
+
+    /**
+    * @return the number of threads that can run jobs including the caller
+    */
+    int Threads() const;
+
+    /**
+    * @return The smoothed time in milliseconds from the job starting to finishing
+    * @note parallel jobs are timed from their first task starting to their last finishing
+    */
+    float GetTiming(const std::string& name) const;
+
+    /**
+    * @return The total time in milliseconds from each job starting to finishing by name
+    */
+    const std::map<std::string, double>& GetTotalTimings() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+    * Single unit of work that can be stolen by any thread
+    */
+    struct Task
+    {
+        JobID job = 0;    ///< The job this task belongs to
+        int begin = 0;    ///< First index to process
+        int end = 0;      ///< One past the last index to process
+    };
+
+    /**
+    * Node in the job graph
+    */
+    struct Job
+    {
+        std::string name;                   ///< Name of the job used for timings
+        JobFn single;                       ///< Function for a single job
+        ParallelFn parallel;                ///< Function for a parallel for job
+        int count = 0;                      ///< Number of indices for a parallel job
+        int grain = 1;                      ///< Indices processed per task
+        std::vector<JobID> dependents;      ///< Jobs waiting on this job
+        std::atomic<int> dependencies;      ///< Number of incomplete dependencies
+        std::atomic<int> tasks;             ///< Number of incomplete tasks
+        std::atomic<long long> started;     ///< Time in nanoseconds the first task started
+        long long finished = 0;             ///< Time in nanoseconds the last task finished
+    };
+
+    /**
+    * Queue of tasks owned by a thread that others may steal from
+    */
+    struct TaskQueue
+    {
+        std::mutex mutex;         ///< Protects access to the tasks
+        std::deque<Task> tasks;   ///< Tasks pushed by the owning thread
+    };
+
+    /**
+    * Main loop for the worker threads
+    * @param index The index of the queue owned by the thread
+    */
+    void WorkerLoop(int index);
+
+    /**
+    * Attempts to run a single task
+    * @param index The index of the queue owned by the thread
+    * @return whether a task was run
+    */
+    bool RunTask(int index);
+
+    /**
+    * Pops a task from the thread's own queue or steals one from another
+    * @param index The index of the queue owned by the thread
+    * @param task The task to fill in
+    * @return whether a task was found
+    */
+    bool FindTask(int index, Task& task);
+
+    /**
+    * Splits a job into tasks and pushes them onto a queue
+    * @param index The index of the queue to push to
+    * @param job The ID of the job to schedule
+    */
+    void Schedule(int index, JobID job);
+
+    /**
+    * Called once every task of a job has completed
+    * @param index The index of the queue owned by the thread
+    * @param job The ID of the completed job
+    */
+    void CompleteJob(int index, JobID job);
+
+    /**
+    * Adds a new node to the graph
+    */
+    JobID AddJob(const std::string& name,
+                 JobFn single,
+                 ParallelFn parallel,
+                 int count,
+                 int grain,
+                 const Dependencies& dependencies);
+
+private:
+
+    std::vector<std::thread> m_workers;                ///< Threads running jobs
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;  ///< Task queue for each thread, last is the caller
+    std::vector<std::unique_ptr<Job>> m_jobs;          ///< Jobs added since the last execute
+    std::map<std::string, float> m_timings;            ///< Smoothed timings for each job name
+    std::map<std::string, double> m_totalTimings;      ///< Accumulated timings for each job name
+    std::mutex m_signalMutex;                          ///< Mutex for waking workers
+    std::condition_variable m_signal;                  ///< Wakes workers when tasks are available
+    std::atomic<int> m_pendingJobs;                    ///< Number of jobs yet to complete
+    std::atomic<int> m_queuedTasks;                    ///< Number of tasks waiting in queues
+    std::atomic<bool> m_running;                       ///< Whether the workers should keep running
+};
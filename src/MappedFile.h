@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - MappedFile.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+/**
+* Read only view of a file mapped into memory
+*/
+class MappedFile
+{
+public:
+
+    /**
+    * Constructor
+    */
+    MappedFile();
+
+    /**
+    * Destructor
+    */
+    ~MappedFile();
+
+    /**
+    * Maps the file into memory, closing any previously mapped file
+    * @param path The full path to the file
+    * @return whether mapping was successful
+    */
+    bool Open(const std::string& path);
+
+    /**
+    * Unmaps the file
+    */
+    void Close();
+
+    /**
+    * @return the start of the mapped file or null if not mapped
+    */
+    const char* Data() const;
+
+    /**
+    * @return the size of the mapped file in bytes
+    */
+    size_t Size() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+
+    const char* m_data = nullptr;   ///< Start of the mapped file
+    size_t m_size = 0;              ///< Size of the mapped file in bytes
+    void* m_file = nullptr;         ///< Handle to the open file
+    void* m_mapping = nullptr;      ///< Handle to the file mapping
+};
\ No newline at end of file
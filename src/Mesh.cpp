@@ -21,7 +21,11 @@ Mesh::~Mesh()
     {
         glDeleteBuffers(1, &m_vboID);
         glDeleteBuffers(1, &m_iboID);
-        glDeleteBuffers(1, &m_vaoID);
+        for (const VertexArray& vertexArray : m_vertexArrays)
+        {
+            glDeleteVertexArrays(1, &vertexArray.id);
+        }
+        m_vertexArrays.clear();
         m_initialised = false;
     }
 }
@@ -33,24 +37,44 @@ void Mesh::AddToTweaker(Tweaker& tweaker)
     tweaker.AddFltEntry("Radius", &m_radius, 0.1f, 0.1f, FLT_MAX);
 }
 
-bool Mesh::Initialise(int instances)
+bool Mesh::Initialise(int instances, bool createBuffers)
 {
     m_instances.resize(instances);
+    m_transforms.Resize(instances);
+
+    // Radius is already known for meshes loaded from file
+    if (m_radius == 0.0f)
+    {
+        GenerateRadius();
+    }
+
+    if (m_levels.empty())
+    {
+        LevelOfDetail level;
+        level.count = static_cast<unsigned int>(m_indices.size());
+        m_levels.push_back(level);
+    }
+
+    if (!createBuffers)
+    {
+        return true;
+    }
 
-    glGenVertexArrays(1, &m_vaoID);
     glGenBuffers(1, &m_vboID);
     glGenBuffers(1, &m_iboID);
     m_initialised = true;
-    
-    glBindVertexArray(m_vaoID);
 
+    std::vector<char> buffer;
+    m_format.Initialise(m_vertices, m_vertexComponentCount);
+
+    m_format.PackVertices(m_vertices, buffer);
     glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*m_vertices.size(), 
-        &m_vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, buffer.size(), buffer.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iboID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*m_indices.size(), 
-        &m_indices[0], GL_STATIC_DRAW);
+    // Index buffers are attached to each vertex array when it is created
+    m_format.PackIndices(m_indices, buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_iboID);
+    glBufferData(GL_COPY_WRITE_BUFFER, buffer.size(), buffer.data(), GL_STATIC_DRAW);
 
     if(HasCallFailed())
     {
@@ -58,8 +82,6 @@ bool Mesh::Initialise(int instances)
         return false;
     }
 
-    GenerateRadius();
-
     return true;
 }
 
@@ -77,41 +99,65 @@ void Mesh::GenerateRadius()
     }
 }
 
-void Mesh::PreRender() const
+void Mesh::PreRender(unsigned int attributes) const
 {
     assert(m_initialised);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iboID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
-}
-
-void Mesh::Render(RenderInstance renderInstance) const
-{
-    for (const Instance& instance : m_instances)
+    for (const VertexArray& vertexArray : m_vertexArrays)
     {
-        if (instance.render)
+        if (vertexArray.attributes == attributes)
         {
-            renderInstance(instance.world);
-            Render();
+            glBindVertexArray(vertexArray.id);
+            return;
         }
     }
+
+    // The layout is only recorded once so later draws just bind the vertex array
+    VertexArray vertexArray;
+    vertexArray.attributes = attributes;
+    glGenVertexArrays(1, &vertexArray.id);
+    glBindVertexArray(vertexArray.id);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iboID);
+    m_format.EnableAttributes(attributes);
+
+    if(HasCallFailed())
+    {
+        LogError("Failed to set " + m_name + " vertex array");
+    }
+
+    m_vertexArrays.push_back(vertexArray);
 }
 
-void Mesh::RenderTextured(RenderTexturedInstance renderInstance) const
+void Mesh::GetRenderStates(RenderStates& states) const
 {
-    for (const Instance& instance : m_instances)
+    states.clear();
+    for (unsigned int i = 0; i < m_instances.size(); ++i)
     {
-        if (instance.render)
+        if (m_instances[i].render)
         {
-            renderInstance(instance.world, instance.texture);
-            Render();
+            RenderState state;
+            state.world = m_transforms.World(i);
+            state.texture = m_instances[i].texture;
+            state.instance = i;
+            states.push_back(state);
         }
     }
 }
 
-void Mesh::Render() const
+void Mesh::Render(int level) const
+{
+    assert(m_initialised);
+    const LevelOfDetail& lod = m_levels[level];
+    glDrawElements(GL_TRIANGLES, lod.count, m_format.IndexType(), 
+        BufferOffset(lod.offset * m_format.IndexSize()));
+}
+
+void Mesh::RenderInstanced(int instances, int level) const
 {
     assert(m_initialised);
-    glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
+    const LevelOfDetail& lod = m_levels[level];
+    glDrawElementsInstanced(GL_TRIANGLES, lod.count, m_format.IndexType(), 
+        BufferOffset(lod.offset * m_format.IndexSize()), instances);
 }
 
 const std::string& Mesh::Name() const
@@ -129,11 +175,46 @@ const std::vector<float>& Mesh::Vertices() const
     return m_vertices;
 }
 
-const std::vector<unsigned long>& Mesh::Indices() const
+const std::vector<unsigned int>& Mesh::Indices() const
 {
     return m_indices;
 }
 
+int Mesh::VertexComponentCount() const
+{
+    return m_vertexComponentCount;
+}
+
+bool Mesh::HasBuffers() const
+{
+    return m_initialised;
+}
+
+const VertexFormat& Mesh::Format() const
+{
+    return m_format;
+}
+
+int Mesh::LevelsOfDetail() const
+{
+    return static_cast<int>(m_levels.size());
+}
+
+unsigned int Mesh::IndexOffset(int level) const
+{
+    return m_levels[level].offset;
+}
+
+unsigned int Mesh::IndexCount(int level) const
+{
+    return m_levels[level].count;
+}
+
+float Mesh::Radius() const
+{
+    return m_radius;
+}
+
 int Mesh::GetTexture(int index) const
 {
     return m_instances[index].texture;
@@ -160,24 +241,22 @@ void Mesh::SetBackfaceCull(bool value)
 
 const glm::vec3& Mesh::Position(int index) const
 {
-    return m_instances[index].position;
+    return m_transforms.Position(index);
 }
 
-const glm::vec3& Mesh::Scale(int index) const
+glm::vec3 Mesh::Scale(int index) const
 {
-    return m_instances[index].scale;
+    return m_transforms.Scale(index);
 }
 
 void Mesh::SetWorld(const glm::mat4& world, int index)
 {
-    m_instances[index].requiresUpdate = false;
-    m_instances[index].world = world;
-    m_instances[index].position = glm::matrix_get_position(world);
+    m_transforms.World(world, index);
 }
 
 void Mesh::SetShouldRender(bool render, int index)
 {
-    m_instances[index].render = true;
+    m_instances[index].render = render;
 }
 
 void Mesh::Tick()
@@ -185,57 +264,14 @@ void Mesh::Tick()
     UpdateTransforms();
 }
 
-void Mesh::UpdateTransforms()
+void Mesh::Tick(int begin, int end)
 {
-    for (auto& instance : m_instances)
-    {
-        if (!instance.render)
-        {
-            continue;
-        }
+    m_transforms.Update(begin, end);
+}
 
-        if (instance.requiresUpdate)
-        {
-            instance.requiresUpdate = false;
-
-            if (instance.rotation.x == 0 &&
-                instance.rotation.y == 0 &&
-                instance.rotation.z == 0)
-            {
-                instance.world[0][0] = instance.scale.x;
-                instance.world[0][1] = 0.0f;
-                instance.world[0][2] = 0.0f;
-                instance.world[1][0] = 0.0f;
-                instance.world[1][1] = instance.scale.y;
-                instance.world[1][2] = 0.0f;
-                instance.world[2][0] = 0.0f;
-                instance.world[2][1] = 0.0f;
-                instance.world[2][2] = instance.scale.z;
-                instance.world[3][0] = instance.position.x;
-                instance.world[3][1] = instance.position.y;
-                instance.world[3][2] = instance.position.z;
-            }
-            else
-            {
-                glm::mat4 scale;
-                scale[0][0] = instance.scale.x;
-                scale[1][1] = instance.scale.y;
-                scale[2][2] = instance.scale.z;
-
-                glm::mat4 translate;
-                translate[3][0] = instance.position.x;
-                translate[3][1] = instance.position.y;
-                translate[3][2] = instance.position.z;
-
-                glm::mat4 rotateX, rotateY, rotateZ;
-                rotateX = glm::rotate(rotateX, instance.rotation.x, glm::vec3(1, 0, 0));
-                rotateY = glm::rotate(rotateY, instance.rotation.y, glm::vec3(0, 1, 0));
-                rotateZ = glm::rotate(rotateZ, instance.rotation.z, glm::vec3(0, 0, 1));
-
-                instance.world = translate * (rotateZ * rotateX * rotateY) * scale;
-            }
-        }
-    }
+void Mesh::UpdateTransforms()
+{
+    m_transforms.Update();
 }
 
 std::vector<glm::vec3> Mesh::VertexPositions() const
@@ -257,24 +293,17 @@ std::vector<glm::vec3> Mesh::VertexPositions() const
 
 void Mesh::Position(float x, float y, float z, int index)
 {
-    m_instances[index].position.x = x;
-    m_instances[index].position.y = y;
-    m_instances[index].position.z = z;
-    m_instances[index].requiresUpdate = true;
+    m_transforms.Position(glm::vec3(x, y, z), index);
 }
 
 void Mesh::Rotation(float x, float y, float z, int index)
 {
-    m_instances[index].rotation.x = x;
-    m_instances[index].rotation.y = y;
-    m_instances[index].rotation.z = z;
-    m_instances[index].requiresUpdate = true;
+    m_transforms.Rotation(glm::vec3(x, y, z), index);
 }
 
 void Mesh::Scale(const glm::vec3& scale, int index)
 {
-    m_instances[index].scale= scale;
-    m_instances[index].requiresUpdate = true;
+    m_transforms.Scale(scale, index);
 }
 
 int Mesh::Instances() const
@@ -300,7 +329,7 @@ bool Mesh::Visible(int index) const
 
 const glm::mat4& Mesh::GetWorld(int index)
 {
-    return m_instances[index].world;
+    return m_transforms.World(index);
 }
 
 void Mesh::SetRenderShadows(bool render)
@@ -313,6 +342,16 @@ bool Mesh::RenderShadows() const
     return m_renderShadows;
 }
 
+void Mesh::SetShadowMesh(const Mesh* mesh)
+{
+    m_shadowMesh = mesh;
+}
+
+const Mesh* Mesh::ShadowMesh() const
+{
+    return m_shadowMesh;
+}
+
 void Mesh::SetRenderWithLights(bool render)
 {
     m_renderWithLighting = render;
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "glm/glm.hpp"
+#include "InstanceTransforms.h"
+#include "VertexFormat.h"
 
 #include <string>
 #include <vector>
@@ -21,25 +23,27 @@ class Mesh
 public:
 
     /**
-    * Callbacks for rendering a mesh instance
+    * Holds information for a single instance of a mesh
+    * @note transforms are held separately in InstanceTransforms
     */
-    typedef std::function<void(const glm::mat4&)> RenderInstance;
-    typedef std::function<void(const glm::mat4&,int)> RenderTexturedInstance;
+    struct Instance
+    {
+        bool render = true;                    ///< Whether to draw the mesh
+        int texture = -1;                      ///< Texture to use when rendering
+    };
 
     /**
-    * Holds information for a single instance of a mesh
+    * Immutable copy of the information needed to render a single instance
     */
-    struct Instance
+    struct RenderState
     {
         glm::mat4 world;                       ///< World matrix
-        glm::vec3 position = glm::vec3(0,0,0); ///< Position offset
-        glm::vec3 rotation = glm::vec3(0,0,0); ///< Degrees rotated around each axis
-        glm::vec3 scale = glm::vec3(1,1,1);    ///< Scaling of the mesh
-        bool render = true;                    ///< Whether to draw the mesh
-        bool requiresUpdate = false;           ///< Whether to update the world matrix
         int texture = -1;                      ///< Texture to use when rendering
+        int instance = 0;                      ///< Index of the instance in the mesh
     };
 
+    typedef std::vector<RenderState> RenderStates;
+
     /**
     * Constructor
     * @param name The name of the data
@@ -63,34 +67,45 @@ public:
     */
     void Tick();
 
+    /**
+    * Ticks a range of instances of the mesh
+    * @param begin The first instance, which must be a multiple of InstanceTransforms::RANGE_SIZE
+    * @param end One past the last instance
+    */
+    void Tick(int begin, int end);
+
     /**
     * Initialises the buffers for the mesh
     * @param the number of instances of this mesh
+    * @param createBuffers Whether to create the buffers used for rendering
     * @return whether initialisation was successful
     */
-    bool Initialise(int instances = 1);
+    bool Initialise(int instances = 1, bool createBuffers = true);
 
     /**
-    * Pre-renders the mesh
+    * Binds the vertex array for the shader, creating it on first use
+    * @param attributes Mask of the vertex attributes read by the shader
     */
-    void PreRender() const;
+    void PreRender(unsigned int attributes) const;
 
     /**
     * Renders the mesh
+    * @param level The level of detail to render
     */
-    void Render() const;
+    void Render(int level = 0) const;
 
     /**
-    * Renders the mesh
-    * @param renderInstance Callback to render a single mesh instance
+    * Renders multiple copies of the mesh with a single call
+    * @param instances The number of copies to render
+    * @param level The level of detail to render
     */
-    void Render(RenderInstance renderInstance) const;
+    void RenderInstanced(int instances, int level = 0) const;
 
     /**
-    * Renders the mesh with a texture
-    * @param renderInstance Callback to render a single mesh instance
+    * Copies the information required to render all visible instances
+    * @param states The container to fill, cleared before filling
     */
-    void RenderTextured(RenderTexturedInstance renderInstance) const;
+    void GetRenderStates(RenderStates& states) const;
 
     /**
     * @return The name of the mesh
@@ -115,7 +130,44 @@ public:
     /**
     * @return The indicies constructing this mesh
     */
-    const std::vector<unsigned long>& Indices() const;
+    const std::vector<unsigned int>& Indices() const;
+
+    /**
+    * @return The number of floats in each vertex
+    */
+    int VertexComponentCount() const;
+
+    /**
+    * @return Whether the buffers used for rendering have been created
+    */
+    bool HasBuffers() const;
+
+    /**
+    * @return How the vertices and indices are packed in the buffers
+    */
+    const VertexFormat& Format() const;
+
+    /**
+    * @return The number of levels of detail, the first being the full mesh
+    */
+    int LevelsOfDetail() const;
+
+    /**
+    * @param level The level of detail
+    * @return The first index of the level
+    */
+    unsigned int IndexOffset(int level) const;
+
+    /**
+    * @param level The level of detail
+    * @return The number of indices in the level
+    */
+    unsigned int IndexCount(int level) const;
+
+    /**
+    * @return The radius of the sphere surrounding the mesh
+    */
+    float Radius() const;
 
     /**
     * @return The ID for the texture used
@@ -156,7 +208,7 @@ public:
     /**
     * @return the scale of the mesh
     */
-    const glm::vec3& Scale(int index = 0) const;
+    glm::vec3 Scale(int index = 0) const;
 
     /**
     * Sets the scale of the mesh
@@ -215,6 +267,16 @@ public:
     */
     bool RenderShadows() const;
 
+    /**
+    * Sets a lower detail mesh to cast the shadow of this mesh
+    */
+    void SetShadowMesh(const Mesh* mesh);
+
+    /**
+    * @return The mesh to cast shadows with or null to use this mesh
+    */
+    const Mesh* ShadowMesh() const;
+
     /**
     * Whether to render this mesh with lighting
     */
@@ -245,11 +307,30 @@ public:
     */
     bool DepthWrite() const;
 
+protected:
+
+    /**
+    * Determines the radius surrounding this mesh
+    * This is the based on the furthest vertex from the mesh center
+    */
+    void GenerateRadius();
+
+    /**
+    * Range of the indices used by a level of detail
+    */
+    struct LevelOfDetail
+    {
+        unsigned int offset = 0;            ///< Index the level starts at
+        unsigned int count = 0;             ///< Number of indices in the level
+    };
+
 protected:
 
     int m_vertexComponentCount = 0;         ///< Number of components that make up a vertex
     std::vector<float> m_vertices;          ///< Mesh Vertex information
-    std::vector<unsigned long> m_indices;   ///< Mesh Index information
+    std::vector<unsigned int> m_indices;    ///< Mesh Index information for all levels of detail
+    std::vector<LevelOfDetail> m_levels;    ///< Levels of detail, all indices if empty
+    float m_radius = 0.0f;                  ///< The radius of the sphere surrounding the mesh
 
 private:
 
@@ -260,23 +341,28 @@ private:
     Mesh& operator=(const Mesh&) = delete;
 
     /**
-    * Determines the radius surrounding this mesh
-    * This is the based on the furthest vertex from the mesh center
+    * Vertex array recording the buffer layout for a shader
     */
-    void GenerateRadius();
+    struct VertexArray
+    {
+        unsigned int attributes = 0;  ///< Mask of the vertex attributes enabled
+        unsigned int id = 0;          ///< Unique ID for the Vertex Array Object (VAO)
+    };
 
 private:
 
     bool m_backfacecull = true;           ///< Whether backface culling is enabled
     const std::string m_name;             ///< Name of the mesh
     int m_shaderIndex = -1;               ///< Unique Index of the mesh shader to use
-    unsigned int m_vaoID = 0;             ///< An unique ID for Vertex Array Object (VAO)
     unsigned int m_vboID = 0;             ///< Unique ID for the Vertex Buffer Object (VBO)   
     unsigned int m_iboID = 0;             ///< Unique ID for the Index Buffer Object (IBO)
+    VertexFormat m_format;                ///< How the vertices and indices are packed in the buffers
     bool m_initialised = false;           ///< Whether the vertex buffer object is initialised or not
-    float m_radius = 0.0f;                ///< The radius of the sphere surrounding the mesh
+    mutable std::vector<VertexArray> m_vertexArrays; ///< Vertex arrays for each shader layout used
     std::vector<Instance> m_instances;    ///< Instances of this mesh
+    InstanceTransforms m_transforms;      ///< Transforms for each instance of this mesh
     bool m_renderShadows = false;         ///< Whether to render a shadow of this mesh
+    const Mesh* m_shadowMesh = nullptr;   ///< Lower detail mesh to cast shadows with
     bool m_renderWithLighting = true;     ///< Whether to render this mesh with lighting
     bool m_alphaBlending = false;         ///< Whether to render this mesh with alpha blending
     bool m_depthWrite = true;             ///< Whether to write to the depth buffer
@@ -5,11 +5,82 @@
 #include "MeshFile.h"
 #include "Tweaker.h"
 #include "Logger.h"
+#include "MappedFile.h"
+#include "ObjReader.h"
+#include "MeshOptimiser.h"
+#include "MeshSimplifier.h"
 
 #include "assimp/include/scene.h"
 #include "assimp/include/Importer.hpp"
 #include "assimp/include/postprocess.h"
 
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+namespace
+{
+    const char CACHE_MAGIC[4] = { 'T', 'T', 'M', 'C' };
+    const uint32_t CACHE_VERSION = 3;
+    const std::string CACHE_EXTENSION(".meshcache");
+    const std::vector<float> LOD_RATIOS = { 0.5f, 0.25f };  ///< Triangles kept by each level relative to the full mesh
+    const float MIN_LOD_REDUCTION = 0.85f;                  ///< Levels must remove more than this to be kept
+
+    /**
+    * Start of the binary mesh cache, followed by the vertex, index and level blobs
+    */
+    struct CacheHeader
+    {
+        char magic[4];                        ///< Identifies the file as a mesh cache
+        uint32_t version = 0;                 ///< Version of the cache format
+        uint32_t layout = 0;                  ///< Bit flags of the vertex components, importer and optimisations
+        uint32_t componentCount = 0;          ///< Number of floats in a vertex
+        uint32_t vertexCount = 0;             ///< Number of floats in the vertex blob
+        uint32_t indexCount = 0;              ///< Number of 32-bit indices in the index blob
+        float radius = 0.0f;                  ///< Radius of the sphere surrounding the mesh
+        uint32_t levelCount = 0;              ///< Number of offset/count pairs in the level blob
+        unsigned long long sourceSize = 0;    ///< Size of the file the cache was built from
+        long long sourceTime = 0;             ///< Modified time of the file the cache was built from
+    };
+
+    /**
+    * @return the layout bit flags for the required components, importer and optimisations used
+    */
+    uint32_t GetCacheLayout(bool requiresUVs, 
+                            bool requiresNormals, 
+                            MeshFile::Importer importer,
+                            bool optimise,
+                            bool reduceOverdraw,
+                            bool generateLevels)
+    {
+        return (requiresUVs ? 1 : 0) | (requiresNormals ? 2 : 0) | 
+            (importer == MeshFile::ASSIMP ? 4 : 0) | (reduceOverdraw ? 8 : 0) |
+            (generateLevels ? 16 : 0) | (optimise ? 32 : 0);
+    }
+
+    /**
+    * Determines the size and modified time of the source file
+    * @return whether the file exists
+    */
+    bool GetSourceStamp(const std::string& path, 
+                        unsigned long long& size, 
+                        long long& time)
+    {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+        {
+            return false;
+        }
+        size = static_cast<unsigned long long>(info.st_size);
+        time = static_cast<long long>(info.st_mtime);
+        return true;
+    }
+}
+
 MeshFile::MeshFile(const std::string& name, int shaderID)
     : Mesh(name, shaderID)
 {
@@ -18,13 +89,248 @@ MeshFile::MeshFile(const std::string& name, int shaderID)
 bool MeshFile::InitialiseFromFile(const std::string& path, 
                                   bool requiresUVs,
                                   bool requiresNormals, 
-                                  int instances)
+                                  int instances,
+                                  bool createBuffers)
+{
+    return LoadFromFile(path, requiresUVs, requiresNormals) &&
+        Mesh::Initialise(instances, createBuffers);
+}
+
+bool MeshFile::LoadFromFile(const std::string& path, 
+                            bool requiresUVs,
+                            bool requiresNormals)
+{
+    const std::string cachePath = GetCachePath(path);
+    if (LoadFromCache(path, cachePath, requiresUVs, requiresNormals))
+    {
+        LogInfo("Mesh: " + Name() + " loaded from cache");
+        return true;
+    }
+
+    const bool loaded = m_importer == ASSIMP ?
+        LoadFromAssimp(path, requiresUVs, requiresNormals) :
+        LoadFromObj(path, requiresUVs, requiresNormals);
+
+    if (!loaded)
+    {
+        return false;
+    }
+
+    m_levels.clear();
+    std::string description = " created";
+
+    if (m_optimise)
+    {
+        MeshOptimiser optimiser;
+        optimiser.Optimise(m_vertices, m_indices, m_vertexComponentCount, m_reduceOverdraw);
+
+        if (m_generateLevels)
+        {
+            GenerateLevelsOfDetail();
+        }
+
+        description += ", ACMR " + std::to_string(optimiser.ACMRBefore()) + 
+            " -> " + std::to_string(optimiser.ACMRAfter());
+    }
+
+    GenerateRadius();
+    SaveToCache(path, cachePath, requiresUVs, requiresNormals);
+
+    LogInfo("Mesh: " + Name() + description);
+    return true;
+}
+
+void MeshFile::SetImporter(Importer importer)
+{
+    m_importer = importer;
+}
+
+void MeshFile::SetReduceOverdraw(bool reduceOverdraw)
+{
+    m_reduceOverdraw = reduceOverdraw;
+}
+
+void MeshFile::SetOptimise(bool optimise)
+{
+    m_optimise = optimise;
+}
+
+void MeshFile::SetGenerateLevelsOfDetail(bool generate)
+{
+    m_generateLevels = generate;
+}
+
+void MeshFile::GenerateLevelsOfDetail()
+{
+    LevelOfDetail full;
+    full.count = static_cast<unsigned int>(m_indices.size());
+    m_levels.push_back(full);
+
+    const int vertexCount = static_cast<int>(m_vertices.size()) / m_vertexComponentCount;
+    const int triangles = static_cast<int>(m_indices.size()) / 3;
+    std::string description = std::to_string(triangles);
+
+    MeshSimplifier simplifier;
+    MeshOptimiser optimiser;
+    std::vector<unsigned int> previous(m_indices);
+    std::vector<unsigned int> simplified;
+
+    // Each level is simplified from the last and shares the vertices of the full mesh
+    for (float ratio : LOD_RATIOS)
+    {
+        const int target = static_cast<int>(triangles * ratio);
+        simplifier.Simplify(m_vertices, m_vertexComponentCount, previous, target, simplified);
+
+        if (simplified.empty() || simplified.size() > previous.size() * MIN_LOD_REDUCTION)
+        {
+            break;
+        }
+
+        optimiser.OptimiseVertexCache(simplified, vertexCount);
+
+        LevelOfDetail level;
+        level.offset = static_cast<unsigned int>(m_indices.size());
+        level.count = static_cast<unsigned int>(simplified.size());
+        m_levels.push_back(level);
+
+        m_indices.insert(m_indices.end(), simplified.begin(), simplified.end());
+        description += "/" + std::to_string(simplified.size() / 3);
+        previous.swap(simplified);
+    }
+
+    LogInfo("Mesh: " + Name() + " levels of detail " + description + " triangles");
+}
+
+bool MeshFile::LoadFromObj(const std::string& path,
+                           bool requiresUVs,
+                           bool requiresNormals)
+{
+    ObjReader reader;
+    if (!reader.Read(path, requiresUVs, requiresNormals, 
+        m_vertices, m_indices, m_vertexComponentCount))
+    {
+        LogError("OBJ read error for mesh " + path + ": " + reader.GetError());
+        return false;
+    }
+    return true;
+}
+
+std::string MeshFile::GetCachePath(const std::string& path)
+{
+    const auto extension = path.find_last_of('.');
+    return path.substr(0, extension) + CACHE_EXTENSION;
+}
+
+bool MeshFile::LoadFromCache(const std::string& path,
+                             const std::string& cachePath,
+                             bool requiresUVs,
+                             bool requiresNormals)
+{
+    unsigned long long sourceSize = 0;
+    long long sourceTime = 0;
+    if (!GetSourceStamp(path, sourceSize, sourceTime))
+    {
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.Open(cachePath) || file.Size() < sizeof(CacheHeader))
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.Data(), sizeof(CacheHeader));
+
+    const size_t vertexBytes = header.vertexCount * sizeof(float);
+    const size_t indexBytes = header.indexCount * sizeof(uint32_t);
+    const size_t levelBytes = header.levelCount * sizeof(LevelOfDetail);
+
+    // Any mismatch means the cache is stale and should be rebuilt from the source
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CACHE_VERSION ||
+        header.layout != GetCacheLayout(requiresUVs, requiresNormals, 
+            m_importer, m_optimise, m_reduceOverdraw, m_generateLevels) ||
+        header.sourceSize != sourceSize ||
+        header.sourceTime != sourceTime ||
+        header.componentCount == 0 ||
+        file.Size() != sizeof(CacheHeader) + vertexBytes + indexBytes + levelBytes)
+    {
+        return false;
+    }
+
+    const char* vertices = file.Data() + sizeof(CacheHeader);
+    const char* indices = vertices + vertexBytes;
+    const char* levels = indices + indexBytes;
+
+    m_vertexComponentCount = static_cast<int>(header.componentCount);
+    m_vertices.resize(header.vertexCount);
+    std::memcpy(m_vertices.data(), vertices, vertexBytes);
+
+    const uint32_t* indexData = reinterpret_cast<const uint32_t*>(indices);
+    m_indices.assign(indexData, indexData + header.indexCount);
+
+    m_levels.resize(header.levelCount);
+    std::memcpy(m_levels.data(), levels, levelBytes);
+
+    m_radius = header.radius;
+    return true;
+}
+
+void MeshFile::SaveToCache(const std::string& path,
+                           const std::string& cachePath,
+                           bool requiresUVs,
+                           bool requiresNormals) const
+{
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.layout = GetCacheLayout(requiresUVs, requiresNormals, 
+        m_importer, m_optimise, m_reduceOverdraw, m_generateLevels);
+    header.componentCount = static_cast<uint32_t>(m_vertexComponentCount);
+    header.vertexCount = static_cast<uint32_t>(m_vertices.size());
+    header.indexCount = static_cast<uint32_t>(m_indices.size());
+    header.levelCount = static_cast<uint32_t>(m_levels.size());
+    header.radius = m_radius;
+
+    if (!GetSourceStamp(path, header.sourceSize, header.sourceTime))
+    {
+        return;
+    }
+
+    static_assert(sizeof(unsigned int) == sizeof(uint32_t), "Indices are cached as 32-bit");
+
+    // Written to a unique file then renamed so other loaders never see a partial cache
+    std::ostringstream tempPath;
+    tempPath << cachePath << "." << std::this_thread::get_id() << ".tmp";
+    {
+        std::ofstream file(tempPath.str(), std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(m_vertices.data()), m_vertices.size() * sizeof(float));
+        file.write(reinterpret_cast<const char*>(m_indices.data()), m_indices.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(m_levels.data()), m_levels.size() * sizeof(LevelOfDetail));
+        if (!file.good())
+        {
+            LogError("Could not write mesh cache " + cachePath);
+            return;
+        }
+    }
+
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.str().c_str(), cachePath.c_str()) != 0)
+    {
+        std::remove(tempPath.str().c_str());
+    }
+}
+
+bool MeshFile::LoadFromAssimp(const std::string& path, 
+                              bool requiresUVs,
+                              bool requiresNormals)
 {
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_CalcTangentSpace|
-        aiProcess_Triangulate|aiProcess_JoinIdenticalVertices|aiProcess_SortByPType|
-        aiProcess_CalcTangentSpace|aiProcess_JoinIdenticalVertices|aiProcess_GenSmoothNormals|
-        aiProcess_LimitBoneWeights|aiProcess_RemoveRedundantMaterials|aiProcess_OptimizeMeshes);
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate|
+        aiProcess_JoinIdenticalVertices|aiProcess_SortByPType|aiProcess_GenSmoothNormals|
+        aiProcess_RemoveRedundantMaterials|aiProcess_OptimizeMeshes);
 
     if(!scene)
     {
@@ -61,6 +367,10 @@ bool MeshFile::InitialiseFromFile(const std::string& path,
         }
 
         // For each vertex
+        const int maxComponentCount = 8;
+        m_vertices.reserve(m_vertices.size() + pMesh->mNumVertices * maxComponentCount);
+        m_indices.reserve(m_indices.size() + pMesh->mNumFaces * 3);
+
         int componentCount = 0;
         for(unsigned int vert = 0; vert < pMesh->mNumVertices; ++vert)
         {
@@ -118,6 +428,5 @@ bool MeshFile::InitialiseFromFile(const std::string& path,
         }
     }
 
-    LogInfo("Mesh: " + Name() + " created");
-    return Mesh::Initialise(instances);
+    return true;
 }
\ No newline at end of file
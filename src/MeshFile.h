@@ -16,6 +16,15 @@ class MeshFile : public Mesh
 {
 public:
 
+    /**
+    * Avaliable ways of reading mesh files
+    */
+    enum Importer
+    {
+        NATIVE,   ///< Single pass OBJ reader
+        ASSIMP    ///< Assimp importer and post processing
+    };
+
     /**
     * Constructor
     * @param name The name of the mesh
@@ -29,12 +38,53 @@ public:
     * @param requiresUVs whether this mesh requires UVs
     * @param requiresNormals Whether this mesh requires normals
     * @param instances The number of instances to create
+    * @param createBuffers Whether to create the buffers used for rendering
     * @return Whether creation was successful
     */
     bool InitialiseFromFile(const std::string& path, 
                             bool requiresUVs,
                             bool requiresNormals,
-                            int instances);
+                            int instances,
+                            bool createBuffers = true);
+
+    /**
+    * Fills the mesh data from an OBJ file without creating any buffers
+    * Uses the binary cache of the file if up to date, otherwise creates it
+    * Triangles and vertices are optimised for rendering before being cached
+    * along with any levels of detail
+    * @note does not require the OpenGL context and can be called from any thread
+    * @param path The full path to the mesh file
+    * @param requiresUVs whether this mesh requires UVs
+    * @param requiresNormals Whether this mesh requires normals
+    * @return Whether loading was successful
+    */
+    bool LoadFromFile(const std::string& path, 
+                      bool requiresUVs,
+                      bool requiresNormals);
+
+    /**
+    * Sets how the mesh file is read if not already cached
+    * @param importer The importer to use
+    */
+    void SetImporter(Importer importer);
+
+    /**
+    * Sets whether triangles are sorted to reduce overdraw if not already cached
+    * @param reduceOverdraw Whether to sort triangles, only suitable for opaque meshes
+    */
+    void SetReduceOverdraw(bool reduceOverdraw);
+
+    /**
+    * Sets whether the mesh is optimised for rendering if not already cached
+    * @param optimise Whether to optimise, not needed for meshes that are never drawn
+    */
+    void SetOptimise(bool optimise);
+
+    /**
+    * Sets whether simplified levels of detail are generated if not already cached
+    * @param generate Whether to generate the levels of detail
+    */
+    void SetGenerateLevelsOfDetail(bool generate);
 
 private:
 
@@ -43,4 +93,69 @@ private:
     */
     MeshFile(const MeshFile&) = delete;
     MeshFile& operator=(const MeshFile&) = delete;
+
+    /**
+    * @param path The full path to the mesh file
+    * @return the path to the binary cache for the mesh file
+    */
+    static std::string GetCachePath(const std::string& path);
+
+    /**
+    * Fills the mesh data from a memory mapped binary cache
+    * @param path The full path to the mesh file
+    * @param cachePath The full path to the binary cache
+    * @param requiresUVs whether this mesh requires UVs
+    * @param requiresNormals Whether this mesh requires normals
+    * @return Whether the cache exists and is up to date with the mesh file
+    */
+    bool LoadFromCache(const std::string& path,
+                       const std::string& cachePath,
+                       bool requiresUVs,
+                       bool requiresNormals);
+
+    /**
+    * Writes the mesh data to a binary cache
+    * @param path The full path to the mesh file
+    * @param cachePath The full path to the binary cache
+    * @param requiresUVs whether this mesh requires UVs
+    * @param requiresNormals Whether this mesh requires normals
+    */
+    void SaveToCache(const std::string& path,
+                     const std::string& cachePath,
+                     bool requiresUVs,
+                     bool requiresNormals) const;
+
+    /**
+    * Fills the mesh data by importing the mesh file through Assimp
+    * @param path The full path to the mesh file
+    * @param requiresUVs whether this mesh requires UVs
+    * @param requiresNormals Whether this mesh requires normals
+    * @return Whether the import was successful
+    */
+    bool LoadFromAssimp(const std::string& path,
+                        bool requiresUVs,
+                        bool requiresNormals);
+
+    /**
+    * Appends simplified levels of detail to the indices of the full mesh
+    */
+    void GenerateLevelsOfDetail();
+
+    /**
+    * Fills the mesh data by reading the OBJ file directly
+    * @param path The full path to the mesh file
+    * @param requiresUVs whether this mesh requires UVs
+    * @param requiresNormals Whether this mesh requires normals
+    * @return Whether reading was successful
+    */
+    bool LoadFromObj(const std::string& path,
+                     bool requiresUVs,
+                     bool requiresNormals);
+
+private:
+
+    Importer m_importer = NATIVE;  ///< How the mesh file is read if not already cached
+    bool m_optimise = true;        ///< Whether the mesh is optimised for rendering
+    bool m_reduceOverdraw = false; ///< Whether triangles are sorted to reduce overdraw
+    bool m_generateLevels = false; ///< Whether simplified levels of detail are generated
 };
\ No newline at end of file
@@ -0,0 +1,377 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - MeshOptimiser.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MeshOptimiser.h"
+
+#include "glm/glm.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    const int ACMR_CACHE_SIZE = 16;          ///< FIFO cache size used to measure the miss ratio
+    const int SCORE_CACHE_SIZE = 32;         ///< LRU cache size used to score vertices
+    const float CACHE_DECAY_POWER = 1.5f;    ///< How quickly the score drops further into the cache
+    const float LAST_TRIANGLE_SCORE = 0.75f; ///< Score of vertices used by the last triangle added
+    const float VALENCE_BOOST_SCALE = 2.0f;  ///< Boost for vertices with few triangles remaining
+    const float VALENCE_BOOST_POWER = 0.5f;  ///< Falloff of the boost with triangles remaining
+}
+
+void MeshOptimiser::Optimise(std::vector<float>& vertices,
+                             std::vector<unsigned int>& indices,
+                             int componentCount,
+                             bool reduceOverdraw)
+{
+    const int vertexCount = componentCount > 0 ?
+        static_cast<int>(vertices.size()) / componentCount : 0;
+
+    m_acmrBefore = CalculateACMR(indices, vertexCount);
+    m_acmrAfter = m_acmrBefore;
+
+    if (vertexCount == 0 || indices.size() < 3)
+    {
+        return;
+    }
+
+    OptimiseVertexCache(indices, vertexCount);
+
+    if (reduceOverdraw)
+    {
+        OptimiseOverdraw(vertices, indices, componentCount);
+    }
+
+    OptimiseVertexFetch(vertices, indices, componentCount);
+
+    m_acmrAfter = CalculateACMR(indices, vertexCount);
+}
+
+float MeshOptimiser::ACMRBefore() const
+{
+    return m_acmrBefore;
+}
+
+float MeshOptimiser::ACMRAfter() const
+{
+    return m_acmrAfter;
+}
+
+float MeshOptimiser::CalculateACMR(const std::vector<unsigned int>& indices, int vertexCount)
+{
+    const int triangleCount = static_cast<int>(indices.size()) / 3;
+    if (triangleCount == 0)
+    {
+        return 0.0f;
+    }
+
+    // A vertex is still cached if fewer than cache size vertices were added since it was
+    std::vector<int> added(vertexCount, -ACMR_CACHE_SIZE - 1);
+    int time = 0;
+    int misses = 0;
+
+    for (unsigned int index : indices)
+    {
+        if (time - added[index] > ACMR_CACHE_SIZE)
+        {
+            added[index] = time++;
+            ++misses;
+        }
+    }
+
+    return static_cast<float>(misses) / triangleCount;
+}
+
+float MeshOptimiser::ScoreVertex(int cachePosition, int remaining)
+{
+    if (remaining == 0)
+    {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // Vertices of the last triangle have a fixed score so the next
+        // triangle doesn't favour one of its edges over another
+        if (cachePosition < 3)
+        {
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            const float scale = 1.0f / (SCORE_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+
+    return score + VALENCE_BOOST_SCALE * std::pow(
+        static_cast<float>(remaining), -VALENCE_BOOST_POWER);
+}
+
+void MeshOptimiser::OptimiseVertexCache(std::vector<unsigned int>& indices, int vertexCount)
+{
+    const int triangleCount = static_cast<int>(indices.size()) / 3;
+
+    // Triangles using each vertex, the first 'remaining' of each list are not yet added
+    std::vector<int> remaining(vertexCount, 0);
+    std::vector<int> offsets(vertexCount + 1, 0);
+    std::vector<int> adjacency(triangleCount * 3);
+
+    for (int i = 0; i < triangleCount * 3; ++i)
+    {
+        ++remaining[indices[i]];
+    }
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int i = 0; i < triangleCount * 3; ++i)
+    {
+        adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        vertexScore[v] = ScoreVertex(-1, remaining[v]);
+    }
+
+    std::vector<bool> added(triangleCount, false);
+    std::vector<float> triangleScore(triangleCount);
+    for (int t = 0; t < triangleCount; ++t)
+    {
+        triangleScore[t] = vertexScore[indices[t * 3]] +
+            vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+
+    std::vector<int> cache;
+    std::vector<int> updated;
+    cache.reserve(SCORE_CACHE_SIZE + 3);
+    updated.reserve(SCORE_CACHE_SIZE + 3);
+
+    int best = -1;
+    for (int n = 0; n < triangleCount; ++n)
+    {
+        // Nothing in the cache is useful so start from the best remaining triangle
+        if (best == -1)
+        {
+            float bestScore = -1.0f;
+            for (int t = 0; t < triangleCount; ++t)
+            {
+                if (!added[t] && triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        added[best] = true;
+
+        // Vertices of the added triangle move to the front of the cache
+        updated.clear();
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const int vertex = indices[best * 3 + corner];
+            output.push_back(vertex);
+            updated.push_back(vertex);
+
+            int* triangles = &adjacency[offsets[vertex]];
+            int& count = remaining[vertex];
+            const int position = static_cast<int>(
+                std::find(triangles, triangles + count, best) - triangles);
+            std::swap(triangles[position], triangles[count - 1]);
+            --count;
+        }
+
+        for (int vertex : cache)
+        {
+            if (std::find(updated.begin(), updated.end(), vertex) == updated.end())
+            {
+                updated.push_back(vertex);
+            }
+        }
+
+        cache.clear();
+        for (unsigned int i = 0; i < updated.size(); ++i)
+        {
+            const int vertex = updated[i];
+            const bool cached = i < SCORE_CACHE_SIZE;
+            cachePosition[vertex] = cached ? i : -1;
+            vertexScore[vertex] = ScoreVertex(cachePosition[vertex], remaining[vertex]);
+            if (cached)
+            {
+                cache.push_back(vertex);
+            }
+        }
+
+        // Only triangles touching a changed vertex need rescoring
+        best = -1;
+        float bestScore = -1.0f;
+        for (int vertex : updated)
+        {
+            for (int i = 0; i < remaining[vertex]; ++i)
+            {
+                const int t = adjacency[offsets[vertex] + i];
+                triangleScore[t] = vertexScore[indices[t * 3]] +
+                    vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+                if (triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimiser::OptimiseOverdraw(const std::vector<float>& vertices,
+                                     std::vector<unsigned int>& indices,
+                                     int componentCount)
+{
+    const int triangleCount = static_cast<int>(indices.size()) / 3;
+    const int vertexCount = static_cast<int>(vertices.size()) / componentCount;
+
+    auto Position = [&vertices, componentCount](unsigned int index)
+    {
+        const float* position = &vertices[index * componentCount];
+        return glm::vec3(position[0], position[1], position[2]);
+    };
+
+    // A new cluster starts wherever all three vertices of a triangle miss the cache
+    std::vector<int> clusters;
+    std::vector<int> added(vertexCount, -ACMR_CACHE_SIZE - 1);
+    int time = 0;
+
+    for (int t = 0; t < triangleCount; ++t)
+    {
+        int misses = 0;
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const unsigned int index = indices[t * 3 + corner];
+            if (time - added[index] > ACMR_CACHE_SIZE)
+            {
+                added[index] = time++;
+                ++misses;
+            }
+        }
+
+        if (t == 0 || misses == 3)
+        {
+            clusters.push_back(t);
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    const int clusterCount = static_cast<int>(clusters.size()) - 1;
+    if (clusterCount < 2)
+    {
+        return;
+    }
+
+    // Area weighted centroid and normal of each cluster and the whole mesh
+    std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0, 0, 0));
+    std::vector<glm::vec3> normals(clusterCount, glm::vec3(0, 0, 0));
+    glm::vec3 meshCentroid(0, 0, 0);
+    float meshArea = 0.0f;
+
+    for (int c = 0; c < clusterCount; ++c)
+    {
+        float clusterArea = 0.0f;
+        for (int t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const glm::vec3 a = Position(indices[t * 3]);
+            const glm::vec3 b = Position(indices[t * 3 + 1]);
+            const glm::vec3 p = Position(indices[t * 3 + 2]);
+
+            const glm::vec3 normal = glm::cross(b - a, p - a);
+            const float area = glm::length(normal);
+            const glm::vec3 centroid = (a + b + p) / 3.0f;
+
+            normals[c] += normal;
+            centroids[c] += centroid * area;
+            clusterArea += area;
+        }
+
+        meshCentroid += centroids[c];
+        meshArea += clusterArea;
+        centroids[c] = clusterArea > 0.0f ? centroids[c] / clusterArea :
+            Position(indices[clusters[c] * 3]);
+    }
+
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : meshCentroid;
+
+    // Clusters facing away from the center are likely to occlude the rest of the mesh
+    std::vector<float> keys(clusterCount);
+    std::vector<int> order(clusterCount);
+    for (int c = 0; c < clusterCount; ++c)
+    {
+        const float length = glm::length(normals[c]);
+        const glm::vec3 normal = length > 0.0f ? normals[c] / length : normals[c];
+        keys[c] = glm::dot(centroids[c] - meshCentroid, normal);
+        order[c] = c;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&keys](int c1, int c2)
+    {
+        return keys[c1] > keys[c2];
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (int c : order)
+    {
+        output.insert(output.end(),
+            indices.begin() + clusters[c] * 3,
+            indices.begin() + clusters[c + 1] * 3);
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimiser::OptimiseVertexFetch(std::vector<float>& vertices,
+                                        std::vector<unsigned int>& indices,
+                                        int componentCount)
+{
+    const int vertexCount = static_cast<int>(vertices.size()) / componentCount;
+
+    std::vector<int> remap(vertexCount, -1);
+    int next = 0;
+    for (unsigned int& index : indices)
+    {
+        if (remap[index] == -1)
+        {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    // Unused vertices are kept at the end as the physics hulls use all positions
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] == -1)
+        {
+            remap[v] = next++;
+        }
+    }
+
+    std::vector<float> reordered(vertices.size());
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        std::copy(vertices.begin() + v * componentCount,
+                  vertices.begin() + (v + 1) * componentCount,
+                  reordered.begin() + remap[v] * componentCount);
+    }
+
+    vertices.swap(reordered);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - MeshOptimiser.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+/**
+* Reorders the triangles and vertices of a mesh for faster rendering
+* Intended to run once when a mesh is imported and before it is cached
+*/
+class MeshOptimiser
+{
+public:
+
+    /**
+    * Reorders the mesh triangles for post-transform vertex cache locality,
+    * optionally sorts clusters of triangles to reduce overdraw and then
+    * reorders the vertices in the order they are first used
+    * @param vertices The interleaved vertex data to reorder
+    * @param indices The triangle indices to reorder
+    * @param componentCount The number of floats in each vertex
+    * @param reduceOverdraw Whether to sort clusters to reduce overdraw
+    * @note overdraw sorting changes the order triangles blend in so is only for opaque meshes
+    */
+    void Optimise(std::vector<float>& vertices,
+                  std::vector<unsigned int>& indices,
+                  int componentCount,
+                  bool reduceOverdraw);
+
+    /**
+    * @return the average cache miss ratio before optimising
+    */
+    float ACMRBefore() const;
+
+    /**
+    * @return the average cache miss ratio after optimising
+    */
+    float ACMRAfter() const;
+
+    /**
+    * Simulates a FIFO post-transform vertex cache
+    * @param indices The triangle indices to simulate
+    * @param vertexCount The number of vertices the indices refer to
+    * @return the average number of cache misses per triangle
+    */
+    static float CalculateACMR(const std::vector<unsigned int>& indices, int vertexCount);
+
+    /**
+    * Reorders the triangles using Tom Forsyth's linear-speed vertex cache optimisation
+    * @param indices The triangle indices to reorder
+    * @param vertexCount The number of vertices the indices refer to
+    */
+    void OptimiseVertexCache(std::vector<unsigned int>& indices, int vertexCount);
+
+private:
+
+    /**
+    * Sorts clusters of triangles so those facing outward from the mesh center are drawn first
+    * Clusters are split where the vertex cache restarts so cache locality is mostly kept
+    * @param vertices The interleaved vertex data
+    * @param indices The triangle indices to reorder
+    * @param componentCount The number of floats in each vertex
+    */
+    void OptimiseOverdraw(const std::vector<float>& vertices,
+                          std::vector<unsigned int>& indices,
+                          int componentCount);
+
+    /**
+    * Reorders the vertices in the order they are first used by the indices
+    * @param vertices The interleaved vertex data to reorder
+    * @param indices The triangle indices to remap
+    * @param componentCount The number of floats in each vertex
+    */
+    void OptimiseVertexFetch(std::vector<float>& vertices,
+                             std::vector<unsigned int>& indices,
+                             int componentCount);
+
+    /**
+    * Scores a vertex on how useful it is to use next
+    * @param cachePosition The position of the vertex in the cache or -1 if not cached
+    * @param remaining The number of triangles using the vertex not yet added
+    * @return the score of the vertex
+    */
+    static float ScoreVertex(int cachePosition, int remaining);
+
+private:
+
+    float m_acmrBefore = 0.0f;   ///< Average cache miss ratio before optimising
+    float m_acmrAfter = 0.0f;    ///< Average cache miss ratio after optimising
+};
\ No newline at end of file
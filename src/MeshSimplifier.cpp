@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - MeshSimplifier.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MeshSimplifier.h"
+
+#include <map>
+#include <tuple>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+namespace
+{
+    const double BOUNDARY_WEIGHT = 10.0;  ///< How strongly open edges keep their shape
+}
+
+void MeshSimplifier::Simplify(const std::vector<float>& vertices,
+                              int componentCount,
+                              const std::vector<unsigned int>& indices,
+                              int targetTriangles,
+                              std::vector<unsigned int>& output)
+{
+    m_vertices = &vertices;
+    m_componentCount = componentCount;
+    m_remap.resize(vertices.size() / componentCount);
+    WeldPositions();
+
+    output = indices;
+    std::vector<Collapse> collapses;
+    std::vector<bool> locked;
+
+    // Each pass collapses as many independent edges as possible, cheapest first
+    int triangles = static_cast<int>(output.size()) / 3;
+    while (triangles > targetTriangles)
+    {
+        GenerateQuadrics(output);
+        GenerateCollapses(output, collapses);
+        std::iota(m_remap.begin(), m_remap.end(), 0);
+        locked.assign(m_positions.size(), false);
+
+        bool collapsed = false;
+        for (const Collapse& collapse : collapses)
+        {
+            if (triangles <= targetTriangles)
+            {
+                break;
+            }
+
+            if (locked[collapse.from] || locked[collapse.to] || FlipsTriangles(output, collapse))
+            {
+                continue;
+            }
+
+            // Neighbours are locked so their triangles don't change again this pass
+            for (int t : m_groupTriangles[collapse.from])
+            {
+                bool removed = false;
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const int group = m_groups[output[t * 3 + corner]];
+                    locked[group] = true;
+                    removed |= group == collapse.to;
+                }
+                triangles -= removed ? 1 : 0;
+            }
+
+            RemapVertices(collapse);
+            collapsed = true;
+        }
+
+        if (!collapsed)
+        {
+            break;
+        }
+
+        // Triangles that shared the collapsed edge are now degenerate
+        unsigned int size = 0;
+        for (unsigned int i = 0; i < output.size(); i += 3)
+        {
+            const unsigned int a = m_remap[output[i]];
+            const unsigned int b = m_remap[output[i + 1]];
+            const unsigned int c = m_remap[output[i + 2]];
+
+            if (m_groups[a] != m_groups[b] &&
+                m_groups[b] != m_groups[c] &&
+                m_groups[a] != m_groups[c])
+            {
+                output[size++] = a;
+                output[size++] = b;
+                output[size++] = c;
+            }
+        }
+
+        output.resize(size);
+        triangles = static_cast<int>(output.size()) / 3;
+    }
+
+    m_vertices = nullptr;
+}
+
+void MeshSimplifier::WeldPositions()
+{
+    const auto& vertices = *m_vertices;
+    const int vertexCount = static_cast<int>(m_remap.size());
+
+    m_groups.resize(vertexCount);
+    m_positions.clear();
+    m_groupVertices.clear();
+
+    std::map<std::tuple<float, float, float>, int> welded;
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        const float* position = &vertices[v * m_componentCount];
+        const auto key = std::make_tuple(position[0], position[1], position[2]);
+        const auto added = welded.emplace(key, static_cast<int>(m_positions.size()));
+
+        if (added.second)
+        {
+            m_positions.emplace_back(position[0], position[1], position[2]);
+            m_groupVertices.emplace_back();
+        }
+
+        m_groups[v] = added.first->second;
+        m_groupVertices[m_groups[v]].push_back(v);
+    }
+}
+
+void MeshSimplifier::GenerateQuadrics(const std::vector<unsigned int>& indices)
+{
+    const int groupCount = static_cast<int>(m_positions.size());
+    m_quadrics.assign(groupCount, glm::dmat4(0.0));
+    m_groupTriangles.assign(groupCount, std::vector<int>());
+
+    std::map<std::pair<int, int>, int> edges;
+    for (unsigned int i = 0; i < indices.size(); i += 3)
+    {
+        const int t = i / 3;
+        const int groups[3] = { m_groups[indices[i]], m_groups[indices[i + 1]], m_groups[indices[i + 2]] };
+        const glm::vec3& p0 = m_positions[groups[0]];
+
+        const glm::dvec3 normal(glm::cross(m_positions[groups[1]] - p0, m_positions[groups[2]] - p0));
+        const double area = glm::length(normal);
+        if (area > 0.0)
+        {
+            const glm::dvec3 unit = normal / area;
+            const glm::dvec4 plane(unit, -glm::dot(unit, glm::dvec3(p0)));
+            const glm::dmat4 quadric = glm::outerProduct(plane, plane) * area;
+
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                m_quadrics[groups[corner]] += quadric;
+            }
+        }
+
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const int a = groups[corner];
+            const int b = groups[(corner + 1) % 3];
+            ++edges[std::make_pair(std::min(a, b), std::max(a, b))];
+            m_groupTriangles[a].push_back(t);
+        }
+    }
+
+    // Edges with a single triangle are open so are constrained by a perpendicular plane
+    for (unsigned int i = 0; i < indices.size(); i += 3)
+    {
+        const int groups[3] = { m_groups[indices[i]], m_groups[indices[i + 1]], m_groups[indices[i + 2]] };
+        const glm::vec3& p0 = m_positions[groups[0]];
+        const glm::dvec3 normal(glm::cross(m_positions[groups[1]] - p0, m_positions[groups[2]] - p0));
+
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const int a = groups[corner];
+            const int b = groups[(corner + 1) % 3];
+            if (edges[std::make_pair(std::min(a, b), std::max(a, b))] != 1)
+            {
+                continue;
+            }
+
+            const glm::dvec3 edge(m_positions[b] - m_positions[a]);
+            const glm::dvec3 perpendicular = glm::cross(edge, normal);
+            const double length = glm::length(perpendicular);
+            if (length > 0.0)
+            {
+                const glm::dvec3 unit = perpendicular / length;
+                const glm::dvec4 plane(unit, -glm::dot(unit, glm::dvec3(m_positions[a])));
+                const glm::dmat4 quadric = glm::outerProduct(plane, plane) *
+                    (BOUNDARY_WEIGHT * glm::dot(edge, edge));
+
+                m_quadrics[a] += quadric;
+                m_quadrics[b] += quadric;
+            }
+        }
+    }
+}
+
+void MeshSimplifier::GenerateCollapses(const std::vector<unsigned int>& indices,
+                                       std::vector<Collapse>& collapses) const
+{
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(indices.size());
+
+    for (unsigned int i = 0; i < indices.size(); i += 3)
+    {
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const int a = m_groups[indices[i + corner]];
+            const int b = m_groups[indices[i + (corner + 1) % 3]];
+            edges.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    collapses.clear();
+    for (const auto& edge : edges)
+    {
+        const glm::dmat4 quadric = m_quadrics[edge.first] + m_quadrics[edge.second];
+        const double toFirst = Error(quadric, m_positions[edge.first]);
+        const double toSecond = Error(quadric, m_positions[edge.second]);
+
+        Collapse collapse;
+        collapse.cost = std::min(toFirst, toSecond);
+        collapse.from = toFirst < toSecond ? edge.second : edge.first;
+        collapse.to = toFirst < toSecond ? edge.first : edge.second;
+        collapses.push_back(collapse);
+    }
+
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse& c1, const Collapse& c2)
+    {
+        return c1.cost < c2.cost;
+    });
+}
+
+bool MeshSimplifier::FlipsTriangles(const std::vector<unsigned int>& indices,
+                                    const Collapse& collapse) const
+{
+    for (int t : m_groupTriangles[collapse.from])
+    {
+        int groups[3] = { m_groups[indices[t * 3]], m_groups[indices[t * 3 + 1]], m_groups[indices[t * 3 + 2]] };
+        if (groups[0] == collapse.to || groups[1] == collapse.to || groups[2] == collapse.to)
+        {
+            continue;
+        }
+
+        const glm::vec3 before = glm::cross(
+            m_positions[groups[1]] - m_positions[groups[0]],
+            m_positions[groups[2]] - m_positions[groups[0]]);
+
+        for (int& group : groups)
+        {
+            group = group == collapse.from ? collapse.to : group;
+        }
+
+        const glm::vec3 after = glm::cross(
+            m_positions[groups[1]] - m_positions[groups[0]],
+            m_positions[groups[2]] - m_positions[groups[0]]);
+
+        if (glm::dot(before, after) <= 0.0f)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MeshSimplifier::RemapVertices(const Collapse& collapse)
+{
+    const auto& vertices = *m_vertices;
+    for (int from : m_groupVertices[collapse.from])
+    {
+        // Keeps uvs and normals as close as possible across seams
+        double closest = std::numeric_limits<double>::max();
+        for (int to : m_groupVertices[collapse.to])
+        {
+            double distance = 0.0;
+            for (int i = 3; i < m_componentCount; ++i)
+            {
+                const double difference = vertices[from * m_componentCount + i] -
+                    vertices[to * m_componentCount + i];
+                distance += difference * difference;
+            }
+
+            if (distance < closest)
+            {
+                closest = distance;
+                m_remap[from] = to;
+            }
+        }
+    }
+}
+
+double MeshSimplifier::Error(const glm::dmat4& quadric, const glm::vec3& position)
+{
+    const glm::dvec4 point(glm::dvec3(position), 1.0);
+    return glm::dot(point, quadric * point);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - MeshSimplifier.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <vector>
+
+/**
+* Reduces the triangles of a mesh by collapsing edges using quadric error metrics
+* Edges collapse onto existing vertices so the vertex buffer is shared between levels
+*/
+class MeshSimplifier
+{
+public:
+
+    /**
+    * Simplifies the triangles of a mesh
+    * @param vertices The interleaved vertex data with position first
+    * @param componentCount The number of floats in each vertex
+    * @param indices The triangle indices to simplify
+    * @param targetTriangles The number of triangles to reduce to
+    * @param output The simplified triangle indices
+    * @note stops before the target if no further collapses are possible
+    */
+    void Simplify(const std::vector<float>& vertices,
+                  int componentCount,
+                  const std::vector<unsigned int>& indices,
+                  int targetTriangles,
+                  std::vector<unsigned int>& output);
+
+private:
+
+    /**
+    * Edge that can be collapsed by moving one group onto another
+    */
+    struct Collapse
+    {
+        double cost = 0.0;   ///< Error introduced by the collapse
+        int from = 0;        ///< Group that is removed
+        int to = 0;          ///< Group that remains
+    };
+
+    /**
+    * Groups vertices which share a position so seams collapse together
+    */
+    void WeldPositions();
+
+    /**
+    * Sums the plane quadrics of each triangle and edge constraints for each group
+    * @param indices The current triangles
+    */
+    void GenerateQuadrics(const std::vector<unsigned int>& indices);
+
+    /**
+    * Determines the cost of collapsing every edge in the cheapest direction
+    * @param indices The current triangles
+    * @param collapses The edges sorted by cost
+    */
+    void GenerateCollapses(const std::vector<unsigned int>& indices,
+                           std::vector<Collapse>& collapses) const;
+
+    /**
+    * @return whether moving a group flips any of its triangles
+    * @param indices The current triangles
+    * @param collapse The edge to collapse
+    */
+    bool FlipsTriangles(const std::vector<unsigned int>& indices, const Collapse& collapse) const;
+
+    /**
+    * Maps each vertex of the removed group onto the vertex of the remaining group
+    * with the closest attributes
+    * @param collapse The edge being collapsed
+    */
+    void RemapVertices(const Collapse& collapse);
+
+    /**
+    * @return the error of the quadric at the position
+    */
+    static double Error(const glm::dmat4& quadric, const glm::vec3& position);
+
+private:
+
+    const std::vector<float>* m_vertices = nullptr;     ///< Vertex data being simplified
+    int m_componentCount = 0;                           ///< Number of floats in each vertex
+    std::vector<int> m_groups;                          ///< Position group of each vertex
+    std::vector<glm::vec3> m_positions;                 ///< Position of each group
+    std::vector<std::vector<int>> m_groupVertices;      ///< Vertices in each group
+    std::vector<std::vector<int>> m_groupTriangles;     ///< Current triangles using each group
+    std::vector<glm::dmat4> m_quadrics;                 ///< Error quadric of each group
+    std::vector<int> m_remap;                           ///< Vertex each vertex has collapsed onto
+};
\ No newline at end of file
@@ -0,0 +1,25 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - NullBackend.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "NullBackend.h"
+
+void NullBackend::Execute(const RenderCommandList& commands)
+{
+    m_counts.fill(0);
+    for (const auto& command : commands.Commands())
+    {
+        ++m_counts[command.type];
+    }
+    m_total = static_cast<int>(commands.Commands().size());
+}
+
+int NullBackend::Count(RenderCommandList::Type type) const
+{
+    return m_counts[type];
+}
+
+int NullBackend::Total() const
+{
+    return m_total;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - NullBackend.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "RenderCommandList.h"
+
+#include <array>
+
+/**
+* Backend which only counts commands, allowing recording to be measured
+* without an OpenGL context or any time spent in the driver
+*/
+class NullBackend : public RenderBackend
+{
+public:
+
+    /**
+    * Constructor
+    */
+    NullBackend() = default;
+
+    /**
+    * Counts the commands by type
+    * @param commands The commands to count
+    */
+    virtual void Execute(const RenderCommandList& commands) override;
+
+    /**
+    * @param type The type of command
+    * @return the number of commands of the type in the last execution
+    */
+    int Count(RenderCommandList::Type type) const;
+
+    /**
+    * @return the number of commands in the last execution
+    */
+    int Total() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    NullBackend(const NullBackend&) = delete;
+    NullBackend& operator=(const NullBackend&) = delete;
+
+private:
+
+    std::array<int, RenderCommandList::MAX_COMMANDS> m_counts = {};  ///< Commands of each type last executed
+    int m_total = 0;                                                 ///< Commands last executed
+};
\ No newline at end of file
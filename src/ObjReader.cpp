@@ -0,0 +1,432 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - ObjReader.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ObjReader.h"
+#include "MappedFile.h"
+
+#include <cmath>
+
+namespace
+{
+    const int INDEX_BITS = 21;                           ///< Bits for each index in a corner key
+    const int MAX_INDEX = (1 << INDEX_BITS) - 2;         ///< Largest index that fits in a corner key
+    const int POSITION_COMPONENTS = 3;
+    const int UV_COMPONENTS = 2;
+    const int NORMAL_COMPONENTS = 3;
+
+    /**
+    * @return whether the character separates values on a line
+    */
+    inline bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    /**
+    * Moves to the start of the next line
+    */
+    inline void SkipLine(const char*& itr, const char* end)
+    {
+        while (itr < end && *itr != '\n')
+        {
+            ++itr;
+        }
+        if (itr < end)
+        {
+            ++itr;
+        }
+    }
+
+    /**
+    * Moves past any spaces on the current line
+    */
+    inline void SkipSpaces(const char*& itr, const char* end)
+    {
+        while (itr < end && IsSpace(*itr))
+        {
+            ++itr;
+        }
+    }
+
+    /**
+    * Parses an integer with an optional sign
+    * @return whether any digits were read
+    */
+    inline bool ParseInt(const char*& itr, const char* end, int& value)
+    {
+        bool negative = false;
+        if (itr < end && (*itr == '-' || *itr == '+'))
+        {
+            negative = *itr == '-';
+            ++itr;
+        }
+
+        const char* start = itr;
+        value = 0;
+        while (itr < end && *itr >= '0' && *itr <= '9')
+        {
+            value = value * 10 + (*itr - '0');
+            ++itr;
+        }
+
+        value = negative ? -value : value;
+        return itr != start;
+    }
+
+    /**
+    * Parses a decimal number with optional sign, fraction and exponent
+    * @return whether any digits were read
+    */
+    inline bool ParseFloat(const char*& itr, const char* end, float& value)
+    {
+        SkipSpaces(itr, end);
+
+        bool negative = false;
+        if (itr < end && (*itr == '-' || *itr == '+'))
+        {
+            negative = *itr == '-';
+            ++itr;
+        }
+
+        const char* start = itr;
+        double number = 0.0;
+        while (itr < end && *itr >= '0' && *itr <= '9')
+        {
+            number = number * 10.0 + (*itr - '0');
+            ++itr;
+        }
+
+        if (itr < end && *itr == '.')
+        {
+            ++itr;
+            double scale = 0.1;
+            while (itr < end && *itr >= '0' && *itr <= '9')
+            {
+                number += (*itr - '0') * scale;
+                scale *= 0.1;
+                ++itr;
+            }
+        }
+
+        if (itr == start)
+        {
+            return false;
+        }
+
+        if (itr < end && (*itr == 'e' || *itr == 'E'))
+        {
+            ++itr;
+            int exponent = 0;
+            if (ParseInt(itr, end, exponent))
+            {
+                number *= std::pow(10.0, exponent);
+            }
+        }
+
+        value = static_cast<float>(negative ? -number : number);
+        return true;
+    }
+
+    /**
+    * Converts a one-based or negative relative OBJ index into a zero-based index
+    * @return whether the index refers to an existing element
+    */
+    inline bool ResolveIndex(int index, int count, int& resolved)
+    {
+        resolved = index > 0 ? index - 1 : count + index;
+        return index != 0 && resolved >= 0 && resolved < count;
+    }
+}
+
+const std::string& ObjReader::GetError() const
+{
+    return m_error;
+}
+
+bool ObjReader::Read(const std::string& path,
+                     bool requiresUVs,
+                     bool requiresNormals,
+                     std::vector<float>& vertices,
+                     std::vector<unsigned int>& indices,
+                     int& componentCount)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        m_error = "Could not open file";
+        return false;
+    }
+
+    m_requiresUVs = requiresUVs;
+    m_requiresNormals = requiresNormals;
+    m_generateNormals = false;
+    m_componentCount = POSITION_COMPONENTS +
+        (requiresUVs ? UV_COMPONENTS : 0) +
+        (requiresNormals ? NORMAL_COMPONENTS : 0);
+
+    m_vertices = &vertices;
+    m_indices = &indices;
+    m_positions.clear();
+    m_uvs.clear();
+    m_normals.clear();
+    m_vertexPositions.clear();
+    m_added.clear();
+    m_error.clear();
+
+    vertices.clear();
+    indices.clear();
+
+    const bool success = Parse(file.Data(), file.Data() + file.Size());
+    if (success)
+    {
+        if (m_generateNormals)
+        {
+            GenerateNormals();
+        }
+        componentCount = m_componentCount;
+    }
+
+    m_vertices = nullptr;
+    m_indices = nullptr;
+    return success;
+}
+
+bool ObjReader::Parse(const char* begin, const char* end)
+{
+    const char* itr = begin;
+    while (itr < end)
+    {
+        SkipSpaces(itr, end);
+        if (itr + 1 >= end)
+        {
+            break;
+        }
+
+        const char type = itr[0];
+        const char next = itr[1];
+
+        if (type == 'v' && IsSpace(next))
+        {
+            glm::vec3 position;
+            itr += 2;
+            if (!ParseFloat(itr, end, position.x) ||
+                !ParseFloat(itr, end, position.y) ||
+                !ParseFloat(itr, end, position.z))
+            {
+                m_error = "Invalid position";
+                return false;
+            }
+            m_positions.push_back(position);
+        }
+        else if (type == 'v' && next == 't')
+        {
+            glm::vec2 uv;
+            itr += 2;
+            if (!ParseFloat(itr, end, uv.x) || !ParseFloat(itr, end, uv.y))
+            {
+                m_error = "Invalid texture coordinate";
+                return false;
+            }
+            m_uvs.push_back(uv);
+        }
+        else if (type == 'v' && next == 'n')
+        {
+            glm::vec3 normal;
+            itr += 2;
+            if (!ParseFloat(itr, end, normal.x) ||
+                !ParseFloat(itr, end, normal.y) ||
+                !ParseFloat(itr, end, normal.z))
+            {
+                m_error = "Invalid normal";
+                return false;
+            }
+            m_normals.push_back(normal);
+        }
+        else if (type == 'f' && IsSpace(next))
+        {
+            if (m_indices->empty())
+            {
+                // All elements are declared before the faces in the bundled meshes
+                const size_t estimate = m_positions.size() * 2;
+                m_vertices->reserve(estimate * m_componentCount);
+                m_vertexPositions.reserve(estimate);
+                m_added.reserve(estimate);
+            }
+
+            ++itr;
+            if (!ParseFace(itr, end))
+            {
+                return false;
+            }
+        }
+
+        // Comments, groups, materials and smoothing groups are not required
+        SkipLine(itr, end);
+    }
+
+    if (m_indices->empty())
+    {
+        m_error = "No faces found";
+        return false;
+    }
+    return true;
+}
+
+bool ObjReader::ParseFace(const char*& itr, const char* end)
+{
+    const int positions = static_cast<int>(m_positions.size());
+    const int uvs = static_cast<int>(m_uvs.size());
+    const int normals = static_cast<int>(m_normals.size());
+
+    if (positions > MAX_INDEX || uvs > MAX_INDEX || normals > MAX_INDEX)
+    {
+        m_error = "Too many elements";
+        return false;
+    }
+
+    m_corners.clear();
+    SkipSpaces(itr, end);
+
+    while (itr < end && *itr != '\n')
+    {
+        Corner corner;
+        int index = 0;
+
+        if (!ParseInt(itr, end, index) || !ResolveIndex(index, positions, corner.position))
+        {
+            m_error = "Invalid face position";
+            return false;
+        }
+
+        if (itr < end && *itr == '/')
+        {
+            ++itr;
+            if (itr < end && *itr != '/' && ParseInt(itr, end, index) &&
+                !ResolveIndex(index, uvs, corner.uv))
+            {
+                m_error = "Invalid face texture coordinate";
+                return false;
+            }
+
+            if (itr < end && *itr == '/')
+            {
+                ++itr;
+                if (ParseInt(itr, end, index) && !ResolveIndex(index, normals, corner.normal))
+                {
+                    m_error = "Invalid face normal";
+                    return false;
+                }
+            }
+        }
+
+        if (m_requiresUVs && corner.uv < 0)
+        {
+            m_error = "Requires uvs";
+            return false;
+        }
+
+        m_generateNormals |= m_requiresNormals && corner.normal < 0;
+        m_corners.push_back(corner);
+        SkipSpaces(itr, end);
+    }
+
+    if (m_corners.size() < 3)
+    {
+        m_error = "Face has less than three corners";
+        return false;
+    }
+
+    // Polygons are split into a triangle fan
+    const unsigned int first = AddVertex(m_corners[0]);
+    unsigned int previous = AddVertex(m_corners[1]);
+    for (unsigned int i = 2; i < m_corners.size(); ++i)
+    {
+        const unsigned int current = AddVertex(m_corners[i]);
+        m_indices->push_back(first);
+        m_indices->push_back(previous);
+        m_indices->push_back(current);
+        previous = current;
+    }
+
+    return true;
+}
+
+unsigned int ObjReader::AddVertex(const Corner& corner)
+{
+    // Only the components that are used decide whether a corner is unique
+    const uint64_t uv = m_requiresUVs ? corner.uv + 1 : 0;
+    const uint64_t normal = m_requiresNormals ? corner.normal + 1 : 0;
+    const uint64_t key = static_cast<uint64_t>(corner.position) |
+        (uv << INDEX_BITS) | (normal << (INDEX_BITS * 2));
+
+    const unsigned int next = static_cast<unsigned int>(m_vertexPositions.size());
+    const auto added = m_added.emplace(key, next);
+    if (!added.second)
+    {
+        return added.first->second;
+    }
+
+    auto& vertices = *m_vertices;
+    const glm::vec3& position = m_positions[corner.position];
+    vertices.push_back(position.x);
+    vertices.push_back(position.y);
+    vertices.push_back(position.z);
+
+    if (m_requiresUVs)
+    {
+        const glm::vec2& coordinate = m_uvs[corner.uv];
+        vertices.push_back(coordinate.x);
+        vertices.push_back(coordinate.y);
+    }
+
+    if (m_requiresNormals)
+    {
+        const glm::vec3 direction = corner.normal >= 0 ?
+            m_normals[corner.normal] : glm::vec3(0, 0, 0);
+        vertices.push_back(direction.x);
+        vertices.push_back(direction.y);
+        vertices.push_back(direction.z);
+    }
+
+    m_vertexPositions.push_back(corner.position);
+    return next;
+}
+
+void ObjReader::GenerateNormals()
+{
+    auto& vertices = *m_vertices;
+    const auto& indices = *m_indices;
+    const int normalOffset = POSITION_COMPONENTS + (m_requiresUVs ? UV_COMPONENTS : 0);
+
+    // Vertices sharing a position are smoothed together
+    std::vector<glm::vec3> smoothed(m_positions.size(), glm::vec3(0, 0, 0));
+    for (unsigned int i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const int a = m_vertexPositions[indices[i]];
+        const int b = m_vertexPositions[indices[i + 1]];
+        const int c = m_vertexPositions[indices[i + 2]];
+
+        const glm::vec3 normal = glm::cross(
+            m_positions[b] - m_positions[a],
+            m_positions[c] - m_positions[a]);
+
+        smoothed[a] += normal;
+        smoothed[b] += normal;
+        smoothed[c] += normal;
+    }
+
+    for (unsigned int vertex = 0; vertex < m_vertexPositions.size(); ++vertex)
+    {
+        float* normal = &vertices[vertex * m_componentCount + normalOffset];
+        if (normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 0.0f)
+        {
+            const glm::vec3& direction = smoothed[m_vertexPositions[vertex]];
+            const float length = glm::length(direction);
+            const glm::vec3 unit = length > 0.0f ? direction / length : glm::vec3(0, 1, 0);
+            normal[0] = unit.x;
+            normal[1] = unit.y;
+            normal[2] = unit.z;
+        }
+    }
+}
\ No newline at end of file
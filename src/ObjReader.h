@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - ObjReader.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+* Single pass reader for Wavefront OBJ files
+* Produces interleaved position/uv/normal vertices with identical corners shared
+*/
+class ObjReader
+{
+public:
+
+    /**
+    * Reads an OBJ file
+    * @param path The full path to the OBJ file
+    * @param requiresUVs Whether each vertex requires UVs
+    * @param requiresNormals Whether each vertex requires normals
+    * @param vertices The interleaved vertex data to fill
+    * @param indices The triangle indices to fill
+    * @param componentCount The number of floats in each vertex
+    * @return whether reading was successful
+    */
+    bool Read(const std::string& path,
+              bool requiresUVs,
+              bool requiresNormals,
+              std::vector<float>& vertices,
+              std::vector<unsigned int>& indices,
+              int& componentCount);
+
+    /**
+    * @return the reason the last read failed
+    */
+    const std::string& GetError() const;
+
+private:
+
+    /**
+    * Indices of a face corner into the position, uv and normal lists
+    */
+    struct Corner
+    {
+        int position = -1;
+        int uv = -1;
+        int normal = -1;
+    };
+
+    /**
+    * Parses the text of an OBJ file
+    * @return whether parsing was successful
+    */
+    bool Parse(const char* begin, const char* end);
+
+    /**
+    * Parses a face and adds it as a triangle fan
+    * @return whether parsing was successful
+    */
+    bool ParseFace(const char*& itr, const char* end);
+
+    /**
+    * Adds the vertex for a face corner if not already added
+    * @return the index of the vertex
+    */
+    unsigned int AddVertex(const Corner& corner);
+
+    /**
+    * Averages the face normals surrounding each position
+    * Used when normals are required but not contained in the file
+    */
+    void GenerateNormals();
+
+private:
+
+    bool m_requiresUVs = false;                          ///< Whether each vertex requires UVs
+    bool m_requiresNormals = false;                      ///< Whether each vertex requires normals
+    bool m_generateNormals = false;                      ///< Whether normals are missing from the file
+    int m_componentCount = 0;                            ///< Number of floats in each vertex
+    std::vector<float>* m_vertices = nullptr;            ///< Vertex data being filled
+    std::vector<unsigned int>* m_indices = nullptr;      ///< Index data being filled
+    std::vector<glm::vec3> m_positions;                  ///< Positions read from the file
+    std::vector<glm::vec2> m_uvs;                        ///< Texture coordinates read from the file
+    std::vector<glm::vec3> m_normals;                    ///< Normals read from the file
+    std::vector<int> m_vertexPositions;                  ///< Position index for each vertex added
+    std::vector<Corner> m_corners;                       ///< Corners of the face being parsed
+    std::unordered_map<uint64_t, unsigned int> m_added;  ///< Vertex index for each unique corner
+    std::string m_error;                                 ///< Reason the last read failed
+};
\ No newline at end of file
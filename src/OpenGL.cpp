@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - OpenGL.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OpenGL.h"
+
+#include <atomic>
+
+namespace
+{
+    std::atomic<int> driverErrors(0);           ///< Driver errors since the count was last taken
+    bool debugOutput = false;                   ///< Whether the debug callback is installed
+    bool callChecking = GL_CALL_CHECKS != 0;    ///< Whether each call is checked with glGetError
+
+    const GLuint UNKNOWN_TEXTURE = ~0u;         ///< Binding which must always be replaced
+    const int MAX_TEXTURE_UNITS = 16;           ///< Texture units tracked by the cache
+    const GLenum TEXTURE_TYPES[] =              ///< Texture types tracked by the cache
+    {
+        GL_TEXTURE_2D,
+        GL_TEXTURE_2D_MULTISAMPLE,
+        GL_TEXTURE_2D_ARRAY,
+        GL_TEXTURE_CUBE_MAP
+    };
+    const int TEXTURE_TYPE_COUNT = sizeof(TEXTURE_TYPES) / sizeof(TEXTURE_TYPES[0]);
+
+    GLuint boundTextures[MAX_TEXTURE_UNITS][TEXTURE_TYPE_COUNT] = {}; ///< Texture bound to each unit
+    int activeUnit = 0;                         ///< Texture unit currently active
+    int textureBinds = 0;                       ///< Textures bound since the count was last taken
+
+    /**
+    * Receives messages from the driver
+    * @note may be called from a driver thread when output is not synchronous
+    */
+    void APIENTRY DebugCallback(GLenum /*source*/,
+                                GLenum type,
+                                GLuint id,
+                                GLenum /*severity*/,
+                                GLsizei /*length*/,
+                                const GLchar* message,
+                                const void* /*userParam*/)
+    {
+        const std::string description = 
+            "OpenGL: " + std::string(message) + " (" + std::to_string(id) + ")";
+
+        if (type == GL_DEBUG_TYPE_ERROR)
+        {
+            ++driverErrors;
+            LogError(description);
+        }
+        else
+        {
+            LogInfo(description);
+        }
+    }
+}
+
+bool InitialiseDebugOutput()
+{
+    if (!glDebugMessageCallback || !glDebugMessageControl)
+    {
+        LogInfo("OpenGL: Debug output not supported");
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+
+    // Synchronous output reports errors on the call that caused them but is slower
+    if (GL_CALL_CHECKS)
+    {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    else
+    {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+
+    glDebugMessageCallback(DebugCallback, nullptr);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE,
+        GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+
+    // The callback already reports every error so per-call checks are redundant
+    debugOutput = true;
+    callChecking = false;
+    return true;
+}
+
+int TakeDriverErrorCount()
+{
+    return driverErrors.exchange(0);
+}
+
+void SetCallChecking(bool enabled)
+{
+    callChecking = enabled && GL_CALL_CHECKS;
+}
+
+bool IsCallChecking()
+{
+    return callChecking;
+}
+
+bool BindTexture(int unit, GLenum type, GLuint id)
+{
+    int typeIndex = 0;
+    while (typeIndex < TEXTURE_TYPE_COUNT && TEXTURE_TYPES[typeIndex] != type)
+    {
+        ++typeIndex;
+    }
+
+    // Units and types outside of the cache are always bound
+    GLuint* bound = unit < MAX_TEXTURE_UNITS && typeIndex < TEXTURE_TYPE_COUNT ?
+        &boundTextures[unit][typeIndex] : nullptr;
+
+    if (bound && *bound == id)
+    {
+        return false;
+    }
+
+    if (activeUnit != unit)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+
+    glBindTexture(type, id);
+    ++textureBinds;
+
+    if (bound)
+    {
+        *bound = id;
+    }
+    return true;
+}
+
+void ForgetTextureBinding(GLuint id)
+{
+    for (auto& unit : boundTextures)
+    {
+        for (GLuint& texture : unit)
+        {
+            texture = texture == id ? 0 : texture;
+        }
+    }
+}
+
+void ResetTextureBindings()
+{
+    for (auto& unit : boundTextures)
+    {
+        for (GLuint& texture : unit)
+        {
+            texture = UNKNOWN_TEXTURE;
+        }
+    }
+    activeUnit = -1;
+}
+
+int TakeTextureBindCount()
+{
+    const int binds = textureBinds;
+    textureBinds = 0;
+    return binds;
+}
+
+#if GL_CALL_CHECKS
+
+bool HasCallFailed()
+{
+    if (!callChecking)
+    {
+        return false;
+    }
+
+    const GLenum error = glGetError();
+    if (error == GL_NO_ERROR)
+    {
+        return false;
+    }
+
+    // Errors are already counted by the callback when it is installed
+    if (!debugOutput)
+    {
+        ++driverErrors;
+    }
+
+    switch(error)
+    {
+    case GL_INVALID_VALUE:
+        LogError("OpenGL: Invalid Value");
+        return true;
+    case GL_INVALID_OPERATION:
+        LogError("OpenGL: Invalid Operation");
+        return true;
+    default:
+        LogError("OpenGL: Unknown Error");
+        return true;
+    }
+}
+
+#endif
\ No newline at end of file
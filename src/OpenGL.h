@@ -10,30 +10,108 @@
 #include "glm/glm.hpp"
 #include "logger.h"
 
+#include <cstdint>
+
 const int MULTISAMPLING_COUNT = 4;
 const int SCENE_TEXTURES = 2;
 const int ID_COLOUR = 0;
 const int ID_NORMAL = 1;
+const int INSTANCE_BINDING = 0;
+const int FRAME_BINDING = 1;
+const int LAYER_BINDING = 2;
+
+/**
+* Per-call glGetError checking forces a round trip to the driver so is
+* compiled out of release builds, where errors come from the debug callback
+*/
+#ifndef GL_CALL_CHECKS
+#ifdef NDEBUG
+#define GL_CALL_CHECKS 0
+#else
+#define GL_CALL_CHECKS 1
+#endif
+#endif
+
+/**
+* Routes driver errors and warnings through the KHR_debug callback
+* @return whether the callback could be installed
+* @note requires an OpenGL context to be created
+*/
+bool InitialiseDebugOutput();
+
+/**
+* @return the number of driver errors since the last call
+*/
+int TakeDriverErrorCount();
+
+/**
+* Sets whether each call is checked with glGetError
+* @note only has an effect in builds with GL_CALL_CHECKS
+*/
+void SetCallChecking(bool enabled);
+
+/**
+* @return whether each call is checked with glGetError
+*/
+bool IsCallChecking();
+
+/**
+* Binds a texture to a texture unit unless it is already bound there
+* The binding of each unit is cached across shaders so switching shader
+* doesn't require the textures to be sent again
+* @param unit The index of the texture unit
+* @param type The type of texture to bind
+* @param id The unique ID of the texture
+* @return whether the texture needed binding
+* @note the cache is not locked so must only be used on the context thread
+*/
+bool BindTexture(int unit, GLenum type, GLuint id);
+
+/**
+* Updates the cache for a deleted texture, which OpenGL unbinds from every unit
+* @param id The unique ID of the texture being deleted
+*/
+void ForgetTextureBinding(GLuint id);
+
+/**
+* Forgets the cached texture bindings
+* @note required after anything outside of the engine has bound textures
+*/
+void ResetTextureBindings();
+
+/**
+* @return the number of textures bound since the last call
+*/
+int TakeTextureBindCount();
+
+/**
+* Converts a byte offset into the bound buffer to the pointer OpenGL expects
+* @param offset The offset in bytes from the start of the buffer
+* @return the offset as a pointer argument
+*/
+inline const void* BufferOffset(std::uintptr_t offset)
+{
+    return reinterpret_cast<const void*>(offset);
+}
+
+#if GL_CALL_CHECKS
 
 /**
 * OpenGL call checking
 * @return whether the last call to OpenGL has failed
 * @note requires an OpenGL context to be created
 */
+bool HasCallFailed();
+
+#else
+
+/**
+* OpenGL call checking is compiled out
+* @return false as errors are reported through the debug callback
+*/
 inline bool HasCallFailed()
 {
-    switch(glGetError())
-    {
-    case GL_NO_ERROR:
-        return false;
-    case GL_INVALID_VALUE:
-        LogError("OpenGL: Invalid Value");
-        return true;
-    case GL_INVALID_OPERATION:
-        LogError("OpenGL: Invalid Operation");
-        return true;
-    default:
-        LogError("OpenGL: Unknown Error");
-        return true;
-    }
+    return false;
 }
+
+#endif
\ No newline at end of file
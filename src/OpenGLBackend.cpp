@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - OpenGLBackend.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OpenGLBackend.h"
+#include "RenderCommandList.h"
+#include "IndirectRenderer.h"
+#include "StreamBuffer.h"
+#include "SceneData.h"
+
+namespace
+{
+    const char* MATRIX_NAMES[RenderCommandList::MAX_MATRICES] =
+    {
+        "world"
+    };
+}
+
+OpenGLBackend::OpenGLBackend(const SceneData& scene)
+    : m_scene(scene)
+{
+}
+
+void OpenGLBackend::SetBuffers(StreamBuffer* stream, IndirectRenderer* indirect)
+{
+    m_stream = stream;
+    m_indirect = indirect;
+}
+
+void OpenGLBackend::Execute(const RenderCommandList& commands)
+{
+    // Recording starts each list by setting a shader so none is carried over
+    m_shader = nullptr;
+
+    for (const auto& command : commands.Commands())
+    {
+        switch (command.type)
+        {
+        case RenderCommandList::SET_SHADER:
+            m_shader = m_scene.shaders[command.value].get();
+            m_shader->SetActive();
+            break;
+        case RenderCommandList::SET_STATE:
+            SetState(command.value);
+            break;
+        case RenderCommandList::SEND_MATRIX:
+            m_shader->SendUniform(MATRIX_NAMES[command.value], commands.GetMatrix(command.count));
+            break;
+        case RenderCommandList::SEND_FRAME_CONSTANTS:
+            SendFrameConstants(commands.GetFrameConstants(command.count));
+            break;
+        case RenderCommandList::SEND_LIGHTS:
+            SendLights(commands, command.value, command.count);
+            break;
+        case RenderCommandList::SEND_TEXTURE:
+            SendTexture(*m_scene.textures[command.value]);
+            break;
+        case RenderCommandList::BIND_MESH:
+            command.mesh->PreRender(m_shader->AttributeMask());
+            m_shader->EnableShader();
+            break;
+        case RenderCommandList::BIND_UNIFORM_BLOCK:
+            glBindBufferRange(GL_UNIFORM_BUFFER, command.value, 
+                m_stream->GetID(), command.offset, command.bytes);
+            break;
+        case RenderCommandList::BIND_STORAGE_BLOCK:
+            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, command.value, 
+                m_stream->GetID(), command.offset, command.bytes);
+            break;
+        case RenderCommandList::BIND_INDIRECT:
+            m_indirect->Bind(*m_stream, command.count);
+            m_shader->EnableShader();
+            break;
+        case RenderCommandList::DRAW:
+            command.mesh->Render(command.value);
+            break;
+        case RenderCommandList::DRAW_INSTANCED:
+            command.mesh->RenderInstanced(command.count, command.value);
+            break;
+        case RenderCommandList::DRAW_INDIRECT:
+            m_indirect->Submit(command.offset, command.count);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (HasCallFailed())
+    {
+        LogError("OpenGL: Failed to execute render commands");
+    }
+}
+
+void OpenGLBackend::SetState(int state)
+{
+    const bool backfaceCull = (state & RenderCommandList::BACKFACE_CULL) != 0;
+    if (backfaceCull != m_isBackfaceCull)
+    {
+        m_isBackfaceCull = backfaceCull;
+        backfaceCull ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+    }
+
+    const bool alphaBlend = (state & RenderCommandList::ALPHA_BLEND) != 0;
+    if (alphaBlend != m_isAlphaBlend)
+    {
+        m_isAlphaBlend = alphaBlend;
+        alphaBlend ? glEnablei(GL_BLEND, 0) : glDisablei(GL_BLEND, 0);
+        alphaBlend ? glEnablei(GL_BLEND, 1) : glDisablei(GL_BLEND, 1);
+    }
+
+    const bool depthWrite = (state & RenderCommandList::DEPTH_WRITE) != 0;
+    if (depthWrite != m_isDepthWrite)
+    {
+        m_isDepthWrite = depthWrite;
+        glDepthMask(depthWrite ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void OpenGLBackend::Release()
+{
+    if (m_frameBuffer != 0)
+    {
+        glDeleteBuffers(1, &m_frameBuffer);
+        m_frameBuffer = 0;
+    }
+}
+
+void OpenGLBackend::SendFrameConstants(const RenderCommandList::FrameConstants& constants)
+{
+    if (m_frameBuffer == 0)
+    {
+        glGenBuffers(1, &m_frameBuffer);
+    }
+
+    // Orphaned each frame so the driver doesn't wait on the previous contents
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(constants), &constants, GL_STREAM_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, m_frameBuffer);
+}
+
+void OpenGLBackend::SendLights(const RenderCommandList& commands, int first, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const glm::vec3* light = commands.GetLight(first + i);
+        const int offset = i * 3;
+        m_shader->SendUniform("lightPosition", light[0], offset);
+        m_shader->SendUniform("lightDiffuse", light[1], offset);
+    }
+}
+
+void OpenGLBackend::SendTexture(const Texture& texture)
+{
+    m_shader->SendTexture("DiffuseSampler", texture);
+    if (texture.IsPacked())
+    {
+        m_shader->SendUniform("diffuseLayer", static_cast<float>(texture.Layer()));
+    }
+}
\ No newline at end of file
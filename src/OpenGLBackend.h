@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - OpenGLBackend.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "RenderCommandList.h"
+
+struct SceneData;
+class Shader;
+class Texture;
+class StreamBuffer;
+class IndirectRenderer;
+
+/**
+* Backend which executes commands through OpenGL
+* Holds the render states so redundant changes never reach the driver
+*/
+class OpenGLBackend : public RenderBackend
+{
+public:
+
+    /**
+    * Constructor
+    * @param scene The shaders, textures and lights the commands refer to
+    */
+    OpenGLBackend(const SceneData& scene);
+
+    /**
+    * Sets the buffers read by stream and indirect commands
+    * @param stream The buffer holding the streamed ranges or null if not supported
+    * @param indirect The renderer drawing indirect commands or null if not supported
+    */
+    void SetBuffers(StreamBuffer* stream, IndirectRenderer* indirect);
+
+    /**
+    * Releases the buffer used to send the frame constants
+    * @note requires the context to be current
+    */
+    void Release();
+
+    /**
+    * Executes the commands through OpenGL
+    * @param commands The commands to execute
+    */
+    virtual void Execute(const RenderCommandList& commands) override;
+
+    /**
+    * Sets the render states, only changing those which differ
+    * @param state The combination of RenderCommandList::State flags to enable
+    */
+    void SetState(int state);
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    OpenGLBackend(const OpenGLBackend&) = delete;
+    OpenGLBackend& operator=(const OpenGLBackend&) = delete;
+
+    /**
+    * Sends the frame constants to every shader through the backend's own buffer
+    * @param constants The values to send
+    */
+    void SendFrameConstants(const RenderCommandList::FrameConstants& constants);
+
+    /**
+    * Sends the lights captured by a command to the active shader
+    * @param commands The list holding the captured lights
+    * @param first The index of the first light captured by the command
+    * @param count The number of lights captured by the command
+    */
+    void SendLights(const RenderCommandList& commands, int first, int count);
+
+    /**
+    * Sends the diffuse texture to the active shader
+    * @param texture The texture to send, which may be a layer of a texture array
+    */
+    void SendTexture(const Texture& texture);
+
+private:
+
+    const SceneData& m_scene;                  ///< The data the commands refer to
+    StreamBuffer* m_stream = nullptr;          ///< Buffer holding the streamed ranges
+    IndirectRenderer* m_indirect = nullptr;    ///< Renderer drawing indirect commands
+    Shader* m_shader = nullptr;                ///< Shader the commands are sent to
+    GLuint m_frameBuffer = 0;                  ///< Holds the frame constants when they aren't streamed
+    bool m_isBackfaceCull = true;              ///< Whether the culling rasterize state is active
+    bool m_isAlphaBlend = false;               ///< Whether alpha blending is currently active
+    bool m_isDepthWrite = true;                ///< Whether writing to the depth buffer is active
+};
\ No newline at end of file
@@ -3,22 +3,65 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #include "OpenGLEngine.h"
-#include "Camera.h"
 #include "Quad.h"
 #include "SceneData.h"
+#include "RenderSnapshot.h"
 #include "Rendertarget.h"
-#include "GlmHelper.h"
+#include "IndirectRenderer.h"
+#include "StreamBuffer.h"
+#include "RenderCommandList.h"
+#include "RenderQueue.h"
+#include "SceneRecorder.h"
+#include "OpenGLBackend.h"
+#include "NullBackend.h"
+#include "GpuTimer.h"
+#include "ResolutionScaler.h"
+#include "HeadlessContext.h"
+#include "PngWriter.h"
 #include "Utils.h"
+#include "Tweaker.h"
+
+#include <algorithm>
 
 namespace
 {
-    const int NO_INDEX = -1;
+    const GLsizeiptr STREAM_FRAME_SIZE = 4 * 1024 * 1024; ///< Bytes of dynamic data each frame can write
+    const int MAX_FRAMES_IN_FLIGHT = 8;              ///< Each frame adds a stream region of the size above
+    const float TOONLINE_SCALE = 0.5f;               ///< Resolution of the toon line pass relative to the window
+
+    /**
+    * Settings trading FXAA quality for speed
+    */
+    struct FxaaPreset
+    {
+        float spanMax;           ///< Furthest distance in pixels to search along an edge
+        float reduceMul;         ///< Shortens the search on bright edges
+        float reduceMin;         ///< Shortest reduction of the search
+        float edgeThreshold;     ///< Contrast relative to the brightest sample needed to be an edge
+        float edgeThresholdMin;  ///< Contrast needed to be an edge in dark areas
+    };
+
+    const FxaaPreset FXAA_PRESETS[] =
+    {
+        { 4.0f, 1.0f / 4.0f, 1.0f / 64.0f, 0.25f, 0.0833f },     // Low
+        { 8.0f, 1.0f / 8.0f, 1.0f / 128.0f, 0.166f, 0.0625f },   // Medium
+        { 16.0f, 1.0f / 16.0f, 1.0f / 128.0f, 0.125f, 0.0312f }  // High
+    };
+
+    const int FXAA_PRESET_COUNT = sizeof(FXAA_PRESETS) / sizeof(FXAA_PRESETS[0]);
 }
 
-OpenGLEngine::OpenGLEngine(const SceneData& scene, const Camera& camera)
-    : m_camera(camera)
+OpenGLEngine::OpenGLEngine(const SceneData& scene, bool headless)
+    : m_headless(headless)
     , m_scene(scene)
+    , m_windowWidth(WINDOW_WIDTH)
+    , m_windowHeight(WINDOW_HEIGHT)
     , m_quad(std::make_unique<Quad>("PostQuad"))
+    , m_resolution(std::make_unique<ResolutionScaler>())
+    , m_commands(std::make_unique<RenderCommandList>())
+    , m_recorder(std::make_unique<SceneRecorder>(scene))
+    , m_openGLBackend(std::make_unique<OpenGLBackend>(scene))
+    , m_nullBackend(std::make_unique<NullBackend>())
 {
 }
 
@@ -31,9 +74,26 @@ void OpenGLEngine::Release()
 {
     // All resources must be destroyed before the engine
     m_quad.reset();
+    m_recorder->SetBuffers(nullptr, nullptr);
+    m_openGLBackend->SetBuffers(nullptr, nullptr);
+    m_openGLBackend->Release();
+    m_queue.reset();
+    m_indirect.reset();
+    m_stream.reset();
+    m_postTimer.reset();
+    m_sceneTimer.reset();
+    m_postTarget.reset();
+    m_toonlineTarget.reset();
+    m_resolveTarget.reset();
     m_sceneTarget.reset();
     m_backBuffer.reset();
 
+    if (m_headless)
+    {
+        m_headlessContext.reset();
+        return;
+    }
+
     if (m_window)
     {
         glfwDestroyWindow(m_window);
@@ -45,11 +105,11 @@ void OpenGLEngine::Release()
 
 bool OpenGLEngine::IsRunning() const
 {
-    return !glfwWindowShouldClose(m_window) && 
-          glfwGetKey(m_window, GLFW_KEY_ESCAPE) != GLFW_PRESS;
+    return m_headless || (!glfwWindowShouldClose(m_window) && 
+          glfwGetKey(m_window, GLFW_KEY_ESCAPE) != GLFW_PRESS);
 }
 
-bool OpenGLEngine::Initialise()
+bool OpenGLEngine::InitialiseWindow()
 {
     if (!glfwInit())
     {
@@ -57,6 +117,10 @@ bool OpenGLEngine::Initialise()
         return false;
     }
 
+    // Debug contexts report more through the debug callback but may be slower
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_CALL_CHECKS ? GL_TRUE : GL_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GL_TRUE);
+
     m_window = glfwCreateWindow(WINDOW_WIDTH, 
         WINDOW_HEIGHT, "Tiny Toon Tanks", nullptr, nullptr);
 
@@ -67,6 +131,26 @@ bool OpenGLEngine::Initialise()
     }
 
     glfwMakeContextCurrent(m_window);
+    glfwGetFramebufferSize(m_window, &m_windowWidth, &m_windowHeight);
+    return true;
+}
+
+bool OpenGLEngine::Initialise()
+{
+    if (m_headless)
+    {
+        // Frames are compared between runs so are always rendered at full resolution
+        m_headlessContext = std::make_unique<HeadlessContext>();
+        m_resolution->SetEnabled(false);
+        if (!m_headlessContext->Initialise())
+        {
+            return false;
+        }
+    }
+    else if (!InitialiseWindow())
+    {
+        return false;
+    }
 
     if(ogl_LoadFunctions() == ogl_LOAD_FAILED) 
     {
@@ -74,8 +158,12 @@ bool OpenGLEngine::Initialise()
         return false;
     }
 
+    // Without the callback errors are only found through per-call checking
+    InitialiseDebugOutput();
+    m_callChecking = IsCallChecking();
+
     glClearColor(0.24f, 0.24f, 0.24f, 1.0f);
-    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glViewport(0, 0, m_windowWidth, m_windowHeight);
     glClearDepth(1.0f);
     glDepthFunc(GL_LEQUAL);
     glDepthRange(0.0f, 1.0f);
@@ -85,10 +173,12 @@ bool OpenGLEngine::Initialise()
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
     glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
 
-    m_backBuffer = std::make_unique<RenderTarget>("BackBuffer");
-    m_sceneTarget = std::make_unique<RenderTarget>("Scene", SCENE_TEXTURES, true);
+    // Without a window there's no default framebuffer so the frame ends in a texture
+    m_backBuffer = m_headless ? 
+        std::make_unique<RenderTarget>("BackBuffer", 1, false, false) :
+        std::make_unique<RenderTarget>("BackBuffer");
 
-    if (!m_backBuffer->Initialise() || !m_sceneTarget->Initialise())
+    if (!InitialiseSceneTargets(m_windowWidth, m_windowHeight, m_antiAliasing))
     {
         LogError("OpenGL: Failed to initialise render targets");
         return false;
@@ -100,7 +190,14 @@ bool OpenGLEngine::Initialise()
         return false;
     }
 
-    if (HasCallFailed())
+    m_sceneTimer = std::make_unique<GpuTimer>();
+    m_postTimer = std::make_unique<GpuTimer>();
+    if (!m_sceneTimer->Initialise() || !m_postTimer->Initialise())
+    {
+        return false;
+    }
+
+    if (HasCallFailed() || TakeDriverErrorCount() > 0)
     {
         LogError("OpenGL: Failed to initialise scene");
         return false;
@@ -112,225 +209,530 @@ bool OpenGLEngine::Initialise()
     return true;
 }
 
-GLFWwindow& OpenGLEngine::GetWindow() const
+bool OpenGLEngine::InitialiseScene()
 {
-    assert(m_window);
-    return *m_window;
-}
+    // Each queued frame streams into its own region of the stream buffer
+    m_queue = std::make_unique<RenderQueue>(m_framesInFlight);
 
-void OpenGLEngine::RenderScene()
-{
-    m_sceneTarget->SetActive();
-    RenderMeshes();
+    if (StreamBuffer::IsSupported())
+    {
+        m_stream = std::make_unique<StreamBuffer>();
+        if (!m_stream->Initialise(STREAM_FRAME_SIZE, m_framesInFlight))
+        {
+            LogError("OpenGL: Failed to initialise stream buffer");
+            m_stream.reset();
+        }
+    }
 
-    m_backBuffer->SetActive();
-    RenderPostProcessing();
+    if (!m_stream || 
+        !IndirectRenderer::IsSupported() || 
+        !m_scene.shaders[ShaderID::TOON_INDIRECT])
+    {
+        LogInfo("OpenGL: Indirect rendering not supported");
+        m_recorder->SetBuffers(m_stream.get(), nullptr);
+        m_openGLBackend->SetBuffers(m_stream.get(), nullptr);
+        return true;
+    }
+
+    // Only opaque toon meshes share the indirect shader's render state
+    std::vector<const Mesh*> meshes;
+    auto AddMeshes = [&meshes](const std::vector<std::unique_ptr<Mesh>>& source)
+    {
+        for (const auto& mesh : source)
+        {
+            if (mesh->ShaderID() == ShaderID::TOON &&
+                mesh->HasBuffers() &&
+                mesh->DepthWrite() &&
+                !mesh->AlphaBlending())
+            {
+                meshes.push_back(mesh.get());
+            }
+        }
+    };
+
+    AddMeshes(m_scene.meshes);
+    AddMeshes(m_scene.batches);
+
+    m_indirect = std::make_unique<IndirectRenderer>();
+    if (!m_indirect->Initialise(meshes))
+    {
+        LogError("OpenGL: Failed to initialise indirect rendering");
+        m_indirect.reset();
+    }
+
+    m_recorder->SetBuffers(m_stream.get(), m_indirect.get());
+    m_openGLBackend->SetBuffers(m_stream.get(), m_indirect.get());
+    return true;
 }
 
-void OpenGLEngine::RenderPostProcessing()
+bool OpenGLEngine::InitialiseSceneTargets(int width, int height, int antiAliasing)
 {
-    EnableBackfaceCull(false);
-    EnableAlphaBlending(false);
-    EnableDepthWrite(true);
+    // MSAA renders multisampled then resolves, FXAA renders single sampled then smooths
+    const bool msaa = antiAliasing == MSAA;
+    m_targetAntiAliasing = antiAliasing;
+    m_targetWidth = width;
+    m_targetHeight = height;
+
+    m_sceneTarget = std::make_unique<RenderTarget>("Scene", SCENE_TEXTURES, msaa);
+    m_toonlineTarget = std::make_unique<RenderTarget>("Toonline", 1, false, false);
+    m_resolveTarget.reset();
+    m_postTarget.reset();
+
+    if (msaa)
+    {
+        m_resolveTarget = std::make_unique<RenderTarget>("Resolve", SCENE_TEXTURES, false, false);
+    }
+    else
+    {
+        m_postTarget = std::make_unique<RenderTarget>("Post", 1, false, false);
+    }
 
-    SetSelectedShader(ShaderID::POST);
-    auto& shader = *m_scene.shaders[m_selectedShader];
-    auto& post = *m_scene.post;
+    // Targets cover the whole window so dynamic resolution only changes the area used
+    const int toonlineWidth = std::max(1, static_cast<int>(width * TOONLINE_SCALE));
+    const int toonlineHeight = std::max(1, static_cast<int>(height * TOONLINE_SCALE));
 
-    shader.SendUniform("finalMask", post.Mask(PostProcessing::FINAL_MAP));
-    shader.SendUniform("sceneMask", post.Mask(PostProcessing::SCENE_MAP));
-    shader.SendUniform("normalMask", post.Mask(PostProcessing::NORMAL_MAP));
-    shader.SendUniform("toonlineMask", post.Mask(PostProcessing::TOONLINE_MAP));
+    if (!m_backBuffer->Resize(width, height) ||
+        !m_sceneTarget->Initialise(width, height) ||
+        !m_toonlineTarget->Initialise(toonlineWidth, toonlineHeight) ||
+        (m_resolveTarget && !m_resolveTarget->Initialise(width, height)) ||
+        (m_postTarget && !m_postTarget->Initialise(width, height)))
+    {
+        LogError("OpenGL: Failed to create " + 
+            GetAntiAliasingName(static_cast<AntiAliasing>(antiAliasing)) + " scene targets");
+        return false;
+    }
 
-    shader.SendTexture("SceneSampler", *m_sceneTarget, ID_COLOUR);
-    shader.SendTexture("NormalSampler", *m_sceneTarget, ID_NORMAL);
+    LogInfo("OpenGL: Using " + GetAntiAliasingName(static_cast<AntiAliasing>(antiAliasing)) +
+        " at " + std::to_string(width) + "x" + std::to_string(height));
+    return true;
+}
 
-    m_quad->PreRender();
-    EnableSelectedShader();
-    m_quad->Render();
+float OpenGLEngine::AspectRatio() const
+{
+    return m_windowWidth / static_cast<float>(m_windowHeight);
+}
 
-    shader.ClearTexture("SceneSampler", *m_sceneTarget);
-    shader.ClearTexture("NormalSampler", *m_sceneTarget);
+int OpenGLEngine::WindowWidth() const
+{
+    return m_windowWidth;
 }
 
-void OpenGLEngine::RenderMeshes()
+int OpenGLEngine::WindowHeight() const
 {
-    for (const auto& mesh : m_scene.meshes)
-    {
-        if (mesh->AnyInstanceVisible() && UpdateShader(*mesh))
-        {
-            mesh->PreRender();
-            EnableSelectedShader();
-            mesh->RenderTextured([this](const glm::mat4& world, int texture)
-            {
-                UpdateShader(world, texture);
-            });
-        }
-    }
+    return m_windowHeight;
+}
 
-    for (const auto& mesh : m_scene.meshes)
+void OpenGLEngine::SetAntiAliasing(AntiAliasing mode)
+{
+    m_antiAliasing = mode;
+}
+
+std::string OpenGLEngine::GetAntiAliasingName(AntiAliasing mode)
+{
+    switch (mode)
     {
-        if (mesh->AnyInstanceVisible() && mesh->RenderShadows() && UpdateShadowShader())
-        {
-            mesh->PreRender();
-            EnableSelectedShader();
-            mesh->Render([this](const glm::mat4& world)
-            {
-                UpdateShadowShader(world);
-            });
-        }
+    case MSAA:
+        return "MSAA";
+    case FXAA:
+        return "FXAA";
+    default:
+        return "None";
     }
+}
 
-    for (const auto& effect : m_scene.effects)
+GLFWwindow& OpenGLEngine::GetWindow() const
+{
+    assert(m_window);
+    return *m_window;
+}
+
+bool OpenGLEngine::SaveBackBuffer(const std::string& path) const
+{
+    std::vector<unsigned char> pixels;
+    if (!m_backBuffer->ReadPixels(pixels) ||
+        !PngWriter::Write(path, m_backBuffer->Width(), m_backBuffer->Height(), pixels))
     {
-        if (effect->AnyInstanceVisible() && UpdateShader(*effect))
-        {
-            effect->PreRender();
-            EnableSelectedShader();
-            effect->RenderTextured([this](const glm::mat4& world, int texture)
-            {
-                UpdateShader(world, texture);
-            });
-        }
+        LogError("OpenGL: Failed to save frame to " + path);
+        return false;
     }
+
+    LogInfo("OpenGL: Saved frame to " + path);
+    return true;
 }
 
-void OpenGLEngine::EndRender()
+bool OpenGLEngine::IsHeadless() const
 {
-    glfwSwapBuffers(m_window);
-    glfwPollEvents();
+    return m_headless;
 }
 
-void OpenGLEngine::UpdateShader(const glm::mat4& world, int texture)
+float OpenGLEngine::SceneMilliseconds() const
 {
-    UpdateShader(world);
-    if (texture >= 0)
+    return m_sceneTime;
+}
+
+float OpenGLEngine::PostMilliseconds() const
+{
+    return m_postTime;
+}
+
+void OpenGLEngine::SetFramesInFlight(int frames)
+{
+    m_framesInFlight = std::min(std::max(frames, 1), MAX_FRAMES_IN_FLIGHT);
+    if (m_framesInFlight != frames)
     {
-        SendTexture("DiffuseSampler", texture);
+        LogError("OpenGL: " + std::to_string(frames) + 
+            " frames in flight not supported, using " + std::to_string(m_framesInFlight));
     }
 }
 
-void OpenGLEngine::UpdateShadowShader(const glm::mat4& world)
+void OpenGLEngine::RenderScene(const RenderSnapshot& snapshot)
 {
-    UpdateShader(world);
+    if (m_stream)
+    {
+        m_stream->BeginFrame();
+    }
 
-    const auto position = glm::matrix_get_position(world);
-    const auto worldTranspose = glm::transpose(glm::mat3(world));
+    // Recording only writes into the stream buffer and command list
+    m_commands->Clear();
+    m_recorder->Record(snapshot, m_windowHeight, *m_commands);
+    m_drawCalls = m_recorder->DrawCalls();
+    m_shadowDrawCalls = m_recorder->ShadowDrawCalls();
 
-    const float shadowOffset = 0.8f;
-    auto pointOnPlane = m_scene.meshes[MeshID::GROUND]->Position();
-    pointOnPlane.y += shadowOffset;
+    RenderFrame(*m_commands, m_windowWidth, m_windowHeight, CaptureSettings());
 
-    // change point on plane and normal to mesh's local frame
-    const auto plane = worldTranspose * (pointOnPlane - position);
-    const auto normal = worldTranspose * glm::vec3(0.0f, 1.0f, 0.0f);
-    
-    auto& shader = *m_scene.shaders[ShaderID::SHADOW];
-    shader.SendUniform("planePosition", plane);
-    shader.SendUniform("planeNormal", normal);
+    if (m_stream)
+    {
+        m_stream->EndFrame();
+        m_bytesStreamed = m_stream->BytesStreamed();
+        m_fenceWaits = m_stream->FenceWaits();
+    }
 }
 
-void OpenGLEngine::UpdateShader(const glm::mat4& world)
+bool OpenGLEngine::RecordFrame(const RenderSnapshot& snapshot)
 {
-    m_scene.shaders[m_selectedShader]->SendUniform("world", world);
+    RenderQueue::Frame* frame = m_queue->BeginWrite();
+    if (!frame)
+    {
+        return false;
+    }
+
+    // Everything the render thread reads is captured with the frame
+    frame->width = m_windowWidth;
+    frame->height = m_windowHeight;
+    frame->settings = CaptureSettings();
+
+    if (m_stream)
+    {
+        m_stream->BeginWrite(frame->region);
+    }
+
+    frame->commands.Clear();
+    m_recorder->Record(snapshot, frame->height, frame->commands);
+    frame->drawCalls = m_recorder->DrawCalls();
+    frame->shadowDrawCalls = m_recorder->ShadowDrawCalls();
+
+    if (m_stream)
+    {
+        m_stream->EndWrite();
+    }
+
+    m_queue->EndWrite();
+    return true;
 }
 
-bool OpenGLEngine::UpdateShader(const Mesh& mesh)
+bool OpenGLEngine::SubmitFrame()
 {
-    const int index = mesh.ShaderID();
-    if (index != NO_INDEX)
+    // Only waits on the GPU when there is nothing recorded to submit meanwhile
+    const RenderQueue::Frame* frame = m_queue->Read(false);
+    while (!frame)
     {
-        auto& shader = *m_scene.shaders[index];
-        if(index != m_selectedShader)
+        if (!ReleaseFrame(true))
         {
-            SetSelectedShader(index);
-
-            if (mesh.RenderWithLights())
+            frame = m_queue->Read(true);
+            if (!frame)
             {
-                SendLights();
+                return false;
             }
-
-            shader.SendUniform("viewProjection", m_camera.ViewProjection());
         }
+        else
+        {
+            frame = m_queue->Read(false);
+        }
+    }
 
-        EnableBackfaceCull(mesh.BackfaceCull());
-        EnableAlphaBlending(mesh.AlphaBlending());
-        EnableDepthWrite(mesh.DepthWrite());
-        return true;
+    m_drawCalls = frame->drawCalls;
+    m_shadowDrawCalls = frame->shadowDrawCalls;
+    RenderFrame(frame->commands, frame->width, frame->height, frame->settings);
+
+    if (m_stream)
+    {
+        m_stream->FenceRegion(frame->region);
+        m_bytesStreamed = m_stream->BytesStreamed();
+        m_fenceWaits = m_stream->FenceWaits();
+    }
+
+    while (ReleaseFrame(false))
+    {
     }
-    return false;
+    return true;
 }
 
-bool OpenGLEngine::UpdateShadowShader()
+bool OpenGLEngine::ReleaseFrame(bool wait)
 {
-    if (m_selectedShader != ShaderID::SHADOW)
+    // Frames are recorded into again once the GPU has read their stream region
+    const RenderQueue::Frame* frame = m_queue->Unreleased();
+    if (!frame || (m_stream && !m_stream->WaitForRegion(frame->region, wait)))
     {
-        auto& shader = *m_scene.shaders[ShaderID::SHADOW];
+        return false;
+    }
 
-        SetSelectedShader(ShaderID::SHADOW);
+    m_queue->Release();
+    return true;
+}
 
-        shader.SendUniform("viewProjection", m_camera.ViewProjection());
+void OpenGLEngine::StopRenderQueue()
+{
+    m_queue->Stop();
+}
 
-        EnableBackfaceCull(false);
-        EnableAlphaBlending(false);
-        EnableDepthWrite(true);
+RenderSettings OpenGLEngine::CaptureSettings() const
+{
+    RenderSettings settings;
+    settings.antiAliasing = m_antiAliasing;
+    settings.fxaaQuality = m_fxaaQuality;
+    settings.postMap = m_scene.post->SelectedMap();
+    settings.nullBackend = m_useNullBackend;
+    settings.callChecking = m_callChecking;
+    settings.resolution = m_resolution->GetSettings();
+    return settings;
+}
+
+void OpenGLEngine::RenderFrame(const RenderCommandList& commands, 
+                               int width, 
+                               int height, 
+                               const RenderSettings& settings)
+{
+    m_frameSettings = settings;
+    SetCallChecking(settings.callChecking);
+
+    // A mode whose targets couldn't be created falls back to MSAA without
+    // changing the requested mode, which is only written by the gui
+    const int antiAliasing = settings.antiAliasing == m_failedAntiAliasing ? 
+        static_cast<int>(MSAA) : settings.antiAliasing;
+
+    // Targets are only recreated between frames when nothing is bound to them
+    const bool resized = width != m_targetWidth || height != m_targetHeight;
+    if ((resized || antiAliasing != m_targetAntiAliasing) && 
+        !InitialiseSceneTargets(width, height, antiAliasing))
+    {
+        m_failedAntiAliasing = antiAliasing;
+        InitialiseSceneTargets(width, height, MSAA);
     }
-    return true;
+
+    m_renderCommands = static_cast<int>(commands.Commands().size());
+    m_sceneScale = m_resolution->Scale();
+
+    m_sceneTimer->Begin();
+    m_sceneTarget->SetActive(m_sceneScale);
+    if (settings.nullBackend)
+    {
+        m_nullBackend->Execute(commands);
+    }
+    else
+    {
+        m_openGLBackend->Execute(commands);
+    }
+    m_sceneTimer->End();
+    m_sceneTime = m_sceneTimer->Milliseconds();
+
+    m_postTimer->Begin();
+    RenderPostProcessing();
+    m_postTimer->End();
+    m_postTime = m_postTimer->Milliseconds();
 }
 
-void OpenGLEngine::SendLights()
+void OpenGLEngine::RenderPostProcessing()
 {
+    // Post processing passes are drawn directly so share the backend render states
+    m_openGLBackend->SetState(RenderCommandList::DEPTH_WRITE);
+
+    const bool msaa = m_targetAntiAliasing == MSAA;
+    if (msaa)
+    {
+        m_sceneTarget->CopyTo(*m_resolveTarget, m_sceneScale);
+    }
+
+    const RenderTarget& scene = msaa ? *m_resolveTarget : *m_sceneTarget;
+
+    const auto map = m_frameSettings.postMap;
+    if (map == PostProcessing::FINAL_MAP || map == PostProcessing::TOONLINE_MAP)
+    {
+        RenderToonlines(scene);
+    }
+
+    // Without FXAA the post pass also upscales the scene to the window
+    msaa ? m_backBuffer->SetActive() : m_postTarget->SetActive(m_sceneScale);
+
+    SetSelectedShader(ShaderID::POST + map);
     auto& shader = *m_scene.shaders[m_selectedShader];
-    const auto& lights = m_scene.lights;
+    shader.SendUniform("uvScale", glm::vec2(m_sceneScale));
+
+    shader.SendTexture("SceneSampler", scene, ID_COLOUR);
+    shader.SendTexture("NormalSampler", scene, ID_NORMAL);
+    shader.SendTexture("ToonlineSampler", *m_toonlineTarget, 0);
+
+    EnableSelectedShader(*m_quad);
+    m_quad->Render();
+
+    shader.ClearTexture("SceneSampler", scene);
+    shader.ClearTexture("NormalSampler", scene);
+    shader.ClearTexture("ToonlineSampler", *m_toonlineTarget);
 
-    for (unsigned int i = 0; i < lights.size(); ++i)
+    if (!msaa)
     {
-        const int offset = i * 3;
-        shader.SendUniform("lightPosition", lights[i]->Position(), offset);
-        shader.SendUniform("lightDiffuse", lights[i]->Diffuse(), offset);
+        RenderFxaa();
     }
 }
 
-void OpenGLEngine::SendTexture(std::string sampler, int ID)
+void OpenGLEngine::RenderToonlines(const RenderTarget& scene)
+{
+    m_toonlineTarget->SetActive(m_sceneScale);
+
+    SetSelectedShader(ShaderID::TOONLINE);
+    auto& shader = *m_scene.shaders[m_selectedShader];
+    shader.SendUniform("uvScale", glm::vec2(m_sceneScale));
+
+    shader.SendTexture("NormalSampler", scene, ID_NORMAL);
+
+    EnableSelectedShader(*m_quad);
+    m_quad->Render();
+
+    shader.ClearTexture("NormalSampler", scene);
+}
+
+void OpenGLEngine::RenderFxaa()
+{
+    m_backBuffer->SetActive();
+
+    SetSelectedShader(ShaderID::FXAA);
+    auto& shader = *m_scene.shaders[m_selectedShader];
+    shader.SendUniform("uvScale", glm::vec2(m_sceneScale));
+
+    const FxaaPreset& preset = FXAA_PRESETS[m_frameSettings.fxaaQuality];
+    shader.SendUniform("fxaaSpanMax", preset.spanMax);
+    shader.SendUniform("fxaaReduceMul", preset.reduceMul);
+    shader.SendUniform("fxaaReduceMin", preset.reduceMin);
+    shader.SendUniform("fxaaEdgeThreshold", preset.edgeThreshold);
+    shader.SendUniform("fxaaEdgeThresholdMin", preset.edgeThresholdMin);
+
+    shader.SendTexture("SceneSampler", *m_postTarget, 0);
+
+    EnableSelectedShader(*m_quad);
+    m_quad->Render();
+
+    shader.ClearTexture("SceneSampler", *m_postTarget);
+}
+
+void OpenGLEngine::EndRender()
 {
-    if (ID != NO_INDEX)
+    PresentFrame();
+    PollEvents();
+}
+
+void OpenGLEngine::PresentFrame()
+{
+    if (m_headless)
+    {
+        // Submits the frame as there is no swap to do so
+        glFlush();
+    }
+    else
     {
-        auto& shader = *m_scene.shaders[m_selectedShader];
-        shader.SendTexture(sampler, m_scene.textures[ID]->GetID());
+        glfwSwapBuffers(m_window);
     }
+
+    m_resolution->Update(m_sceneTime + m_postTime, m_frameSettings.resolution);
+
+    m_driverErrors = TakeDriverErrorCount();
+    m_textureBinds = TakeTextureBindCount();
 }
 
-void OpenGLEngine::EnableAlphaBlending(bool enable)
+void OpenGLEngine::PollEvents()
 {
-    if (enable != m_isAlphaBlend)
+    if (!m_headless)
     {
-        m_isAlphaBlend = enable;
-        enable ? glEnablei(GL_BLEND, 0) : glDisablei(GL_BLEND, 0);
-        enable ? glEnablei(GL_BLEND, 1) : glDisablei(GL_BLEND, 1);
+        glfwPollEvents();
+
+        // A minimised window has no size so keeps the last one
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(m_window, &width, &height);
+        if (width > 0 && height > 0)
+        {
+            m_windowWidth = width;
+            m_windowHeight = height;
+        }
     }
 }
 
-void OpenGLEngine::EnableBackfaceCull(bool enable)
+bool OpenGLEngine::MakeContextCurrent(bool current)
 {
-    if(enable != m_isBackfaceCull)
+    if (m_headless)
     {
-        m_isBackfaceCull = enable;
-        enable ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+        return m_headlessContext->MakeCurrent(current);
     }
+
+    glfwMakeContextCurrent(current ? m_window : nullptr);
+    return true;
+}
+
+int OpenGLEngine::DriverErrors() const
+{
+    return m_driverErrors;
+}
+
+int OpenGLEngine::TextureBinds() const
+{
+    return m_textureBinds;
 }
 
-void OpenGLEngine::EnableDepthWrite(bool enable)
+void OpenGLEngine::AddToTweaker(Tweaker& tweaker)
 {
-    if (enable != m_isDepthWrite)
+    tweaker.SetGroup("OpenGL");
+    tweaker.AddEntry("Driver Errors", &m_driverErrors, TW_TYPE_INT32, true);
+    tweaker.AddEntry("Texture Binds", &m_textureBinds, TW_TYPE_INT32, true);
+    tweaker.AddEntry("Render Commands", &m_renderCommands, TW_TYPE_INT32, true);
+    tweaker.AddEntry("Null Backend", &m_useNullBackend, TW_TYPE_BOOLCPP);
+    tweaker.AddEntry("Mesh Draw Calls", &m_drawCalls, TW_TYPE_INT32, true);
+    tweaker.AddEntry("Shadow Draw Calls", &m_shadowDrawCalls, TW_TYPE_INT32, true);
+    m_recorder->AddToTweaker(tweaker);
+    tweaker.AddEntry("Scene GPU ms", &m_sceneTime, TW_TYPE_FLOAT, true);
+    tweaker.AddEntry("Post GPU ms", &m_postTime, TW_TYPE_FLOAT, true);
+    m_resolution->AddToTweaker(tweaker);
+
+    tweaker.AddIntEntry("Anti-Aliasing", &m_antiAliasing, 0, MAX_ANTIALIASING - 1);
+    tweaker.AddStrEntry("Anti-Aliasing Mode", [this]()
     {
-        m_isDepthWrite = enable;
-        enable ? glDepthMask(GL_TRUE) : glDepthMask(GL_FALSE);
+        return GetAntiAliasingName(static_cast<AntiAliasing>(m_targetAntiAliasing));
+    });
+    tweaker.AddIntEntry("FXAA Quality", &m_fxaaQuality, 0, FXAA_PRESET_COUNT - 1);
+
+    if (m_stream)
+    {
+        tweaker.AddEntry("Bytes Streamed", &m_bytesStreamed, TW_TYPE_INT32, true);
+        tweaker.AddEntry("Fence Waits", &m_fenceWaits, TW_TYPE_INT32, true);
+    }
+
+    if (GL_CALL_CHECKS)
+    {
+        tweaker.AddEntry("Call Checking", &m_callChecking, TW_TYPE_BOOLCPP);
     }
 }
 
-void OpenGLEngine::EnableSelectedShader()
+void OpenGLEngine::EnableSelectedShader(const Mesh& mesh)
 {
-    m_scene.shaders[m_selectedShader]->EnableShader();
+    auto& shader = *m_scene.shaders[m_selectedShader];
+    mesh.PreRender(shader.AttributeMask());
+    shader.EnableShader();
 }
 
 void OpenGLEngine::SetSelectedShader(int index)
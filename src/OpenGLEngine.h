@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "Mesh.h"
+#include "RenderSettings.h"
 #include "glm/glm.hpp"
 
 #include <vector>
@@ -12,10 +14,20 @@
 
 struct GLFWwindow;
 struct SceneData;
-class Mesh;
+struct RenderSnapshot;
 class Quad;
-class Camera;
 class RenderTarget;
+class Tweaker;
+class IndirectRenderer;
+class StreamBuffer;
+class GpuTimer;
+class ResolutionScaler;
+class HeadlessContext;
+class RenderCommandList;
+class SceneRecorder;
+class OpenGLBackend;
+class NullBackend;
+class RenderQueue;
 
 /**
 * Engine for initialising and managing OpenGL
@@ -24,13 +36,22 @@ class OpenGLEngine
 {
 public:
 
+    /**
+    * Ways of smoothing the edges of the scene
+    */
+    enum AntiAliasing
+    {
+        MSAA,
+        FXAA,
+        MAX_ANTIALIASING
+    };
+
     /**
     * Constructor
     * @param scene The data to render
-    * @param camera The viewable camera
+    * @param headless Whether to render offscreen without a window
     */
-    OpenGLEngine(const SceneData& scene,
-                 const Camera& camera);
+    OpenGLEngine(const SceneData& scene, bool headless = false);
 
     /**
     * Destructor
@@ -43,106 +64,221 @@ public:
     */
     bool Initialise();
 
+    /**
+    * Prepares rendering resources which require the scene to be loaded
+    * @return whether or not initialisation succeeded
+    */
+    bool InitialiseScene();
+
     /**
     * @return whether OpenGL is currently running
+    * @note always true when headless as the caller decides how many frames to render
     */
     bool IsRunning() const;
 
     /**
     * Renders the scene
+    * @param snapshot The state of the scene instances to render
+    */
+    void RenderScene(const RenderSnapshot& snapshot);
+
+    /**
+    * Sets how many frames can be recorded ahead of the GPU
+    * @param frames The number of frames, each streaming into its own region
+    * @note must be set before the scene is initialised and is clamped to a small limit
     */
-    void RenderScene();
+    void SetFramesInFlight(int frames);
 
     /**
-    * Applies the post processing shader
+    * Records the scene into the render queue for a render thread to submit
+    * Waits if every frame is queued or still being read by the GPU
+    * @param snapshot The state of the scene instances to render
+    * @return whether the frame was queued, false if the queue has stopped
+    * @note does not call OpenGL so can be used without the context
+    */
+    bool RecordFrame(const RenderSnapshot& snapshot);
+
+    /**
+    * Renders the oldest frame in the render queue, waiting for one to be recorded
+    * @return whether a frame was rendered, false if the queue has stopped
+    * @note must be called on the thread the context is current on
+    */
+    bool SubmitFrame();
+
+    /**
+    * Releases any thread waiting on the render queue
+    */
+    void StopRenderQueue();
+
+    /**
+    * Resolves the scene and applies the post processing shader for the selected map
     */
     void RenderPostProcessing();
 
+    /**
+    * Sets how the scene is anti-aliased, recreating the scene targets at the next render
+    * @param mode The anti-aliasing mode to use
+    */
+    void SetAntiAliasing(AntiAliasing mode);
+
+    /**
+    * @return the width of the window relative to its height
+    */
+    float AspectRatio() const;
+
+    /**
+    * @return the width of the window in pixels
+    */
+    int WindowWidth() const;
+
+    /**
+    * @return the height of the window in pixels
+    */
+    int WindowHeight() const;
+
+    /**
+    * @param mode The anti-aliasing mode to convert
+    * @return The string name of the anti-aliasing mode
+    */
+    static std::string GetAntiAliasingName(AntiAliasing mode);
+
     /**
     * Ends the rendering pipeline
     */
     void EndRender();
 
     /**
-    * @return the application window
+    * Presents the rendered frame, which may block until the swap
+    * @note must be called on the thread the context is current on
     */
-    GLFWwindow& GetWindow() const;
+    void PresentFrame();
 
-private: 
+    /**
+    * Processes window events and follows changes to the window size
+    * @note must be called on the main thread
+    */
+    void PollEvents();
 
     /**
-    * Prevent copying
+    * Moves the context to or from the calling thread
+    * @param current Whether to make the context current or release it
+    * @return whether the context was changed
     */
-    OpenGLEngine(const OpenGLEngine&) = delete;
-    OpenGLEngine& operator=(const OpenGLEngine&) = delete;
+    bool MakeContextCurrent(bool current);
 
     /**
-    * Releases OpenGL
+    * Writes the last rendered frame to file
+    * @param path The path of the PNG file to write
+    * @return whether the frame was saved
     */
-    void Release();
+    bool SaveBackBuffer(const std::string& path) const;
+
+    /**
+    * @return whether rendering offscreen without a window
+    */
+    bool IsHeadless() const;
+
+    /**
+    * @return the last available GPU time of the scene pass in milliseconds
+    */
+    float SceneMilliseconds() const;
+
+    /**
+    * @return the last available GPU time of the post processing passes in milliseconds
+    */
+    float PostMilliseconds() const;
 
     /**
-    * Renders the meshes
+    * @return the application window
+    * @note not available when headless
     */
-    void RenderMeshes();
+    GLFWwindow& GetWindow() const;
 
     /**
-    * Updates and switches to main shader the mesh requires
+    * Adds the engine diagnostics to the tweaker
+    * @param tweaker The tweak bar to add to
     */
-    bool UpdateShader(const Mesh& mesh);
+    void AddToTweaker(Tweaker& tweaker);
 
     /**
-    * Updates and switches to the shadow shader the mesh requres
+    * @return the number of driver errors in the last frame
     */
-    bool UpdateShadowShader();
+    int DriverErrors() const;
 
     /**
-    * Updates the shader for a mesh per instance
+    * @return the number of textures bound in the last frame
     */
-    void UpdateShader(const glm::mat4& world, int texture);
+    int TextureBinds() const;
+
+private: 
 
     /**
-    * Updates the shader for a mesh per instance
+    * Prevent copying
     */
-    void UpdateShader(const glm::mat4& world);
+    OpenGLEngine(const OpenGLEngine&) = delete;
+    OpenGLEngine& operator=(const OpenGLEngine&) = delete;
 
     /**
-    * Updates the shader for a mesh per instance
+    * Releases OpenGL
     */
-    void UpdateShadowShader(const glm::mat4& world);
+    void Release();
+
+    /**
+    * Creates the application window and its context
+    * @return whether creation was successful
+    */
+    bool InitialiseWindow();
 
     /**
-    * Sets whether alpha blending is enabled or not
+    * Finds the toon lines from the resolved scene normals
+    * @param scene The single sampled scene target
     */
-    void EnableAlphaBlending(bool enable);
+    void RenderToonlines(const RenderTarget& scene);
 
     /**
-    * Sends light information to the selected shader
+    * Anti-aliases the post processed scene into the back buffer
     */
-    void SendLights();
+    void RenderFxaa();
 
     /**
-    * Sends the texture to the selected shader
+    * Creates the targets for the window size and anti-aliasing mode
+    * @param width The width of the window in pixels
+    * @param height The height of the window in pixels
+    * @param antiAliasing The anti-aliasing mode to create the targets for
+    * @return whether creation was successful
     */
-    void SendTexture(std::string sampler, int ID);
+    bool InitialiseSceneTargets(int width, int height, int antiAliasing);
 
     /**
-    * Sets whether values are written to the depth buffer or not
-    * @note if set to false the depth buffer of the currently 
-    *       selected render target till not clear
+    * @return the settings to render the next recorded frame with
+    * @note must be called on the thread which tweaks the settings
     */
-    void EnableDepthWrite(bool enable);
+    RenderSettings CaptureSettings() const;
 
     /**
-    * Sets whether opengl should cull backfaces or not
-    * @param enable whether to cull or not
+    * Executes the scene commands then post processes the scene
+    * @param commands The commands recorded for the scene pass
+    * @param width The width of the window when recorded
+    * @param height The height of the window when recorded
+    * @param settings The engine settings when recorded
     */
-    void EnableBackfaceCull(bool enable);
+    void RenderFrame(const RenderCommandList& commands, 
+                     int width, 
+                     int height, 
+                     const RenderSettings& settings);
 
     /**
-    * Enables the selected shader for rendering
+    * Releases the oldest submitted frame once the GPU has finished reading it
+    * @param wait Whether to wait for the GPU
+    * @return whether a frame was released
     */
-    void EnableSelectedShader();
+    bool ReleaseFrame(bool wait);
+
+    /**
+    * Enables the selected shader and binds the mesh vertex array for it
+    * @param mesh The mesh to render
+    */
+    void EnableSelectedShader(const Mesh& mesh);
 
     /**
     * Sets the shader at the given index as selected
@@ -152,14 +288,47 @@ private:
 private:
 
     GLFWwindow* m_window = nullptr;  ///< Handle to the application window
-    const Camera& m_camera;          ///< The viewable camera
+    const bool m_headless = false;   ///< Whether rendering offscreen without a window
     const SceneData& m_scene;        ///< The data to render
-    bool m_isBackfaceCull = true;    ///< Whether the culling rasterize state is active
-    bool m_isAlphaBlend = false;     ///< Whether alpha blending is currently active
-    bool m_isDepthWrite = true;      ///< Whether writing to the depth buffer is active
     int m_selectedShader = -1;       ///< Currently active shader for rendering
-
-    std::unique_ptr<Quad> m_quad;                 ///< Post processing quad
-    std::unique_ptr<RenderTarget> m_backBuffer;   ///< Back buffer target
-    std::unique_ptr<RenderTarget> m_sceneTarget;  ///< Main scene target, includes the normal texture
+    int m_driverErrors = 0;          ///< Number of driver errors in the last frame
+    int m_textureBinds = 0;          ///< Number of textures bound in the last frame
+    bool m_callChecking = false;     ///< Whether each call is checked with glGetError
+    bool m_useNullBackend = false;   ///< Whether to count the scene commands instead of executing them
+    int m_renderCommands = 0;        ///< Number of scene commands recorded in the last frame
+    int m_drawCalls = 0;             ///< Number of mesh draw calls in the last frame
+    int m_shadowDrawCalls = 0;       ///< Number of shadow draw calls in the last frame
+    float m_postTime = 0.0f;         ///< GPU milliseconds spent post processing
+    float m_sceneTime = 0.0f;        ///< GPU milliseconds spent rendering the scene
+    float m_sceneScale = 1.0f;       ///< Fraction of the window resolution the scene is rendered at
+    int m_windowWidth = 0;           ///< Width of the window in pixels
+    int m_windowHeight = 0;          ///< Height of the window in pixels
+    int m_targetWidth = 0;           ///< Window width the render targets were created for
+    int m_targetHeight = 0;          ///< Window height the render targets were created for
+    int m_antiAliasing = MSAA;       ///< Requested anti-aliasing mode
+    int m_targetAntiAliasing = MSAA; ///< Anti-aliasing mode the scene targets were created for
+    int m_failedAntiAliasing = -1;   ///< Anti-aliasing mode whose scene targets couldn't be created
+    int m_fxaaQuality = 1;           ///< Index of the FXAA quality preset
+    int m_bytesStreamed = 0;         ///< Bytes of dynamic data written in the last frame
+    int m_fenceWaits = 0;            ///< Times the last frame waited for the GPU to release data
+    int m_framesInFlight = 3;        ///< Frames which can be recorded ahead of the GPU
+    RenderSettings m_frameSettings;  ///< Settings of the frame being rendered, only used while rendering
+
+    std::unique_ptr<Quad> m_quad;                   ///< Post processing quad
+    std::unique_ptr<RenderTarget> m_backBuffer;     ///< Back buffer target
+    std::unique_ptr<RenderTarget> m_sceneTarget;    ///< Main scene target, includes the normal texture
+    std::unique_ptr<RenderTarget> m_resolveTarget;  ///< Single sampled copy of the scene target
+    std::unique_ptr<RenderTarget> m_toonlineTarget; ///< Toon lines found from the scene normals
+    std::unique_ptr<RenderTarget> m_postTarget;     ///< Post processed scene before FXAA
+    std::unique_ptr<GpuTimer> m_postTimer;          ///< Times the post processing passes
+    std::unique_ptr<GpuTimer> m_sceneTimer;         ///< Times the scene pass
+    std::unique_ptr<ResolutionScaler> m_resolution; ///< Scales the scene resolution to hold the frame time
+    std::unique_ptr<HeadlessContext> m_headlessContext; ///< Offscreen context used instead of a window
+    std::unique_ptr<IndirectRenderer> m_indirect;   ///< Draws meshes from shared buffers
+    std::unique_ptr<StreamBuffer> m_stream;         ///< Ring buffer for data written each frame
+    std::unique_ptr<RenderCommandList> m_commands;  ///< Commands recorded for the scene pass
+    std::unique_ptr<SceneRecorder> m_recorder;      ///< Records the scene pass without calling OpenGL
+    std::unique_ptr<OpenGLBackend> m_openGLBackend; ///< Executes commands through OpenGL
+    std::unique_ptr<NullBackend> m_nullBackend;     ///< Counts commands without executing them
+    std::unique_ptr<RenderQueue> m_queue;           ///< Frames recorded for a render thread to submit
 };
\ No newline at end of file
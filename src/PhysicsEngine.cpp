@@ -5,6 +5,7 @@
 #include "PhysicsEngine.h"
 #include "CollisionEvent.h"
 #include "Conversions.h"
+#include "Utils.h"
 
 #include "bullet/include/linearMath/btTransform.h"
 
@@ -271,6 +272,17 @@ void PhysicsEngine::Tick(float timestep)
     }
 }
 
+float PhysicsEngine::GetPhysicsDeltaTime(float deltaTime)
+{
+    // These values are taken from the previous implementation of this game
+    return ConvertRange(Clamp(deltaTime, 0.2f, 20.0f), 0.2f, 20.0f, 0.02f, 0.4f);
+}
+
+float PhysicsEngine::GetTimeStep(float physicsDeltaTime)
+{
+    return Clamp(physicsDeltaTime * 0.075f, 0.001f, 0.01f);
+}
+
 int PhysicsEngine::CreateHinge(int rigidBodyID1, 
                                int rigidBodyID2, 
                                const glm::vec3& pos1local, 
@@ -38,6 +38,19 @@ public:
     */
     void Tick(float timestep);
 
+    /**
+    * Scales the time passed since last frame for use by the game physics
+    * @param deltaTime The time passed since last frame
+    * @return the time passed scaled for the physics engine
+    */
+    static float GetPhysicsDeltaTime(float deltaTime);
+
+    /**
+    * @param physicsDeltaTime The time passed scaled for the physics engine
+    * @return how much to proceed the physics per iteration
+    */
+    static float GetTimeStep(float physicsDeltaTime);
+
     /**
     * Generates a collision event
     * @param collisionIndex The index from currently occuring collisions
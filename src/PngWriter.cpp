@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - PngWriter.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PngWriter.h"
+#include "Logger.h"
+
+#include <array>
+#include <fstream>
+#include <algorithm>
+
+namespace
+{
+    const int BYTES_PER_PIXEL = 4;
+    const unsigned int MAX_STORED_BLOCK = 65535;  ///< Largest deflate block without compression
+    const unsigned int ADLER_MODULO = 65521;
+    const unsigned char SIGNATURE[] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+
+    /**
+    * @return the table for calculating the CRC of each chunk
+    */
+    const std::array<unsigned int, 256>& GetCrcTable()
+    {
+        static const std::array<unsigned int, 256> table = []()
+        {
+            std::array<unsigned int, 256> values;
+            for (unsigned int i = 0; i < values.size(); ++i)
+            {
+                unsigned int value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                values[i] = value;
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    /**
+    * Adds a value with the most significant byte first
+    */
+    void AddBigEndian(unsigned int value, std::vector<unsigned char>& data)
+    {
+        data.push_back(static_cast<unsigned char>(value >> 24));
+        data.push_back(static_cast<unsigned char>(value >> 16));
+        data.push_back(static_cast<unsigned char>(value >> 8));
+        data.push_back(static_cast<unsigned char>(value));
+    }
+}
+
+void PngWriter::AddChunk(const char* type,
+                         const std::vector<unsigned char>& data,
+                         std::vector<unsigned char>& file)
+{
+    AddBigEndian(static_cast<unsigned int>(data.size()), file);
+
+    // The checksum covers the type and the data but not the length
+    const size_t start = file.size();
+    file.insert(file.end(), type, type + 4);
+    file.insert(file.end(), data.begin(), data.end());
+
+    const auto& table = GetCrcTable();
+    unsigned int crc = 0xFFFFFFFFu;
+    for (size_t i = start; i < file.size(); ++i)
+    {
+        crc = table[(crc ^ file[i]) & 0xFF] ^ (crc >> 8);
+    }
+    AddBigEndian(crc ^ 0xFFFFFFFFu, file);
+}
+
+bool PngWriter::Write(const std::string& path,
+                      int width,
+                      int height,
+                      const std::vector<unsigned char>& pixels)
+{
+    const size_t rowSize = width * BYTES_PER_PIXEL;
+    if (width <= 0 || height <= 0 || pixels.size() < rowSize * height)
+    {
+        LogError("PngWriter: Invalid image for " + path);
+        return false;
+    }
+
+    std::vector<unsigned char> header;
+    AddBigEndian(width, header);
+    AddBigEndian(height, header);
+    header.push_back(8);  // Bits per channel
+    header.push_back(6);  // RGBA
+    header.push_back(0);  // Deflate
+    header.push_back(0);  // Adaptive filtering
+    header.push_back(0);  // No interlacing
+
+    // Each row starts with its filter type, which is none
+    std::vector<unsigned char> scanlines;
+    scanlines.reserve((rowSize + 1) * height);
+    for (int row = 0; row < height; ++row)
+    {
+        scanlines.push_back(0);
+        const auto start = pixels.begin() + row * rowSize;
+        scanlines.insert(scanlines.end(), start, start + rowSize);
+    }
+
+    // Zlib stream made of stored deflate blocks followed by the Adler-32 checksum
+    std::vector<unsigned char> data = { 0x78, 0x01 };
+    data.reserve(scanlines.size() + scanlines.size() / MAX_STORED_BLOCK * 5 + 16);
+
+    size_t offset = 0;
+    do
+    {
+        const unsigned int size = static_cast<unsigned int>(
+            std::min<size_t>(MAX_STORED_BLOCK, scanlines.size() - offset));
+        const bool last = offset + size == scanlines.size();
+
+        data.push_back(last ? 1 : 0);
+        data.push_back(static_cast<unsigned char>(size));
+        data.push_back(static_cast<unsigned char>(size >> 8));
+        data.push_back(static_cast<unsigned char>(~size));
+        data.push_back(static_cast<unsigned char>(~size >> 8));
+        data.insert(data.end(), scanlines.begin() + offset, scanlines.begin() + offset + size);
+        offset += size;
+    }
+    while (offset < scanlines.size());
+
+    unsigned int a = 1, b = 0;
+    for (unsigned char value : scanlines)
+    {
+        a = (a + value) % ADLER_MODULO;
+        b = (b + a) % ADLER_MODULO;
+    }
+    AddBigEndian((b << 16) | a, data);
+
+    std::vector<unsigned char> file(std::begin(SIGNATURE), std::end(SIGNATURE));
+    AddChunk("IHDR", header, file);
+    AddChunk("IDAT", data, file);
+    AddChunk("IEND", {}, file);
+
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream.write(reinterpret_cast<const char*>(file.data()), file.size()))
+    {
+        LogError("PngWriter: Could not write " + path);
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
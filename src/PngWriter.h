@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - PngWriter.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+/**
+* Writes images as uncompressed PNG files
+* Pixels are stored rather than compressed so no image library is needed,
+* which suits captures that are compared rather than kept
+*/
+class PngWriter
+{
+public:
+
+    /**
+    * Writes an RGBA image to file
+    * @param path The path of the file to write
+    * @param width The width of the image in pixels
+    * @param height The height of the image in pixels
+    * @param pixels Four bytes for each pixel with the top row first
+    * @return whether the file was written
+    */
+    static bool Write(const std::string& path,
+                      int width,
+                      int height,
+                      const std::vector<unsigned char>& pixels);
+
+private:
+
+    /**
+    * Adds a chunk with its length and checksum to the file data
+    * @param type The four character type of the chunk
+    * @param data The contents of the chunk
+    * @param file The file data to add to
+    */
+    static void AddChunk(const char* type,
+                         const std::vector<unsigned char>& data,
+                         std::vector<unsigned char>& file);
+};
\ No newline at end of file
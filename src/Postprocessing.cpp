@@ -26,6 +26,11 @@ void PostProcessing::SetPostMap(PostProcessing::Map map)
     m_masks[map] = 1.0f;
 }
 
+PostProcessing::Map PostProcessing::SelectedMap() const
+{
+    return m_selectedMap;
+}
+
 float PostProcessing::Mask(PostProcessing::Map map) const
 {
     return m_masks.at(map);
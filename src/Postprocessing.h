@@ -54,6 +54,11 @@ public:
     */
     std::string GetPostMap() const;
 
+    /**
+    * @return the currently rendered map
+    */
+    Map SelectedMap() const;
+
     /**
     * @param map the map type to convert
     * @return The string name of the map type
@@ -3,27 +3,33 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #include "RandomGenerator.h"
-#include "Logger.h"
 
 #include <time.h>
 
-std::default_random_engine Random::sm_generator;
+Random::Random(unsigned int seed)
+    : m_seed(seed)
+    , m_generator(seed)
+{
+}
+
+unsigned int Random::TimeSeed()
+{
+    return static_cast<unsigned int>(time(0));
+}
 
-void Random::Initialise()
+unsigned int Random::Seed() const
 {
-    const auto seed = static_cast<unsigned long>(time(0));
-    sm_generator.seed(seed);
-    LogInfo("Starting initialisation with seed " + std::to_string(seed));
+    return m_seed;
 }
 
 int Random::Generate(int min, int max)
 {
     std::uniform_int_distribution<int> distribution(min, max);
-    return distribution(sm_generator);
+    return distribution(m_generator);
 }
 
 float Random::Generate(float min, float max)
 {
     std::uniform_real_distribution<float> distribution(min, max);
-    return distribution(sm_generator);
+    return distribution(m_generator);
 }
\ No newline at end of file
@@ -8,27 +8,48 @@
 
 /**
 * Utility class to get a random value
+* Each game instance owns its own generator so results are reproducible per seed
 */
 class Random
 {
 public:
 
     /**
-    * Initialises the random generator
+    * Constructor
+    * @param seed The seed for the generator
     */
-    static void Initialise();
+    Random(unsigned int seed);
+
+    /**
+    * @return a seed based on the current time
+    */
+    static unsigned int TimeSeed();
+
+    /**
+    * @return the seed the generator was created with
+    */
+    unsigned int Seed() const;
 
     /**
     * @return a random int between min/max
     */
-    static int Generate(int min, int max);
+    int Generate(int min, int max);
 
     /**
     * @return a random float between min/max
     */
-    static float Generate(float min, float max);
+    float Generate(float min, float max);
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    Random(const Random&) = delete;
+    Random& operator=(const Random&) = delete;
 
 private:
 
-    static std::default_random_engine sm_generator;
+    unsigned int m_seed = 0;                  ///< Seed the generator was created with
+    std::default_random_engine m_generator;   ///< Generator for random values
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderBackend.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class RenderCommandList;
+
+/**
+* Executes recorded render commands
+*/
+class RenderBackend
+{
+public:
+
+    /**
+    * Destructor
+    */
+    virtual ~RenderBackend() = default;
+
+    /**
+    * Executes the commands in the order recorded
+    * @param commands The commands to execute
+    */
+    virtual void Execute(const RenderCommandList& commands) = 0;
+};
\ No newline at end of file
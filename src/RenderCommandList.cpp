@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderCommandList.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RenderCommandList.h"
+#include "Light.h"
+
+void RenderCommandList::Clear()
+{
+    m_commands.clear();
+    m_matrices.clear();
+    m_lights.clear();
+    m_frameConstants.clear();
+}
+
+RenderCommandList::Command& RenderCommandList::Add(Type type)
+{
+    m_commands.emplace_back();
+    m_commands.back().type = type;
+    return m_commands.back();
+}
+
+void RenderCommandList::SetShader(int index)
+{
+    Add(SET_SHADER).value = index;
+}
+
+void RenderCommandList::SetState(int state)
+{
+    Add(SET_STATE).value = state;
+}
+
+void RenderCommandList::SendMatrix(Matrix uniform, const glm::mat4& matrix)
+{
+    Command& command = Add(SEND_MATRIX);
+    command.value = uniform;
+    command.count = static_cast<int>(m_matrices.size());
+    m_matrices.push_back(matrix);
+}
+
+void RenderCommandList::SendFrameConstants(const FrameConstants& constants)
+{
+    Add(SEND_FRAME_CONSTANTS).count = static_cast<int>(m_frameConstants.size());
+    m_frameConstants.push_back(constants);
+}
+
+void RenderCommandList::SendLights(const std::vector<std::unique_ptr<Light>>& lights)
+{
+    Command& command = Add(SEND_LIGHTS);
+    command.value = static_cast<int>(m_lights.size() / 2);
+    command.count = static_cast<int>(lights.size());
+
+    // Captured so executing doesn't read lights the game can change meanwhile
+    for (const auto& light : lights)
+    {
+        m_lights.push_back(light->Position());
+        m_lights.push_back(light->Diffuse());
+    }
+}
+
+void RenderCommandList::SendTexture(int texture)
+{
+    Add(SEND_TEXTURE).value = texture;
+}
+
+void RenderCommandList::BindMesh(const Mesh& mesh)
+{
+    Add(BIND_MESH).mesh = &mesh;
+}
+
+void RenderCommandList::BindUniformBlock(int binding, GLintptr offset, GLsizeiptr bytes)
+{
+    Command& command = Add(BIND_UNIFORM_BLOCK);
+    command.value = binding;
+    command.offset = offset;
+    command.bytes = bytes;
+}
+
+void RenderCommandList::BindStorageBlock(int binding, GLintptr offset, GLsizeiptr bytes)
+{
+    Command& command = Add(BIND_STORAGE_BLOCK);
+    command.value = binding;
+    command.offset = offset;
+    command.bytes = bytes;
+}
+
+void RenderCommandList::BindIndirect(int instances)
+{
+    Add(BIND_INDIRECT).count = instances;
+}
+
+void RenderCommandList::Draw(const Mesh& mesh, int level)
+{
+    Command& command = Add(DRAW);
+    command.mesh = &mesh;
+    command.value = level;
+}
+
+void RenderCommandList::DrawInstanced(const Mesh& mesh, int level, int instances)
+{
+    Command& command = Add(DRAW_INSTANCED);
+    command.mesh = &mesh;
+    command.value = level;
+    command.count = instances;
+}
+
+void RenderCommandList::DrawIndirect(GLintptr offset, int commands)
+{
+    Command& command = Add(DRAW_INDIRECT);
+    command.offset = offset;
+    command.count = commands;
+}
+
+const std::vector<RenderCommandList::Command>& RenderCommandList::Commands() const
+{
+    return m_commands;
+}
+
+const glm::mat4& RenderCommandList::GetMatrix(int index) const
+{
+    return m_matrices[index];
+}
+
+const RenderCommandList::FrameConstants& RenderCommandList::GetFrameConstants(int index) const
+{
+    return m_frameConstants[index];
+}
+
+const glm::vec3* RenderCommandList::GetLight(int index) const
+{
+    return &m_lights[index * 2];
+}
\ No newline at end of file
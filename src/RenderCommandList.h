@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderCommandList.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OpenGL.h"
+
+#include <vector>
+#include <memory>
+
+class Mesh;
+class Light;
+
+/**
+* Compact list of rendering work recorded without calling OpenGL
+* Commands are executed afterwards by a backend, so recording can happen
+* without a context and on any thread while only execution touches the driver
+*/
+class RenderCommandList
+{
+public:
+
+    /**
+    * Type of work each command does
+    */
+    enum Type
+    {
+        SET_SHADER,           ///< Makes the shader the target of the following commands
+        SET_STATE,            ///< Sets the combination of render states
+        SEND_MATRIX,          ///< Sends a matrix uniform to the shader
+        SEND_FRAME_CONSTANTS, ///< Sends the frame constants when they can't be streamed
+        SEND_LIGHTS,          ///< Sends the lights captured when recorded to the shader
+        SEND_TEXTURE,         ///< Sends a scene texture to the diffuse sampler
+        BIND_MESH,            ///< Binds the vertex array of a mesh for the shader
+        BIND_UNIFORM_BLOCK,   ///< Binds a range of the stream buffer as a uniform block
+        BIND_STORAGE_BLOCK,   ///< Binds a range of the stream buffer as a storage block
+        BIND_INDIRECT,        ///< Binds the shared buffers of the indirect renderer
+        DRAW,                 ///< Draws a level of detail of the bound mesh
+        DRAW_INSTANCED,       ///< Draws copies of a level of detail of the bound mesh
+        DRAW_INDIRECT,        ///< Draws commands written to the stream buffer
+        MAX_COMMANDS
+    };
+
+    /**
+    * Matrix uniforms which can be sent
+    */
+    enum Matrix
+    {
+        WORLD,
+        MAX_MATRICES
+    };
+
+    /**
+    * Constants shared by every scene shader, laid out as the std140 FrameConstants block
+    */
+    struct FrameConstants
+    {
+        glm::mat4 viewProjection;    ///< View projection of the frame
+        glm::mat4 shadowProjection;  ///< Flattens world positions onto the ground then projects them
+    };
+
+    /**
+    * Render states combined for SET_STATE
+    */
+    enum State
+    {
+        BACKFACE_CULL = 1,
+        ALPHA_BLEND = 2,
+        DEPTH_WRITE = 4
+    };
+
+    /**
+    * Single recorded command, with the meaning of each value depending on the type
+    */
+    struct Command
+    {
+        Type type = MAX_COMMANDS;        ///< Type of work to do
+        int value = 0;                   ///< Shader, texture, state, matrix, binding, level or index of the first light
+        int count = 0;                   ///< Instances, indirect commands, lights or index of the matrix or constants
+        const Mesh* mesh = nullptr;      ///< Mesh to bind or draw
+        GLintptr offset = 0;             ///< Offset into the stream buffer
+        GLsizeiptr bytes = 0;            ///< Size of the range of the stream buffer
+    };
+
+    /**
+    * Constructor
+    */
+    RenderCommandList() = default;
+
+    /**
+    * Removes all commands while keeping the memory for the next recording
+    */
+    void Clear();
+
+    /**
+    * @param index The index of the shader in the scene
+    */
+    void SetShader(int index);
+
+    /**
+    * @param state The combination of State flags to enable
+    */
+    void SetState(int state);
+
+    /**
+    * @param uniform The matrix uniform to send
+    * @param matrix The value to send
+    */
+    void SendMatrix(Matrix uniform, const glm::mat4& matrix);
+
+    /**
+    * Sends the frame constants to every shader through a buffer owned by the backend
+    * @param constants The values to send
+    * @note only used when the constants can't be written into the stream buffer
+    */
+    void SendFrameConstants(const FrameConstants& constants);
+
+    /**
+    * Sends the lights to the shader as they are when recorded
+    * @param lights The scene lights to capture
+    */
+    void SendLights(const std::vector<std::unique_ptr<Light>>& lights);
+
+    /**
+    * @param texture The index of the texture in the scene
+    */
+    void SendTexture(int texture);
+
+    /**
+    * @param mesh The mesh to bind for the shader
+    */
+    void BindMesh(const Mesh& mesh);
+
+    /**
+    * @param binding The uniform block binding point
+    * @param offset The offset into the stream buffer
+    * @param bytes The size of the range
+    */
+    void BindUniformBlock(int binding, GLintptr offset, GLsizeiptr bytes);
+
+    /**
+    * @param binding The storage block binding point
+    * @param offset The offset into the stream buffer
+    * @param bytes The size of the range
+    */
+    void BindStorageBlock(int binding, GLintptr offset, GLsizeiptr bytes);
+
+    /**
+    * @param instances The number of instances the following draws read
+    */
+    void BindIndirect(int instances);
+
+    /**
+    * @param mesh The bound mesh to draw
+    * @param level The level of detail to draw
+    */
+    void Draw(const Mesh& mesh, int level);
+
+    /**
+    * @param mesh The bound mesh to draw
+    * @param level The level of detail to draw
+    * @param instances The number of copies to draw
+    */
+    void DrawInstanced(const Mesh& mesh, int level, int instances);
+
+    /**
+    * @param offset The offset of the first indirect command in the stream buffer
+    * @param commands The number of indirect commands to draw
+    */
+    void DrawIndirect(GLintptr offset, int commands);
+
+    /**
+    * @return the recorded commands in the order to execute
+    */
+    const std::vector<Command>& Commands() const;
+
+    /**
+    * @param index The index of the matrix held by a SEND_MATRIX command
+    * @return the matrix to send
+    */
+    const glm::mat4& GetMatrix(int index) const;
+
+    /**
+    * @param index The index of the constants held by a SEND_FRAME_CONSTANTS command
+    * @return the constants to send
+    */
+    const FrameConstants& GetFrameConstants(int index) const;
+
+    /**
+    * @param index The index of the light held by a SEND_LIGHTS command
+    * @return the position of the light followed by its diffuse colour
+    */
+    const glm::vec3* GetLight(int index) const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    RenderCommandList(const RenderCommandList&) = delete;
+    RenderCommandList& operator=(const RenderCommandList&) = delete;
+
+    /**
+    * Adds a command of the type
+    * @return the command to fill in
+    */
+    Command& Add(Type type);
+
+private:
+
+    std::vector<Command> m_commands;               ///< Commands in the order recorded
+    std::vector<glm::mat4> m_matrices;             ///< Matrices sent by the commands, kept apart to keep commands small
+    std::vector<glm::vec3> m_lights;               ///< Position and diffuse pairs of the lights sent by the commands
+    std::vector<FrameConstants> m_frameConstants;  ///< Frame constants sent by the commands
+};
\ No newline at end of file
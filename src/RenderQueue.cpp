@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderQueue.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+RenderQueue::RenderQueue(int capacity)
+    : m_frames(std::max(capacity, 1))
+    , m_written(0)
+    , m_released(0)
+    , m_running(true)
+    , m_sleepers(0)
+{
+    // Each frame writes into its own stream region so the GPU can still read older ones
+    for (unsigned int i = 0; i < m_frames.size(); ++i)
+    {
+        m_frames[i].region = static_cast<int>(i);
+    }
+}
+
+RenderQueue::Frame* RenderQueue::BeginWrite()
+{
+    const unsigned int written = m_written.load(std::memory_order_relaxed);
+    const unsigned int capacity = static_cast<unsigned int>(m_frames.size());
+    auto IsFull = [this, written, capacity]()
+    {
+        return written - m_released.load(std::memory_order_acquire) >= capacity;
+    };
+
+    if (IsFull())
+    {
+        Wait([&IsFull](){ return !IsFull(); });
+    }
+
+    return m_running ? &m_frames[written % capacity] : nullptr;
+}
+
+void RenderQueue::EndWrite()
+{
+    m_written.fetch_add(1, std::memory_order_release);
+    Signal();
+}
+
+const RenderQueue::Frame* RenderQueue::Read(bool wait)
+{
+    auto IsEmpty = [this]()
+    {
+        return m_read == m_written.load(std::memory_order_acquire);
+    };
+
+    if (IsEmpty())
+    {
+        if (!wait)
+        {
+            return nullptr;
+        }
+
+        Wait([&IsEmpty](){ return !IsEmpty(); });
+    }
+
+    return m_running ? &m_frames[m_read++ % m_frames.size()] : nullptr;
+}
+
+const RenderQueue::Frame* RenderQueue::Unreleased() const
+{
+    const unsigned int released = m_released.load(std::memory_order_relaxed);
+    return released != m_read ? &m_frames[released % m_frames.size()] : nullptr;
+}
+
+void RenderQueue::Release()
+{
+    m_released.fetch_add(1, std::memory_order_release);
+    Signal();
+}
+
+void RenderQueue::Stop()
+{
+    m_running = false;
+    Wake();
+}
+
+void RenderQueue::Wait(const std::function<bool(void)>& ready)
+{
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    m_sleepers.fetch_add(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in Signal so either the sleeper sees the updated 
+    // counts when checking or the other thread sees the sleeper and wakes it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_signal.wait(lock, [this, &ready](){ return ready() || !m_running; });
+
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void RenderQueue::Signal()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0)
+    {
+        Wake();
+    }
+}
+
+void RenderQueue::Wake()
+{
+    // Lock required so a thread cannot miss the signal between checking and waiting
+    {
+        std::lock_guard<std::mutex> lock(m_signalMutex);
+    }
+    m_signal.notify_all();
+}
\ No newline at end of file
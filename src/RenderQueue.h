@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderQueue.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderCommandList.h"
+#include "RenderSettings.h"
+
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/**
+* Bounded queue of frames recorded by the game thread and submitted by the render thread
+* Frames move between the two threads through atomic counters without locking, with
+* the mutex only taken by a thread about to sleep because the queue is full or empty
+* and by the other thread when it has to wake it
+* @note only safe with a single thread writing and a single thread reading
+*/
+class RenderQueue
+{
+public:
+
+    /**
+    * Frame recorded for submission
+    */
+    struct Frame
+    {
+        RenderCommandList commands;  ///< Commands for the scene pass
+        int region = 0;              ///< Stream buffer region the commands read
+        int width = 0;               ///< Window width when the frame was recorded
+        int height = 0;              ///< Window height when the frame was recorded
+        RenderSettings settings;     ///< Engine settings when the frame was recorded
+        int drawCalls = 0;           ///< Mesh draw calls recorded
+        int shadowDrawCalls = 0;     ///< Shadow draw calls recorded
+    };
+
+    /**
+    * Constructor
+    * @param capacity The number of frames which can be recorded ahead of the GPU
+    */
+    RenderQueue(int capacity);
+
+    /**
+    * Waits until a frame is released by the render thread
+    * @return the frame to record into or null if the queue has stopped
+    */
+    Frame* BeginWrite();
+
+    /**
+    * Queues the frame returned by BeginWrite for submission
+    */
+    void EndWrite();
+
+    /**
+    * Takes the oldest queued frame for submission
+    * @param wait Whether to wait for a frame if none are queued
+    * @return the frame to submit or null if none are queued or the queue has stopped
+    */
+    const Frame* Read(bool wait);
+
+    /**
+    * @return the oldest frame read but not yet released or null if there are none
+    */
+    const Frame* Unreleased() const;
+
+    /**
+    * Returns the oldest unreleased frame for recording into again
+    */
+    void Release();
+
+    /**
+    * Releases any thread waiting on the queue
+    */
+    void Stop();
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    /**
+    * Sleeps until the queue is ready or stopped
+    * @param ready Whether the queue is ready for the calling thread
+    */
+    void Wait(const std::function<bool(void)>& ready);
+
+    /**
+    * Wakes the other thread if it is sleeping on the queue
+    */
+    void Signal();
+
+    /**
+    * Wakes any thread sleeping on the queue
+    */
+    void Wake();
+
+private:
+
+    std::vector<Frame> m_frames;             ///< Frames reused in order around the ring
+    std::atomic<unsigned int> m_written;     ///< Frames queued by the game thread
+    std::atomic<unsigned int> m_released;    ///< Frames released by the render thread
+    unsigned int m_read = 0;                 ///< Frames read by the render thread, only used by it
+    std::atomic<bool> m_running;             ///< Whether waiting is allowed
+    std::atomic<int> m_sleepers;             ///< Threads sleeping or about to sleep on the queue
+    std::mutex m_signalMutex;                ///< Only taken to sleep or wake a sleeping thread
+    std::condition_variable m_signal;        ///< Signals when a frame is queued or released
+};
\ No newline at end of file
@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderSettings.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Postprocessing.h"
+#include "ResolutionScaler.h"
+
+/**
+* Engine settings read while rendering a frame
+* Captured when the frame is recorded so a render thread never reads
+* values which the gui can change on the main thread
+*/
+struct RenderSettings
+{
+    int antiAliasing = 0;                          ///< Requested anti-aliasing mode
+    int fxaaQuality = 0;                           ///< Index of the FXAA quality preset
+    PostProcessing::Map postMap = PostProcessing::FINAL_MAP; ///< Map shown by post processing
+    bool nullBackend = false;                      ///< Whether to count the scene commands instead of executing them
+    bool callChecking = false;                     ///< Whether each call is checked with glGetError
+    ResolutionScaler::Settings resolution;         ///< How the scene resolution follows the frame time
+};
\ No newline at end of file
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderSnapshot.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RenderSnapshot.h"
+
+#include <utility>
+
+SnapshotBuffer::SnapshotBuffer() = default;
+
+RenderSnapshot& SnapshotBuffer::GetWriteSnapshot()
+{
+    // Only the simulation modifies the write index so no lock is required
+    return m_snapshots[m_write];
+}
+
+void SnapshotBuffer::Publish()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::swap(m_write, m_ready);
+    m_published = true;
+}
+
+const RenderSnapshot& SnapshotBuffer::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_published)
+        {
+            std::swap(m_read, m_ready);
+            m_published = false;
+        }
+    }
+    m_acquired.notify_all();
+
+    // Only the renderer modifies the read index so no lock is required
+    return m_snapshots[m_read];
+}
+
+bool SnapshotBuffer::WaitForAcquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_acquired.wait(lock, [this](){ return !m_published || !m_running; });
+    return m_running;
+}
+
+void SnapshotBuffer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_acquired.notify_all();
+}
\ No newline at end of file
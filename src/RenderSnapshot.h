@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderSnapshot.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Mesh.h"
+
+#include <array>
+#include <mutex>
+#include <condition_variable>
+
+/**
+* Immutable copy of the scene state required to render a frame
+* Allows rendering a frame while the next is being simulated
+*/
+struct RenderSnapshot
+{
+    glm::mat4 viewProjection;                ///< Camera view projection matrix
+    glm::mat4 projection;                    ///< Camera projection matrix
+    glm::vec3 cameraPosition;                ///< Camera position in world space
+    std::vector<Mesh::RenderStates> meshes;  ///< Visible instances for each scene mesh
+    std::vector<Mesh::RenderStates> effects; ///< Visible instances for each scene effect
+};
+
+/**
+* Triple buffered handoff of snapshots between the simulation and renderer
+* The simulation fills the write snapshot while the renderer uses the read snapshot
+*/
+class SnapshotBuffer
+{
+public:
+
+    /**
+    * Constructor
+    */
+    SnapshotBuffer();
+
+    /**
+    * @return the snapshot to be filled by the simulation
+    */
+    RenderSnapshot& GetWriteSnapshot();
+
+    /**
+    * Makes the write snapshot available to the renderer
+    */
+    void Publish();
+
+    /**
+    * Swaps in the latest published snapshot if one is available
+    * @return the snapshot to render
+    */
+    const RenderSnapshot& Acquire();
+
+    /**
+    * Blocks until the renderer has acquired the last published snapshot
+    * Prevents the simulation running more than a frame ahead of rendering
+    * @return whether the buffer is still running
+    */
+    bool WaitForAcquire();
+
+    /**
+    * Releases any thread waiting on the buffer
+    */
+    void Stop();
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+private:
+
+    std::array<RenderSnapshot, 3> m_snapshots;  ///< Buffered snapshots
+    int m_write = 0;                            ///< Snapshot being filled by the simulation
+    int m_ready = 1;                            ///< Most recently published snapshot
+    int m_read = 2;                             ///< Snapshot being rendered
+    bool m_published = false;                   ///< Whether the ready snapshot is unread
+    bool m_running = true;                      ///< Whether waiting is allowed
+    std::mutex m_mutex;                         ///< Protects the buffer indices
+    std::condition_variable m_acquired;         ///< Signals when a snapshot is acquired
+};
\ No newline at end of file
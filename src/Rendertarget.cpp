@@ -13,9 +13,11 @@ RenderTarget::RenderTarget(const std::string& name)
 
 RenderTarget::RenderTarget(const std::string& name, 
                            int textures, 
-                           bool multisampled) :
+                           bool multisampled,
+                           bool depth) :
 
     m_multisampled(multisampled),
+    m_hasDepth(depth),
     m_name(name),
     m_count(textures)
 {
@@ -35,6 +37,7 @@ void RenderTarget::Release()
         glDeleteFramebuffers(1, &m_frameBuffer);
         for (GLuint texture : m_textures)
         {
+            ForgetTextureBinding(texture);
             glDeleteTextures(1, &texture);
         }
         glDeleteRenderbuffers(1, &m_renderBuffer);
@@ -47,8 +50,32 @@ GLuint RenderTarget::GetTexture(int index) const
     return m_textures[index];
 }
 
-bool RenderTarget::Initialise()
+bool RenderTarget::Resize(int width, int height)
 {
+    Release();
+    return Initialise(width, height);
+}
+
+int RenderTarget::Width() const
+{
+    return m_width;
+}
+
+int RenderTarget::Height() const
+{
+    return m_height;
+}
+
+int RenderTarget::ScaledSize(int size, float scale)
+{
+    return std::max(1, static_cast<int>(size * scale + 0.5f));
+}
+
+bool RenderTarget::Initialise(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
     if(!m_isBackBuffer)
     {
         glGenFramebuffers(1, &m_frameBuffer);
@@ -82,27 +109,30 @@ bool RenderTarget::Initialise()
         }
 
         // Create the render buffer to hold depth information
-        glGenRenderbuffers(1, &m_renderBuffer);
-        glBindRenderbuffer(GL_RENDERBUFFER, m_renderBuffer);
-
-        if (m_multisampled)
-        {
-            glRenderbufferStorageMultisample(GL_RENDERBUFFER, MULTISAMPLING_COUNT, 
-                GL_DEPTH_COMPONENT24, WINDOW_WIDTH, WINDOW_HEIGHT);
-        }
-        else
+        if (m_hasDepth)
         {
-            glRenderbufferStorage(GL_RENDERBUFFER,
-                GL_DEPTH_COMPONENT24, WINDOW_WIDTH, WINDOW_HEIGHT);
-        }
+            glGenRenderbuffers(1, &m_renderBuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, m_renderBuffer);
+
+            if (m_multisampled)
+            {
+                glRenderbufferStorageMultisample(GL_RENDERBUFFER, MULTISAMPLING_COUNT, 
+                    GL_DEPTH_COMPONENT24, m_width, m_height);
+            }
+            else
+            {
+                glRenderbufferStorage(GL_RENDERBUFFER,
+                    GL_DEPTH_COMPONENT24, m_width, m_height);
+            }
 
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, 
-            GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_renderBuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, 
+                GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_renderBuffer);
 
-        if(HasCallFailed())
-        {
-            LogError(m_name + " Failed to create depth texture");
-            return false;
+            if(HasCallFailed())
+            {
+                LogError(m_name + " Failed to create depth texture");
+                return false;
+            }
         }
 
         if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
@@ -119,17 +149,17 @@ bool RenderTarget::Initialise()
 bool RenderTarget::CreateTexture(GLuint& id, unsigned int type)
 {
     glGenTextures(1, &id);
-    glBindTexture(type, id);
+    BindTexture(0, type, id);
 
     if (m_multisampled)
     {
         glTexImage2DMultisample(type, MULTISAMPLING_COUNT, 
-            GL_RGBA, WINDOW_WIDTH, WINDOW_HEIGHT, GL_TRUE);  
+            GL_RGBA, m_width, m_height, GL_TRUE);  
     }
     else
     {
-        glTexImage2D(type, 0, GL_RGBA, WINDOW_WIDTH,
-            WINDOW_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexImage2D(type, 0, GL_RGBA, m_width,
+            m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -149,11 +179,12 @@ bool RenderTarget::IsMultisampled() const
     return m_multisampled;
 }
 
-void RenderTarget::SetActive()
+void RenderTarget::SetActive(float scale)
 {
     assert(m_initialised);
 
     m_multisampled ? glEnable(GL_MULTISAMPLE) : glDisable(GL_MULTISAMPLE); 
+    glViewport(0, 0, ScaledSize(m_width, scale), ScaledSize(m_height, scale));
 
     if(m_isBackBuffer)
     {
@@ -164,10 +195,10 @@ void RenderTarget::SetActive()
     }
     else
     {
-        glEnable(GL_DEPTH_TEST);
+        m_hasDepth ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
         glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
         glBindRenderbuffer(GL_RENDERBUFFER, m_renderBuffer);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glClear(m_hasDepth ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT);
         glDrawBuffers(m_count, &m_attachments[0]);
     }
 
@@ -177,6 +208,62 @@ void RenderTarget::SetActive()
     }
 }
 
+void RenderTarget::CopyTo(const RenderTarget& target, float scale) const
+{
+    assert(m_initialised && target.m_initialised);
+
+    // Blitting resolves multisampling in the driver rather than per pixel in a shader
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_frameBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.m_frameBuffer);
+
+    const int width = ScaledSize(m_width, scale);
+    const int height = ScaledSize(m_height, scale);
+    const int count = std::min(m_count, target.m_count);
+    for (int i = 0; i < count; ++i)
+    {
+        glReadBuffer(m_attachments[i]);
+        glDrawBuffer(target.m_attachments[i]);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, 
+            width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(HasCallFailed())
+    {
+        LogError("Could not copy " + m_name + " to " + target.m_name);
+    }
+}
+
+bool RenderTarget::ReadPixels(std::vector<unsigned char>& pixels) const
+{
+    assert(m_initialised && !m_multisampled);
+
+    const int rowSize = m_width * 4;
+    pixels.resize(rowSize * m_height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_frameBuffer);
+    glReadBuffer(m_isBackBuffer ? GL_BACK : m_attachments[0]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(HasCallFailed())
+    {
+        LogError("Could not read pixels of " + m_name);
+        return false;
+    }
+
+    // OpenGL reads from the bottom row up
+    for (int row = 0; row < m_height / 2; ++row)
+    {
+        std::swap_ranges(pixels.begin() + row * rowSize,
+                         pixels.begin() + (row + 1) * rowSize,
+                         pixels.begin() + (m_height - row - 1) * rowSize);
+    }
+    return true;
+}
+
 unsigned int RenderTarget::GetTextureAttachment(int index) const
 {
     switch (index)
@@ -28,10 +28,12 @@ public:
     * @param name Name of the render target
     * @param textures The number of textures attached to this target
     * @param multisampled Whether this target has multisampling
+    * @param depth Whether this target has a depth buffer
     */
     RenderTarget(const std::string& name, 
                  int textures, 
-                 bool multisampled);
+                 bool multisampled,
+                 bool depth = true);
 
     /**
     * Destructor
@@ -45,14 +47,51 @@ public:
 
     /**
     * Initialises the render target
+    * @param width The width of the target in pixels
+    * @param height The height of the target in pixels
     * @return whether initialisation succeeded or not
     */
-    bool Initialise();
+    bool Initialise(int width, int height);
+
+    /**
+    * Recreates the render target at a new size
+    * @param width The width of the target in pixels
+    * @param height The height of the target in pixels
+    * @return whether initialisation succeeded or not
+    */
+    bool Resize(int width, int height);
 
     /**
     * Sets the render target as activated and clears it
+    * @param scale The fraction of the target to render into
+    */
+    void SetActive(float scale = 1.0f);
+
+    /**
+    * Copies the textures into another target, resolving any multisampling
+    * @param target The target to copy into, must be the same size
+    * @param scale The fraction of the target to copy
+    */
+    void CopyTo(const RenderTarget& target, float scale = 1.0f) const;
+
+    /**
+    * Reads back the first texture of the target
+    * @param pixels Filled with four bytes for each pixel with the top row first
+    * @return whether the pixels could be read
+    * @note stalls until the GPU has finished rendering to the target
+    * @note multisampled targets must be copied to a resolved target first
     */
-    void SetActive();
+    bool ReadPixels(std::vector<unsigned char>& pixels) const;
+
+    /**
+    * @return the width of the target in pixels
+    */
+    int Width() const;
+
+    /**
+    * @return the height of the target in pixels
+    */
+    int Height() const;
 
     /**
     * @return the ID of the target texture
@@ -72,6 +111,13 @@ private:
     RenderTarget(const RenderTarget&) = delete;
     RenderTarget& operator=(const RenderTarget&) = delete;
 
+    /**
+    * @param size The full size of the target in pixels
+    * @param scale The fraction of the target used
+    * @return the number of pixels used
+    */
+    static int ScaledSize(int size, float scale);
+
     /**
     * @param index The index of the texture
     * @return the OpenGL Attachement ID for the texture
@@ -92,6 +138,9 @@ private:
     const int m_count = 0;              ///< Number of textures attached to this buffer
     const bool m_isBackBuffer = false;  ///< Whether this render target is the back buffer
     const bool m_multisampled = false;  ///< Whether this target has multisampling
+    const bool m_hasDepth = false;      ///< Whether this target has a depth buffer
+    int m_width = 0;                    ///< Width of the textures in pixels
+    int m_height = 0;                   ///< Height of the textures in pixels
     const std::string m_name;           ///< Name of the render target
     std::vector<GLuint> m_textures;     ///< Unique IDs of the main attached textures
     std::vector<GLenum> m_attachments;  ///< Container of attachment slots taken up
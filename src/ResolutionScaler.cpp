@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - ResolutionScaler.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ResolutionScaler.h"
+#include "Tweaker.h"
+#include "Utils.h"
+
+#include <cmath>
+
+namespace
+{
+    const float MIN_SCALE = 0.5f;   ///< Lowest fraction of the window resolution rendered
+    const float MAX_SCALE = 1.0f;   ///< Highest fraction of the window resolution rendered
+    const float HEADROOM = 0.9f;    ///< Fraction of the target aimed for to absorb spikes
+    const float SMOOTHING = 0.1f;   ///< Fraction of the change applied each frame
+}
+
+void ResolutionScaler::AddToTweaker(Tweaker& tweaker)
+{
+    tweaker.AddEntry("Dynamic Resolution", &m_settings.enabled, TW_TYPE_BOOLCPP);
+    tweaker.AddFltEntry("Target Frame ms", &m_settings.targetMilliseconds, 0.5f, 1);
+
+    // Only written by the thread rendering so can't be edited from the gui
+    tweaker.AddEntry("Resolution Scale", &m_scale, TW_TYPE_FLOAT, true);
+}
+
+void ResolutionScaler::Update(float gpuMilliseconds, const Settings& settings)
+{
+    if (!settings.enabled || gpuMilliseconds <= 0.0f)
+    {
+        return;
+    }
+
+    // Pixel cost grows with area so the scale moves by the square root of the ratio
+    const float ratio = settings.targetMilliseconds * HEADROOM / gpuMilliseconds;
+    const float desired = m_scale * std::sqrt(ratio);
+
+    // Timings lag a few frames behind so only part of the change is applied
+    m_scale = Clamp(m_scale + (desired - m_scale) * SMOOTHING, MIN_SCALE, MAX_SCALE);
+}
+
+const ResolutionScaler::Settings& ResolutionScaler::GetSettings() const
+{
+    return m_settings;
+}
+
+void ResolutionScaler::SetEnabled(bool enabled)
+{
+    m_settings.enabled = enabled;
+}
+
+float ResolutionScaler::Scale() const
+{
+    return Clamp(m_scale, MIN_SCALE, MAX_SCALE);
+}
\ No newline at end of file
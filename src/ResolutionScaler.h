@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - ResolutionScaler.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class Tweaker;
+
+/**
+* Scales the resolution the scene is rendered at to hold a target GPU frame time
+*/
+class ResolutionScaler
+{
+public:
+
+    /**
+    * Settings tweaked by the gui, passed into each update so the scale can
+    * be updated on a different thread to the one the settings change on
+    */
+    struct Settings
+    {
+        bool enabled = true;                         ///< Whether the scale follows the frame time
+        float targetMilliseconds = 1000.0f / 60.0f;  ///< GPU frame time to hold
+    };
+
+    /**
+    * Constructor
+    */
+    ResolutionScaler() = default;
+
+    /**
+    * Adds data for this element to be tweaked by the gui
+    * @param tweaker The helper for adding tweakable entries
+    */
+    void AddToTweaker(Tweaker& tweaker);
+
+    /**
+    * Moves the scale towards the resolution which meets the target frame time
+    * @param gpuMilliseconds The GPU time taken by a recent frame
+    * @param settings The settings captured with the frame
+    */
+    void Update(float gpuMilliseconds, const Settings& settings);
+
+    /**
+    * @return the settings to capture with the next frame
+    */
+    const Settings& GetSettings() const;
+
+    /**
+    * Sets whether the scale follows the frame time or is held
+    * @param enabled Whether to scale the resolution
+    */
+    void SetEnabled(bool enabled);
+
+    /**
+    * @return the fraction of the window resolution to render the scene at
+    */
+    float Scale() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    ResolutionScaler(const ResolutionScaler&) = delete;
+    ResolutionScaler& operator=(const ResolutionScaler&) = delete;
+
+private:
+
+    Settings m_settings;                         ///< Settings tweaked by the gui
+    float m_scale = 1.0f;                        ///< Fraction of the window resolution rendered
+};
\ No newline at end of file
@@ -5,8 +5,11 @@
 #include "Scene.h"
 #include "SceneBuilder.h"
 #include "SceneData.h"
+#include "RenderSnapshot.h"
 #include "Tweaker.h"
 
+#include <algorithm>
+
 Scene::Scene()
     : m_data(std::make_unique<SceneData>())
 {
@@ -14,18 +17,55 @@ Scene::Scene()
 
 Scene::~Scene() = default;
 
-void Scene::Tick()
+JobSystem::JobID Scene::AddTickJobs(JobSystem& jobs, 
+                                    const JobSystem::Dependencies& dependencies)
 {
+    // Meshes are split so the many instances of a single mesh are spread across threads
+    m_tickRanges.clear();
     for (auto& mesh : m_data->meshes)
     {
-        mesh->Tick();
+        const int instances = mesh->Instances();
+        for (int begin = 0; begin < instances; begin += InstanceTransforms::RANGE_SIZE)
+        {
+            TickRange range;
+            range.mesh = mesh.get();
+            range.begin = begin;
+            range.end = std::min(begin + InstanceTransforms::RANGE_SIZE, instances);
+            m_tickRanges.push_back(range);
+        }
+    }
+
+    const int grain = 1;
+    auto& ranges = m_tickRanges;
+
+    return jobs.AddParallelFor("Scene Transforms", 
+        static_cast<int>(ranges.size()), grain, [&ranges](int index)
+        {
+            ranges[index].mesh->Tick(ranges[index].begin, ranges[index].end);
+        }, dependencies);
+}
+
+void Scene::FillSnapshot(RenderSnapshot& snapshot) const
+{
+    snapshot.meshes.resize(m_data->meshes.size());
+    for (unsigned int i = 0; i < m_data->meshes.size(); ++i)
+    {
+        m_data->meshes[i]->GetRenderStates(snapshot.meshes[i]);
+    }
+
+    snapshot.effects.resize(m_data->effects.size());
+    for (unsigned int i = 0; i < m_data->effects.size(); ++i)
+    {
+        m_data->effects[i]->GetRenderStates(snapshot.effects[i]);
     }
 }
 
-bool Scene::Initialise(PhysicsEngine& physics)
+bool Scene::Initialise(PhysicsEngine& physics, 
+                       JobSystem& jobs, 
+                       const SceneSettings& settings)
 {
     SceneBuilder builder;
-    if (!builder.Initialise(*m_data, physics))
+    if (!builder.Initialise(*m_data, physics, jobs, settings))
     {
         return false;
     }
@@ -10,11 +10,15 @@
 #include <functional>
 
 #include "Postprocessing.h"
+#include "JobSystem.h"
+#include "SceneSettings.h"
 
 class Camera;
+class Mesh;
 class PhysicsEngine;
 class Tweaker;
 struct SceneData;
+struct RenderSnapshot;
 
 /**
 * Manager and owner of all objects
@@ -34,16 +38,30 @@ public:
     ~Scene();
 
     /**
-    * Ticks the scene
+    * Adds the jobs to tick the scene
+    * @param jobs The job system to add to
+    * @param dependencies Jobs which must complete before the scene ticks
+    * @return the ID of the final job
     */
-    void Tick();
+    JobSystem::JobID AddTickJobs(JobSystem& jobs, 
+                                 const JobSystem::Dependencies& dependencies);
+
+    /**
+    * Copies the state of all visible instances required for rendering
+    * @param snapshot The snapshot to fill
+    */
+    void FillSnapshot(RenderSnapshot& snapshot) const;
 
     /**
     * Initialises the scene
     * @param physics The physics engine
+    * @param jobs Decodes asset files across threads
+    * @param settings Options for building the scene
     * @return whether initialisation was successful
     */
-    bool Initialise(PhysicsEngine& physics);
+    bool Initialise(PhysicsEngine& physics, 
+                    JobSystem& jobs,
+                    const SceneSettings& settings = SceneSettings());
 
     /**
     * Adds data for this element to be tweaked by the gui
@@ -76,10 +94,21 @@ private:
     Scene(const Scene&) = delete;
     Scene& operator=(const Scene&) = delete;
 
+    /**
+    * Range of instances of a mesh ticked by a single task
+    */
+    struct TickRange
+    {
+        Mesh* mesh = nullptr;  ///< The mesh to tick
+        int begin = 0;         ///< First instance to tick
+        int end = 0;           ///< One past the last instance to tick
+    };
+
 private:
 
-    std::unique_ptr<SceneData> m_data;  ///< Elements of the scene
-    int m_selectedLight = 0;            ///< Currently selected light in the tweak bar
-    int m_selectedMesh = 0;             ///< Currently selected mesh in the tweak bar
-    int m_selectedHull = 0;             ///< Currently selected hull in the tweak bar
+    std::unique_ptr<SceneData> m_data;    ///< Elements of the scene
+    int m_selectedLight = 0;              ///< Currently selected light in the tweak bar
+    int m_selectedMesh = 0;               ///< Currently selected mesh in the tweak bar
+    int m_selectedHull = 0;               ///< Currently selected hull in the tweak bar
+    std::vector<TickRange> m_tickRanges;  ///< Instance ranges ticked across threads
 }; 
@@ -8,8 +8,11 @@
 #include "PhysicsEngine.h"
 #include "ToonText.h"
 #include "MeshFile.h"
+#include "JobSystem.h"
 #include "Utils.h"
 
+#include <chrono>
+
 namespace
 {
     /**
@@ -21,16 +24,78 @@ namespace
 SceneBuilder::SceneBuilder() = default;
 SceneBuilder::~SceneBuilder() = default;
 
-bool SceneBuilder::Initialise(SceneData& data, PhysicsEngine& physics)
+bool SceneBuilder::Initialise(SceneData& data, 
+                              PhysicsEngine& physics,
+                              JobSystem& jobs,
+                              const SceneSettings& settings)
 {
+    m_settings = settings;
     data.post = std::make_unique<PostProcessing>();
+
+    // Only the simulation is required when running without a window
+    if (m_settings.headless)
+    {
+        return InitialiseLighting(data) &&
+               InitialiseMeshes(data) &&
+               InitialiseEffects(data) &&
+               InitialiseHulls(data, physics) &&
+               LoadAssets(jobs);
+    }
+
     return InitialiseLighting(data) &&
            InitialiseTextures(data) &&
            InitialiseShaderConstants(data) &&
            InitialiseShaders(data) &&
            InitialiseMeshes(data) &&
            InitialiseEffects(data) &&
-           InitialiseHulls(data, physics);
+           InitialiseHulls(data, physics) &&
+           LoadAssets(jobs);
+}
+
+void SceneBuilder::AddAsset(AssetFn load, AssetFn upload)
+{
+    m_assets.emplace_back(load, upload);
+}
+
+bool SceneBuilder::LoadAssets(JobSystem& jobs)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    auto GetMilliseconds = [](Clock::time_point start, Clock::time_point end)
+    {
+        return std::to_string(std::chrono::duration_cast<
+            std::chrono::milliseconds>(end - start).count());
+    };
+
+    const int count = static_cast<int>(m_assets.size());
+    std::vector<char> loaded(count, false);
+    const auto start = Clock::now();
+
+    // Decoding files does not require the OpenGL context so is spread across all threads
+    jobs.AddParallelFor("Asset Decode", count, 1, [this, &loaded](int index)
+    {
+        const auto& load = m_assets[index].first;
+        loaded[index] = !load || load();
+    });
+    jobs.Execute();
+
+    const auto decoded = Clock::now();
+
+    // Uploading is done in the order assets were added on the thread that owns the context
+    bool success = true;
+    for (int i = 0; i < count; ++i)
+    {
+        const auto& upload = m_assets[i].second;
+        success &= loaded[i] && (!upload || upload());
+    }
+
+    const auto uploaded = Clock::now();
+
+    LogInfo("SceneBuilder: Decoded " + std::to_string(count) + " assets in " + 
+        GetMilliseconds(start, decoded) + "ms across " + std::to_string(jobs.Threads()) + 
+        " threads, uploaded in " + GetMilliseconds(decoded, uploaded) + "ms");
+
+    m_assets.clear();
+    return success;
 }
 
 bool SceneBuilder::InitialiseLighting(SceneData& data)
@@ -44,27 +109,76 @@ bool SceneBuilder::InitialiseLighting(SceneData& data)
 
 bool SceneBuilder::InitialiseShaderConstants(SceneData& data)
 {
-    Shader::ShaderConstants constants = 
+    m_shaderConstants = 
     {
         std::make_pair("MAX_LIGHTS", std::to_string(LightID::MAX)),
-        std::make_pair("WINDOW_WIDTH", std::to_string(WINDOW_WIDTH)),
-        std::make_pair("WINDOW_HEIGHT", std::to_string(WINDOW_HEIGHT)),
         std::make_pair("SAMPLES", std::to_string(MULTISAMPLING_COUNT)),
         std::make_pair("SCENE_TEXTURES", std::to_string(SCENE_TEXTURES)),
         std::make_pair("ID_COLOUR", std::to_string(ID_COLOUR)),
-        std::make_pair("ID_NORMAL", std::to_string(ID_NORMAL))
+        std::make_pair("ID_NORMAL", std::to_string(ID_NORMAL)),
+        std::make_pair("INSTANCE_BINDING", std::to_string(INSTANCE_BINDING)),
+        std::make_pair("FRAME_BINDING", std::to_string(FRAME_BINDING)),
+        std::make_pair("FINAL_MAP", std::to_string(PostProcessing::FINAL_MAP)),
+        std::make_pair("SCENE_MAP", std::to_string(PostProcessing::SCENE_MAP)),
+        std::make_pair("NORMAL_MAP", std::to_string(PostProcessing::NORMAL_MAP)),
+        std::make_pair("TOONLINE_MAP", std::to_string(PostProcessing::TOONLINE_MAP))
     };
 
-    Shader::InitialiseConstants(constants);
+    // Diffuse textures are sampled from an array by the layer of each instance
+    if (m_settings.textureArrays)
+    {
+        m_shaderConstants.emplace_back("TEXTURE_ARRAYS", "1");
+        m_shaderConstants.emplace_back("LAYER_BINDING", std::to_string(LAYER_BINDING));
+    }
+
     return true;
 }
 
 bool SceneBuilder::InitialiseShaders(SceneData& data)
 {
-    auto Initialise = [&data](std::string name, ShaderID::ID ID) -> bool
+    auto InitialiseWith = [this, &data](std::string name, 
+                                        std::string vertex,
+                                        std::string fragment, 
+                                        ShaderID::ID ID,
+                                        const Shader::ShaderConstants& constants) -> bool
+    {
+        data.shaders[ID] = std::make_unique<Shader>(name, 
+            ASSETS_PATH + vertex, ASSETS_PATH + fragment, constants);
+
+        Shader& shader = *data.shaders[ID];
+        AddAsset([&shader]() { return shader.Load(); },
+                 [&shader]() { return shader.Initialise(); });
+        return true;
+    };
+
+    auto Initialise = [this, &InitialiseWith](std::string name, ShaderID::ID ID) -> bool
+    {
+        return InitialiseWith(name, name, name, ID, m_shaderConstants);
+    };
+
+    // Shaders for features the context may not support, left null if they can't be built
+    auto InitialiseOptional = [this, &data](std::string name, 
+                                            std::string vertex,
+                                            std::string fragment, 
+                                            ShaderID::ID ID,
+                                            int version) -> bool
     {
-        data.shaders[ID] = std::make_unique<Shader>(name, ASSETS_PATH + name);
-        return data.shaders[ID]->Initialise();
+        data.shaders[ID] = std::make_unique<Shader>(name, 
+            ASSETS_PATH + vertex, ASSETS_PATH + fragment, m_shaderConstants);
+
+        Shader& shader = *data.shaders[ID];
+        AddAsset([&shader]() { return shader.Load(); },
+                 [&shader, &data, ID, version]()
+        {
+            const int contextVersion = ogl_GetMajorVersion() * 10 + ogl_GetMinorVersion();
+            if (contextVersion < version || !shader.Initialise())
+            {
+                LogInfo("SceneBuilder: " + shader.Name() + " not supported by the context");
+                data.shaders[ID].reset();
+            }
+            return true;
+        });
+        return true;
     };
 
     bool success = true;
@@ -74,9 +188,38 @@ bool SceneBuilder::InitialiseShaders(SceneData& data)
     success &= Initialise("shadow", ShaderID::SHADOW);
     success &= Initialise("toon", ShaderID::TOON);
     success &= Initialise("texture", ShaderID::TEXTURE);
-    success &= Initialise("post", ShaderID::POST);
     success &= Initialise("gradient", ShaderID::GRADIENT);
 
+    // Reads the instance data from a buffer but shades the same as toon
+    success &= InitialiseOptional("toonindirect", "toonindirect", "toon", 
+        ShaderID::TOON_INDIRECT, 43);
+
+    // Reads the instance data from a buffer but shades the same as shadow
+    success &= InitialiseOptional("shadowinstanced", "shadowinstanced", "shadow", 
+        ShaderID::SHADOW_INSTANCED, 43);
+
+    // Toon lines are found in their own pass so they can run at a lower resolution
+    success &= InitialiseWith("toonline", "post", "toonline", 
+        ShaderID::TOONLINE, m_shaderConstants);
+
+    success &= InitialiseWith("fxaa", "post", "fxaa", 
+        ShaderID::FXAA, m_shaderConstants);
+
+    // Each map is its own permutation so the final image doesn't pay for the others
+    const std::string postNames[PostProcessing::MAX_MAPS] = 
+    { 
+        "post", "postscene", "postnormal", "posttoonline" 
+    };
+
+    for (int map = 0; map < PostProcessing::MAX_MAPS; ++map)
+    {
+        auto constants = m_shaderConstants;
+        constants.emplace_back("POST_MAP", std::to_string(map));
+
+        success &= InitialiseWith(postNames[map], "post", "post", 
+            static_cast<ShaderID::ID>(ShaderID::POST + map), constants);
+    }
+
     return success;
 }
 
@@ -85,11 +228,17 @@ bool SceneBuilder::InitialiseTextures(SceneData& data)
     bool success = true;
     data.textures.resize(TextureID::MAX);
 
-    auto Initialise = [&data](std::string name, TextureID::ID ID, Texture::Filter filter) -> bool
+    auto Initialise = [this, &data](std::string name, TextureID::ID ID, Texture::Filter filter) -> bool
     {
         data.textures[ID] = std::make_unique<Texture>(
             name, ASSETS_PATH + name, filter);
-        return data.textures[ID]->Initialise();
+
+        // Packed textures are uploaded together once all have been decoded
+        Texture& texture = *data.textures[ID];
+        AddAsset([&texture]() { return texture.Load(); },
+                 m_settings.textureArrays ? AssetFn() : 
+                 [&texture]() { return texture.Initialise(); });
+        return true;
     };
 
     success &= Initialise("border.png", TextureID::BORDER, Texture::NEAREST);
@@ -118,6 +267,14 @@ bool SceneBuilder::InitialiseTextures(SceneData& data)
     success &= Initialise("wallUV.png", TextureID::WALL, Texture::ANISOTROPIC);
     success &= Initialise("bullet.png", TextureID::BULLET, Texture::NEAREST);
 
+    if (m_settings.textureArrays)
+    {
+        AddAsset(nullptr, [&data]()
+        {
+            return TextureArray::Build(data.textures, data.textureArrays);
+        });
+    }
+
     return true;
 }
 
@@ -133,7 +290,7 @@ bool SceneBuilder::InitialiseEffects(SceneData& data)
     toonText->SetBackfaceCull(false);
     toonText->SetDepthWrite(false);
     toonText->SetAlphaBlending(true);
-    success &= toonText->Initialise(toonTextCount);
+    success &= toonText->Initialise(toonTextCount, !m_settings.headless);
     for (int i = 0; i < toonTextCount; ++i)
     {
         toonText->SetTexture(TextureID::TOON_TEXT, i);
@@ -150,57 +307,110 @@ bool SceneBuilder::InitialiseMeshes(SceneData& data)
     const int NO_TEXTURE = -1;
     data.meshes.resize(MeshID::MAX);
 
-    auto Initialise = [&data, NO_TEXTURE](const std::string& name, 
-                                          int meshID, 
-                                          int shaderID, 
-                                          int textureID, 
-                                          int instances, 
-                                          bool shadows) -> bool
+    const bool createBuffers = !m_settings.headless;
+    const int tanks = m_settings.tanks;
+    const int bullets = m_settings.bullets;
+    const int player = tanks - 1;
+
+    const auto importer = m_settings.useAssimp ? MeshFile::ASSIMP : MeshFile::NATIVE;
+
+    auto Initialise = [this, &data, NO_TEXTURE, createBuffers, importer](const std::string& name, 
+                                                                         int meshID, 
+                                                                         int shaderID, 
+                                                                         int textureID, 
+                                                                         int instances, 
+                                                                         bool shadows,
+                                                                         bool levelsOfDetail) -> bool
     {
         auto mesh = std::make_unique<MeshFile>(name, shaderID);
         mesh->SetRenderShadows(shadows);
-        if (mesh->InitialiseFromFile(
-            ASSETS_PATH + name + ".obj", true, true, instances))
+        mesh->SetImporter(importer);
+        mesh->SetReduceOverdraw(true); // All scene meshes are opaque
+        mesh->SetGenerateLevelsOfDetail(levelsOfDetail);
+
+        MeshFile& file = *mesh;
+        data.meshes[meshID] = std::move(mesh);
+
+        AddAsset([&file, name]()
+        {
+            return file.LoadFromFile(ASSETS_PATH + name + ".obj", true, true);
+        },
+        [&file, NO_TEXTURE, createBuffers, textureID, instances]()
         {
+            if (!file.Initialise(instances, createBuffers))
+            {
+                return false;
+            }
+
             if (textureID != NO_TEXTURE)
             {
                 for (int i = 0; i < instances; ++i)
                 {
-                    mesh->SetTexture(textureID, i);
+                    file.SetTexture(textureID, i);
                 }            
             }
-            data.meshes[meshID] = std::move(mesh);
             return true;
-        }
-        return false;
+        });
+        return true;
     };
 
-    success &= Initialise("bullet", MeshID::BULLET, ShaderID::TOON, TextureID::BULLET, Instance::BULLETS, true);
-    success &= Initialise("tank", MeshID::TANK, ShaderID::TOON, TextureID::TANK_NPC_BODY, Instance::TANKS, true);
-    success &= Initialise("tankgun", MeshID::TANKGUN, ShaderID::TOON, TextureID::TANK_NPC_GUN, Instance::TANKS, true);
-    success &= Initialise("ground", MeshID::GROUND, ShaderID::TOON, TextureID::GROUND, Instance::GROUND, false);
-    success &= Initialise("wall", MeshID::WALL, ShaderID::TOON, TextureID::WALL, Instance::WALLS, false);
-    success &= Initialise("wallbox", MeshID::WALLBOX, ShaderID::TOON, TextureID::BOX, Instance::WALLS, false);
-    success &= Initialise("tankp1", MeshID::TANKP1, ShaderID::TOON, TextureID::TANK_NPC_BODY, Instance::TANKS, true);
-    success &= Initialise("tankp2", MeshID::TANKP2, ShaderID::TOON, TextureID::TANK_NPC_BODY, Instance::TANKS, true);
-    success &= Initialise("tankp3", MeshID::TANKP3, ShaderID::TOON, TextureID::TANK_NPC_BODY, Instance::TANKS, true);
-    success &= Initialise("tankp4", MeshID::TANKP4, ShaderID::TOON, TextureID::TANK_NPC_GUN, Instance::TANKS, true);
+    success &= Initialise("bullet", MeshID::BULLET, ShaderID::TOON, TextureID::BULLET, bullets, true, false);
+    success &= Initialise("tank", MeshID::TANK, ShaderID::TOON, TextureID::TANK_NPC_BODY, tanks, true, true);
+    success &= Initialise("tankgun", MeshID::TANKGUN, ShaderID::TOON, TextureID::TANK_NPC_GUN, tanks, true, true);
+    success &= Initialise("ground", MeshID::GROUND, ShaderID::TOON, TextureID::GROUND, Instance::GROUND, false, false);
+    success &= Initialise("wall", MeshID::WALL, ShaderID::TOON, TextureID::WALL, Instance::WALLS, false, false);
+    success &= Initialise("wallbox", MeshID::WALLBOX, ShaderID::TOON, TextureID::BOX, Instance::WALLS, false, false);
+    success &= Initialise("tankp1", MeshID::TANKP1, ShaderID::TOON, TextureID::TANK_NPC_BODY, tanks, true, true);
+    success &= Initialise("tankp2", MeshID::TANKP2, ShaderID::TOON, TextureID::TANK_NPC_BODY, tanks, true, true);
+    success &= Initialise("tankp3", MeshID::TANKP3, ShaderID::TOON, TextureID::TANK_NPC_BODY, tanks, true, true);
+    success &= Initialise("tankp4", MeshID::TANKP4, ShaderID::TOON, TextureID::TANK_NPC_GUN, tanks, true, true);
+
+    // Shadows are flattened so lower detail meshes give the same outline
+    data.shadows.resize(ShadowID::MAX);
+    auto InitialiseShadow = [this, &data, createBuffers, importer](const std::string& name, 
+                                                                   int shadowID, 
+                                                                   int meshID) -> bool
+    {
+        auto mesh = std::make_unique<MeshFile>(name, ShaderID::SHADOW);
+        mesh->SetImporter(importer);
+
+        MeshFile& file = *mesh;
+        data.meshes[meshID]->SetShadowMesh(&file);
+        data.shadows[shadowID] = std::move(mesh);
+
+        AddAsset([&file, name]()
+        {
+            return file.LoadFromFile(ASSETS_PATH + name + ".obj", true, true);
+        },
+        [&file, createBuffers]()
+        {
+            return file.Initialise(1, createBuffers);
+        });
+        return true;
+    };
+
+    success &= InitialiseShadow("tankshadow", ShadowID::TANK, MeshID::TANK);
+    success &= InitialiseShadow("gunshadow", ShadowID::GUN, MeshID::TANKGUN);
 
     // Initialise the backdrop
     data.meshes[MeshID::BACKDROP] = std::make_unique<Quad>("backdrop", ShaderID::GRADIENT);
-    success &= data.meshes[MeshID::BACKDROP]->Initialise();
+    success &= data.meshes[MeshID::BACKDROP]->Initialise(1, createBuffers);
     data.meshes[MeshID::BACKDROP]->SetBackfaceCull(false);
     data.meshes[MeshID::BACKDROP]->SetAlphaBlending(true);
     data.meshes[MeshID::BACKDROP]->SetDepthWrite(false);
     data.meshes[MeshID::BACKDROP]->SetRenderWithLights(false);
 
-    // Player has different texture to enemies
-    data.meshes[MeshID::TANK]->SetTexture(TextureID::TANK_BODY, Instance::PLAYER);
-    data.meshes[MeshID::TANKGUN]->SetTexture(TextureID::TANK_GUN, Instance::PLAYER);
-    data.meshes[MeshID::TANKP1]->SetTexture(TextureID::TANK_BODY, Instance::PLAYER);
-    data.meshes[MeshID::TANKP2]->SetTexture(TextureID::TANK_BODY, Instance::PLAYER);
-    data.meshes[MeshID::TANKP3]->SetTexture(TextureID::TANK_BODY, Instance::PLAYER);
-    data.meshes[MeshID::TANKP4]->SetTexture(TextureID::TANK_GUN, Instance::PLAYER);
+    // Player has different texture to enemies, set once the tank instances exist
+    AddAsset(nullptr, [&data, player]()
+    {
+        data.meshes[MeshID::TANK]->SetTexture(TextureID::TANK_BODY, player);
+        data.meshes[MeshID::TANKGUN]->SetTexture(TextureID::TANK_GUN, player);
+        data.meshes[MeshID::TANKP1]->SetTexture(TextureID::TANK_BODY, player);
+        data.meshes[MeshID::TANKP2]->SetTexture(TextureID::TANK_BODY, player);
+        data.meshes[MeshID::TANKP3]->SetTexture(TextureID::TANK_BODY, player);
+        data.meshes[MeshID::TANKP4]->SetTexture(TextureID::TANK_GUN, player);
+        return true;
+    });
 
     return success;
 }
@@ -211,28 +421,48 @@ bool SceneBuilder::InitialiseHulls(SceneData& data, PhysicsEngine& physics)
     data.hulls.resize(HullID::MAX);
     data.shapes.resize(ShapeID::MAX);
 
-    auto Initialise = [&data, &physics](std::string name, HullID::ID hullID, 
-                                        ShaderID::ID shaderID, ShapeID::ID shapeID, 
-                                        int instances) -> bool
+    const bool createBuffers = !m_settings.headless;
+    const int tanks = m_settings.tanks;
+    const int bullets = m_settings.bullets;
+
+    const auto importer = m_settings.useAssimp ? MeshFile::ASSIMP : MeshFile::NATIVE;
+
+    auto Initialise = [this, &data, &physics, createBuffers, importer](std::string name, HullID::ID hullID, 
+                                                                       ShaderID::ID shaderID, ShapeID::ID shapeID, 
+                                                                       int instances) -> bool
     {
         auto hull = std::make_unique<MeshFile>(name, shaderID);
-        if (hull->InitialiseFromFile(ASSETS_PATH + name + ".obj", false, false, instances))
+        hull->SetImporter(importer);
+        hull->SetOptimise(false);
+
+        MeshFile& file = *hull;
+        data.hulls[hullID] = std::move(hull);
+
+        AddAsset([&file, name]()
+        {
+            return file.LoadFromFile(ASSETS_PATH + name + ".obj", false, false);
+        },
+        [&file, &data, &physics, createBuffers, shapeID, instances]()
         {
-            hull->SetShouldRender(false);
-            data.shapes[shapeID] = physics.LoadConvexShape(hull->VertexPositions());
-            data.hulls[hullID] = std::move(hull);
+            // Physics shapes are loaded in order as they are referenced by index
+            if (!file.Initialise(instances, createBuffers))
+            {
+                return false;
+            }
+            file.SetShouldRender(false);
+            data.shapes[shapeID] = physics.LoadConvexShape(file.VertexPositions());
             return true;
-        }
-        return false;
+        });
+        return true;
     };
 
-    success &= Initialise("tankp1proxy", HullID::TANKP1, ShaderID::PROXY, ShapeID::TANKP1, Instance::TANKS);
-    success &= Initialise("tankp2proxy", HullID::TANKP2, ShaderID::PROXY, ShapeID::TANKP2, Instance::TANKS);
-    success &= Initialise("tankp3proxy", HullID::TANKP3, ShaderID::PROXY, ShapeID::TANKP3, Instance::TANKS);
-    success &= Initialise("tankp4proxy", HullID::TANKP4, ShaderID::PROXY, ShapeID::TANKP4, Instance::TANKS);
-    success &= Initialise("tankproxy", HullID::TANK, ShaderID::PROXY, ShapeID::TANK, Instance::TANKS);
-    success &= Initialise("tankgunproxy", HullID::GUN, ShaderID::PROXY, ShapeID::GUN, Instance::TANKS);
-    success &= Initialise("bulletproxy", HullID::BULLET, ShaderID::PROXY, ShapeID::BULLET, Instance::BULLETS);
+    success &= Initialise("tankp1proxy", HullID::TANKP1, ShaderID::PROXY, ShapeID::TANKP1, tanks);
+    success &= Initialise("tankp2proxy", HullID::TANKP2, ShaderID::PROXY, ShapeID::TANKP2, tanks);
+    success &= Initialise("tankp3proxy", HullID::TANKP3, ShaderID::PROXY, ShapeID::TANKP3, tanks);
+    success &= Initialise("tankp4proxy", HullID::TANKP4, ShaderID::PROXY, ShapeID::TANKP4, tanks);
+    success &= Initialise("tankproxy", HullID::TANK, ShaderID::PROXY, ShapeID::TANK, tanks);
+    success &= Initialise("tankgunproxy", HullID::GUN, ShaderID::PROXY, ShapeID::GUN, tanks);
+    success &= Initialise("bulletproxy", HullID::BULLET, ShaderID::PROXY, ShapeID::BULLET, bullets);
     success &= Initialise("groundproxy", HullID::GROUND, ShaderID::PROXY, ShapeID::GROUND, Instance::GROUND);
     success &= Initialise("wallproxy", HullID::WALL, ShaderID::PROXY, ShapeID::WALL, Instance::WALLS);
 
@@ -4,9 +4,15 @@
 
 #pragma once
 
+#include "Shader.h"
+#include "SceneSettings.h"
+
 #include <vector>
+#include <functional>
+#include <utility>
 
 class PhysicsEngine;
+class JobSystem;
 struct SceneData;
 
 /**
@@ -23,18 +29,39 @@ public:
     * Initialises the scene
     * @param data All information for the scene
     * @param physics The physics engine
+    * @param jobs Decodes asset files across threads
+    * @param settings Options for building the scene
     * @return Whether the initialization was successful
     */
-    bool Initialise(SceneData& data, PhysicsEngine& physics);
+    bool Initialise(SceneData& data, 
+                    PhysicsEngine& physics,
+                    JobSystem& jobs,
+                    const SceneSettings& settings);
 
 private:
 
+    typedef std::function<bool(void)> AssetFn;
+
     /**
     * Prevent copying
     */
     SceneBuilder(const SceneBuilder&) = delete;
     SceneBuilder& operator=(const SceneBuilder&) = delete;
 
+    /**
+    * Adds an asset to be loaded once all have been added
+    * @param load Reads and decodes files, called from any thread
+    * @param upload Creates the OpenGL resources, called in order on the calling thread
+    */
+    void AddAsset(AssetFn load, AssetFn upload);
+
+    /**
+    * Decodes all added assets in parallel then uploads them in order
+    * @param jobs Decodes asset files across threads
+    * @return Whether all assets loaded successfully
+    */
+    bool LoadAssets(JobSystem& jobs);
+
     /**
     * Initialises all shader constants
     * @param data All information for the scene
@@ -44,6 +71,7 @@ private:
 
     /**
     * Initiliases all shaders
+    * @note files are loaded once all stages have been added
     * @param data All information for the scene
     * @return Whether the initialization was successful
     */
@@ -58,6 +86,7 @@ private:
 
     /**
     * Initialises all textures required
+    * @note files are loaded once all stages have been added
     * @param data All information for the scene
     * @return Whether the initialization was successful
     */
@@ -65,6 +94,7 @@ private:
 
     /**
     * Initialises the meshes for the scene
+    * @note files are loaded once all stages have been added
     * @param data All information for the scene
     * @note relies on shaders initialised before
     * @return Whether the initialization was successful
@@ -81,10 +111,17 @@ private:
 
     /**
     * Initialises the convex hulls for the scene
+    * @note files are loaded once all stages have been added
     * @param data All information for the scene
     * @param physics The physics world
     * @note relies on shaders initialised before
     * @return Whether the initialization was successful
     */
     bool InitialiseHulls(SceneData& data, PhysicsEngine& physics);
+
+private:
+
+    Shader::ShaderConstants m_shaderConstants;  ///< Constants defined in all shaders
+    SceneSettings m_settings;                   ///< Options for building the scene
+    std::vector<std::pair<AssetFn, AssetFn>> m_assets;  ///< Load and upload functions for each asset
 };                     
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "Light.h"
 #include "Mesh.h"
 #include "Texture.h"
+#include "TextureArray.h"
 
 #include <vector>
 #include <memory>
@@ -23,8 +24,11 @@ struct SceneData
     std::vector<std::unique_ptr<Shader>> shaders;
     std::vector<std::unique_ptr<Light>> lights;
     std::vector<std::unique_ptr<Mesh>> meshes;
+    std::vector<std::unique_ptr<Mesh>> batches;
+    std::vector<std::unique_ptr<Mesh>> shadows;
     std::vector<std::unique_ptr<Mesh>> hulls;
     std::vector<std::unique_ptr<Mesh>> effects;
     std::vector<std::unique_ptr<Texture>> textures;
+    std::vector<std::unique_ptr<TextureArray>> textureArrays;
     std::vector<int> shapes;
 };
\ No newline at end of file
@@ -0,0 +1,411 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - SceneRecorder.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SceneRecorder.h"
+#include "RenderCommandList.h"
+#include "RenderSnapshot.h"
+#include "SceneData.h"
+#include "IndirectRenderer.h"
+#include "StreamBuffer.h"
+#include "GlmHelper.h"
+#include "Tweaker.h"
+
+#include <cfloat>
+#include <algorithm>
+
+namespace
+{
+    const int NO_INDEX = -1;
+    const float LOD_PIXEL_SIZE[] = { 48.0f, 24.0f }; ///< Screen radius below which each coarser level is used
+    const int LOD_MAX_LEVELS = sizeof(LOD_PIXEL_SIZE) / sizeof(LOD_PIXEL_SIZE[0]) + 1; ///< Levels the thresholds can select between
+    const float LOD_HYSTERESIS = 0.15f;              ///< Fraction a size must pass a threshold by to switch
+    const float SHADOW_OFFSET = 0.8f;                ///< Height of the shadow plane above the ground
+    const glm::vec4 SHADOW_LIGHT(0.0f, 1.0f, 0.0f, 0.0f); ///< Direction towards the light casting shadows
+
+    /**
+    * @return the render states the mesh is drawn with
+    */
+    int GetMeshState(const Mesh& mesh)
+    {
+        return (mesh.BackfaceCull() ? RenderCommandList::BACKFACE_CULL : 0) |
+               (mesh.AlphaBlending() ? RenderCommandList::ALPHA_BLEND : 0) |
+               (mesh.DepthWrite() ? RenderCommandList::DEPTH_WRITE : 0);
+    }
+}
+
+SceneRecorder::SceneRecorder(const SceneData& scene)
+    : m_scene(scene)
+{
+}
+
+void SceneRecorder::SetBuffers(StreamBuffer* stream, IndirectRenderer* indirect)
+{
+    m_stream = stream;
+    m_indirect = indirect;
+
+    // Textures packed into the same array are drawn as a single indirect group
+    const auto& textures = m_scene.textures;
+    m_textureGroups.resize(textures.size());
+    for (unsigned int i = 0; i < textures.size(); ++i)
+    {
+        m_textureGroups[i] = i;
+        for (unsigned int j = 0; j < i && textures[i] && textures[i]->IsPacked(); ++j)
+        {
+            if (textures[j] && textures[j]->IsPacked() && 
+                textures[j]->GetID() == textures[i]->GetID())
+            {
+                m_textureGroups[i] = j;
+                break;
+            }
+        }
+    }
+}
+
+void SceneRecorder::AddIndirect(const Mesh& mesh, int level, int texture, const glm::mat4& world)
+{
+    if (texture != NO_INDEX && m_scene.textures[texture]->IsPacked())
+    {
+        m_indirect->Add(mesh, level, m_textureGroups[texture], 
+            m_scene.textures[texture]->Layer(), world);
+    }
+    else
+    {
+        m_indirect->Add(mesh, level, texture, NO_INDEX, world);
+    }
+}
+
+void SceneRecorder::Record(const RenderSnapshot& snapshot, int height, RenderCommandList& commands)
+{
+    m_viewProjection = snapshot.viewProjection;
+    m_cameraPosition = snapshot.cameraPosition;
+
+    // Converts a radius at a distance of one into a radius in pixels
+    m_pixelScale = snapshot.projection[1][1] * height * 0.5f;
+
+    // Shadows flatten every caster onto the same plane so share one projection
+    const float groundHeight = m_scene.meshes[MeshID::GROUND]->Position().y + SHADOW_OFFSET;
+    const glm::vec4 groundPlane(0.0f, 1.0f, 0.0f, -groundHeight);
+    m_shadowProjection = m_viewProjection * 
+        glm::matrix_planar_projection(groundPlane, SHADOW_LIGHT);
+
+    // Each list is executed from an unknown state so begins by setting everything
+    m_selectedShader = NO_INDEX;
+    m_state = NO_INDEX;
+
+    RecordFrameConstants(commands);
+    RecordMeshes(snapshot, commands);
+}
+
+void SceneRecorder::RecordFrameConstants(RenderCommandList& commands)
+{
+    RenderCommandList::FrameConstants constants;
+    constants.viewProjection = m_viewProjection;
+    constants.shadowProjection = m_shadowProjection;
+
+    GLintptr offset = 0;
+    if (m_stream && m_stream->Write(&constants, sizeof(constants), 
+        m_stream->UniformAlignment(), offset))
+    {
+        commands.BindUniformBlock(FRAME_BINDING, offset, sizeof(constants));
+    }
+    else
+    {
+        commands.SendFrameConstants(constants);
+    }
+}
+
+void SceneRecorder::RecordMeshes(const RenderSnapshot& snapshot, RenderCommandList& commands)
+{
+    m_meshLevels.resize(snapshot.meshes.size());
+    for (unsigned int i = 0; i < snapshot.meshes.size(); ++i)
+    {
+        m_meshLevels[i].resize(m_scene.meshes[i]->Instances(), 0);
+    }
+
+    const bool indirect = m_useIndirect && m_indirect;
+    m_drawCalls = 0;
+
+    for (unsigned int i = 0; i < snapshot.meshes.size(); ++i)
+    {
+        const auto& mesh = m_scene.meshes[i];
+        const auto& instances = snapshot.meshes[i];
+        auto& levels = m_meshLevels[i];
+
+        if (!instances.empty() && indirect && m_indirect->Contains(*mesh))
+        {
+            for (const Mesh::RenderState& state : instances)
+            {
+                AddIndirect(*mesh, SelectLevelOfDetail(*mesh, state, 
+                    levels[state.instance]), state.texture, state.world);
+            }
+        }
+        else if (!instances.empty() && RecordShader(*mesh, commands))
+        {
+            commands.BindMesh(*mesh);
+            for (const Mesh::RenderState& state : instances)
+            {
+                ++m_drawCalls;
+                commands.SendMatrix(RenderCommandList::WORLD, state.world);
+                if (state.texture != NO_INDEX)
+                {
+                    commands.SendTexture(state.texture);
+                }
+                commands.Draw(*mesh, SelectLevelOfDetail(*mesh, state, levels[state.instance]));
+            }
+        }
+    }
+
+    // Batches are baked in world space and drawn before the shadows cast onto them
+    for (const auto& batch : m_scene.batches)
+    {
+        if (indirect && m_indirect->Contains(*batch))
+        {
+            AddIndirect(*batch, 0, batch->GetTexture(), glm::mat4(1.0f));
+        }
+        else if (RecordShader(*batch, commands))
+        {
+            ++m_drawCalls;
+            commands.BindMesh(*batch);
+            commands.SendMatrix(RenderCommandList::WORLD, glm::mat4(1.0f));
+            if (batch->GetTexture() != NO_INDEX)
+            {
+                commands.SendTexture(batch->GetTexture());
+            }
+            commands.Draw(*batch, 0);
+        }
+    }
+
+    if (indirect)
+    {
+        RecordIndirect(commands);
+    }
+
+    RecordShadows(snapshot, commands);
+
+    for (unsigned int i = 0; i < snapshot.effects.size(); ++i)
+    {
+        const auto& effect = m_scene.effects[i];
+        const auto& instances = snapshot.effects[i];
+        if (!instances.empty() && RecordShader(*effect, commands))
+        {
+            commands.BindMesh(*effect);
+            for (const Mesh::RenderState& state : instances)
+            {
+                commands.SendMatrix(RenderCommandList::WORLD, state.world);
+                if (state.texture != NO_INDEX)
+                {
+                    commands.SendTexture(state.texture);
+                }
+                commands.Draw(*effect, 0);
+            }
+        }
+    }
+}
+
+void SceneRecorder::RecordShadows(const RenderSnapshot& snapshot, RenderCommandList& commands)
+{
+    const bool instanced = m_instancedShadows && m_stream && 
+        m_scene.shaders[ShaderID::SHADOW_INSTANCED];
+
+    m_shadowDrawCalls = 0;
+
+    for (unsigned int i = 0; i < snapshot.meshes.size(); ++i)
+    {
+        const auto& mesh = m_scene.meshes[i];
+        const auto& instances = snapshot.meshes[i];
+        if (instances.empty() || !mesh->RenderShadows())
+        {
+            continue;
+        }
+
+        // Levels chosen for the mesh don't apply to a separate shadow mesh
+        const Mesh& caster = mesh->ShadowMesh() ? *mesh->ShadowMesh() : *mesh;
+        const std::vector<int>* levels = mesh->ShadowMesh() ? nullptr : &m_meshLevels[i];
+
+        if (instanced)
+        {
+            RecordShadowInstances(caster, instances, levels, commands);
+        }
+        else
+        {
+            RecordShadowShader(ShaderID::SHADOW, commands);
+            commands.BindMesh(caster);
+            for (const Mesh::RenderState& state : instances)
+            {
+                ++m_shadowDrawCalls;
+                commands.SendMatrix(RenderCommandList::WORLD, state.world);
+                commands.Draw(caster, levels ? (*levels)[state.instance] : 0);
+            }
+        }
+    }
+}
+
+void SceneRecorder::RecordShadowInstances(const Mesh& caster,
+                                          const Mesh::RenderStates& instances,
+                                          const std::vector<int>* levels,
+                                          RenderCommandList& commands)
+{
+    RecordShadowShader(ShaderID::SHADOW_INSTANCED, commands);
+    commands.BindMesh(caster);
+
+    const int levelCount = levels ? caster.LevelsOfDetail() : 1;
+    for (int level = 0; level < levelCount; ++level)
+    {
+        int count = 0;
+        for (const Mesh::RenderState& state : instances)
+        {
+            count += !levels || (*levels)[state.instance] == level ? 1 : 0;
+        }
+
+        if (count == 0)
+        {
+            continue;
+        }
+
+        const GLsizeiptr bytes = count * sizeof(glm::mat4);
+        GLintptr offset = 0;
+        glm::mat4* worlds = static_cast<glm::mat4*>(
+            m_stream->Allocate(bytes, m_stream->StorageAlignment(), offset));
+
+        if (!worlds)
+        {
+            return;
+        }
+
+        for (const Mesh::RenderState& state : instances)
+        {
+            if (!levels || (*levels)[state.instance] == level)
+            {
+                *worlds++ = state.world;
+            }
+        }
+
+        commands.BindStorageBlock(INSTANCE_BINDING, offset, bytes);
+        commands.DrawInstanced(caster, level, count);
+        ++m_shadowDrawCalls;
+    }
+}
+
+void SceneRecorder::RecordIndirect(RenderCommandList& commands)
+{
+    if (RecordSelectShader(ShaderID::TOON_INDIRECT, commands))
+    {
+        commands.SendLights(m_scene.lights);
+    }
+
+    m_drawCalls += m_indirect->Record(*m_stream, commands, 
+        [this, &commands](int texture, bool backfaceCull)
+    {
+        RecordState((backfaceCull ? RenderCommandList::BACKFACE_CULL : 0) | 
+            RenderCommandList::DEPTH_WRITE, commands);
+
+        if (texture != NO_INDEX)
+        {
+            commands.SendTexture(texture);
+        }
+    });
+}
+
+bool SceneRecorder::RecordShader(const Mesh& mesh, RenderCommandList& commands)
+{
+    const int index = mesh.ShaderID();
+    if (index == NO_INDEX)
+    {
+        return false;
+    }
+
+    if (RecordSelectShader(index, commands))
+    {
+        if (mesh.RenderWithLights())
+        {
+            commands.SendLights(m_scene.lights);
+        }
+    }
+
+    RecordState(GetMeshState(mesh), commands);
+    return true;
+}
+
+void SceneRecorder::RecordShadowShader(int index, RenderCommandList& commands)
+{
+    RecordSelectShader(index, commands);
+    RecordState(RenderCommandList::DEPTH_WRITE, commands);
+}
+
+bool SceneRecorder::RecordSelectShader(int index, RenderCommandList& commands)
+{
+    if (index == m_selectedShader)
+    {
+        return false;
+    }
+
+    m_selectedShader = index;
+    commands.SetShader(index);
+    return true;
+}
+
+void SceneRecorder::RecordState(int state, RenderCommandList& commands)
+{
+    if (state != m_state)
+    {
+        m_state = state;
+        commands.SetState(state);
+    }
+}
+
+int SceneRecorder::SelectLevelOfDetail(const Mesh& mesh, 
+                                       const Mesh::RenderState& state, 
+                                       int& level) const
+{
+    // Any levels past the last threshold are never selected
+    const int levels = std::min(mesh.LevelsOfDetail(), LOD_MAX_LEVELS);
+    if (levels <= 1)
+    {
+        return 0;
+    }
+
+    const float scale = std::max(glm::length(glm::vec3(state.world[0])), 
+        std::max(glm::length(glm::vec3(state.world[1])), glm::length(glm::vec3(state.world[2]))));
+
+    const float distance = std::max(glm::length(
+        glm::matrix_get_position(state.world) - m_cameraPosition), FLT_EPSILON);
+
+    const float size = mesh.Radius() * scale * m_pixelScale / distance;
+
+    // The hysteresis band stops instances near a threshold switching every frame
+    level = std::min(level, levels - 1);
+    while (level + 1 < levels && size < LOD_PIXEL_SIZE[level] * (1.0f - LOD_HYSTERESIS))
+    {
+        ++level;
+    }
+    while (level > 0 && size > LOD_PIXEL_SIZE[level - 1] * (1.0f + LOD_HYSTERESIS))
+    {
+        --level;
+    }
+    return level;
+}
+
+void SceneRecorder::AddToTweaker(Tweaker& tweaker)
+{
+    // Draw calls are shown by the engine as they may be recorded on another thread
+    if (m_indirect)
+    {
+        tweaker.AddEntry("Indirect Rendering", &m_useIndirect, TW_TYPE_BOOLCPP);
+    }
+
+    if (m_stream)
+    {
+        tweaker.AddEntry("Instanced Shadows", &m_instancedShadows, TW_TYPE_BOOLCPP);
+    }
+}
+
+int SceneRecorder::DrawCalls() const
+{
+    return m_drawCalls;
+}
+
+int SceneRecorder::ShadowDrawCalls() const
+{
+    return m_shadowDrawCalls;
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - SceneRecorder.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Mesh.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+
+struct SceneData;
+struct RenderSnapshot;
+class RenderCommandList;
+class StreamBuffer;
+class IndirectRenderer;
+class Tweaker;
+
+/**
+* Records the commands to render the scene meshes, shadows and effects
+* Only reads the scene and snapshot so requires no OpenGL context, with
+* the stream buffer being the only memory shared with the GPU
+*/
+class SceneRecorder
+{
+public:
+
+    /**
+    * Constructor
+    * @param scene The data to record
+    */
+    SceneRecorder(const SceneData& scene);
+
+    /**
+    * Sets the buffers used to stream instance data and draw indirectly
+    * @param stream The buffer for data written each frame or null if not supported
+    * @param indirect The renderer for supported meshes or null if not supported
+    */
+    void SetBuffers(StreamBuffer* stream, IndirectRenderer* indirect);
+
+    /**
+    * Records the commands for the scene pass
+    * @param snapshot The state of the scene instances to render
+    * @param height The height of the window in pixels
+    * @param commands The list to record into
+    */
+    void Record(const RenderSnapshot& snapshot, int height, RenderCommandList& commands);
+
+    /**
+    * Adds the recording options to the tweaker
+    * @param tweaker The tweak bar to add to
+    */
+    void AddToTweaker(Tweaker& tweaker);
+
+    /**
+    * @return the number of mesh draw calls in the last recording
+    */
+    int DrawCalls() const;
+
+    /**
+    * @return the number of shadow draw calls in the last recording
+    */
+    int ShadowDrawCalls() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    SceneRecorder(const SceneRecorder&) = delete;
+    SceneRecorder& operator=(const SceneRecorder&) = delete;
+
+    /**
+    * Records the meshes, batches, shadows and effects
+    * @param snapshot The state of the scene instances to render
+    * @param commands The list to record into
+    */
+    void RecordMeshes(const RenderSnapshot& snapshot, RenderCommandList& commands);
+
+    /**
+    * Records the shadows of the meshes onto the ground
+    * @param snapshot The state of the scene instances to render
+    * @param commands The list to record into
+    */
+    void RecordShadows(const RenderSnapshot& snapshot, RenderCommandList& commands);
+
+    /**
+    * Records each level of detail of a shadow caster as a single instanced draw
+    * @param caster The mesh to draw the shadows with
+    * @param instances The instances casting shadows
+    * @param levels The level of detail of each instance or null to use the highest
+    * @param commands The list to record into
+    */
+    void RecordShadowInstances(const Mesh& caster,
+                               const Mesh::RenderStates& instances,
+                               const std::vector<int>* levels,
+                               RenderCommandList& commands);
+
+    /**
+    * Records the instances added to the indirect renderer
+    * @param commands The list to record into
+    */
+    void RecordIndirect(RenderCommandList& commands);
+
+    /**
+    * Writes the constants shared by all shaders into the stream buffer
+    * or sends them directly when there is no stream buffer
+    * @param commands The list to record into
+    */
+    void RecordFrameConstants(RenderCommandList& commands);
+
+    /**
+    * Records selecting the shader of the mesh and its render states
+    * @param mesh The mesh to render
+    * @param commands The list to record into
+    * @return whether the mesh has a shader to render with
+    */
+    bool RecordShader(const Mesh& mesh, RenderCommandList& commands);
+
+    /**
+    * Records selecting a shadow shader and the shadow render states
+    * @param index The index of the shadow shader
+    * @param commands The list to record into
+    */
+    void RecordShadowShader(int index, RenderCommandList& commands);
+
+    /**
+    * Records selecting a shader if not already selected
+    * @param index The index of the shader
+    * @param commands The list to record into
+    * @return whether the shader was not already selected
+    */
+    bool RecordSelectShader(int index, RenderCommandList& commands);
+
+    /**
+    * Adds an instance to the indirect renderer, grouped by its texture array if packed
+    * @param mesh The mesh to draw
+    * @param level The level of detail to draw
+    * @param texture The ID of the texture to draw with
+    * @param world The world matrix of the instance
+    */
+    void AddIndirect(const Mesh& mesh, int level, int texture, const glm::mat4& world);
+
+    /**
+    * Records the render states if they differ from the last recorded
+    * @param state The combination of RenderCommandList::State flags to enable
+    * @param commands The list to record into
+    */
+    void RecordState(int state, RenderCommandList& commands);
+
+    /**
+    * Chooses the level of detail for an instance from its size on screen
+    * @param mesh The mesh to render
+    * @param state The instance to render
+    * @param level The level used last frame, updated with the chosen level
+    * @return the level of detail to render
+    */
+    int SelectLevelOfDetail(const Mesh& mesh, const Mesh::RenderState& state, int& level) const;
+
+private:
+
+    const SceneData& m_scene;                    ///< The data to record
+    StreamBuffer* m_stream = nullptr;            ///< Buffer for data written each frame
+    IndirectRenderer* m_indirect = nullptr;      ///< Renderer for meshes drawn with multi-draw indirect
+    std::vector<int> m_textureGroups;            ///< Texture each texture is drawn with through indirect
+    glm::mat4 m_viewProjection;                  ///< View projection of the frame being recorded
+    glm::mat4 m_shadowProjection;                ///< Flattens world positions onto the ground then projects them
+    glm::vec3 m_cameraPosition;                  ///< Camera position of the frame being recorded
+    float m_pixelScale = 1.0f;                   ///< Converts a radius at unit distance into pixels
+    int m_selectedShader = -1;                   ///< Shader selected by the last recorded commands
+    int m_state = -1;                            ///< Render states set by the last recorded commands
+    bool m_useIndirect = true;                   ///< Whether to draw supported meshes with multi-draw indirect
+    bool m_instancedShadows = true;              ///< Whether to draw shadows instanced from the stream buffer
+    int m_drawCalls = 0;                         ///< Number of mesh draw calls in the last recording
+    int m_shadowDrawCalls = 0;                   ///< Number of shadow draw calls in the last recording
+    std::vector<std::vector<int>> m_meshLevels;  ///< Level of detail of each mesh instance
+};
\ No newline at end of file
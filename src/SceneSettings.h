@@ -0,0 +1,19 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - SceneSettings.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DataIDs.h"
+
+/**
+* Options for building the scene
+*/
+struct SceneSettings
+{
+    bool headless = false;            ///< Whether to skip creating any rendering resources
+    int tanks = Instance::TANKS;      ///< Number of tanks including the player
+    int bullets = Instance::BULLETS;  ///< Number of bullets that can be fired at once
+    bool useAssimp = false;           ///< Whether to import meshes through Assimp rather than the native OBJ reader
+    bool textureArrays = false;       ///< Whether to pack textures of the same size and filtering into arrays
+};
\ No newline at end of file
@@ -6,39 +6,122 @@
 
 #include "Shader.h"
 #include "Rendertarget.h"
+#include "Texture.h"
 #include "Conversions.h"
 #include "Utils.h"
+#include "MappedFile.h"
 
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 namespace
 {
     const std::string VERTEX_SHADER("_glsl_vert.fx");
     const std::string FRAGMENT_SHADER("_glsl_frag.fx");
 
-    const int IN_POSITION_ID = 0;
+    // Ordered by the location of each VertexFormat::Attribute
     std::vector<std::string> ATTRIBUTE_MAP =
     {
         "in_Position",
         "in_UVs",
-        "in_Normal"
+        "in_Normal",
+        "in_Instance"
+    };
+
+    const char CACHE_MAGIC[4] = { 'T', 'T', 'P', 'B' };
+    const uint32_t CACHE_VERSION = 1;
+    const std::string CACHE_EXTENSION(".programcache");
+    const uint64_t HASH_OFFSET = 14695981039346656037ull;
+    const uint64_t HASH_PRIME = 1099511628211ull;
+
+    /**
+    * Start of the program binary cache, followed by the binary blob
+    */
+    struct CacheHeader
+    {
+        char magic[4];              ///< Identifies the file as a program binary cache
+        uint32_t version = 0;       ///< Version of the cache format
+        uint64_t key = 0;           ///< Hash of the shader text and driver the binary was built with
+        uint32_t format = 0;        ///< Driver specific format of the binary
+        uint32_t length = 0;        ///< Number of bytes in the binary blob
     };
-}
 
-Shader::ShaderConstants Shader::sm_constants;
+    /**
+    * Continues a FNV-1a hash with the given text
+    * @return the updated hash
+    */
+    uint64_t HashText(const char* text, size_t size, uint64_t hash)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(text[i])) * HASH_PRIME;
+        }
+        return hash;
+    }
 
-void Shader::InitialiseConstants(const ShaderConstants& constants)
+    /**
+    * Continues a hash with the driver details as a binary is only valid for the driver that built it
+    * @return the updated hash
+    */
+    uint64_t HashDriver(uint64_t hash)
+    {
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            const char* text = reinterpret_cast<const char*>(glGetString(name));
+            if (text)
+            {
+                hash = HashText(text, std::strlen(text), hash);
+            }
+        }
+        return hash;
+    }
+
+    /**
+    * Generates the preamble which defines each constant
+    * @return the preamble text
+    */
+    std::string GenerateDefines(const Shader::ShaderConstants& constants)
+    {
+        std::string defines;
+        for (const auto& constant : constants)
+        {
+            defines += "#define " + constant.first + " " + constant.second + "\n";
+        }
+        return defines;
+    }
+
+    /**
+    * Names the cache after the shader so permutations of the same files don't share it
+    * @return the path of the program cache
+    */
+    std::string GenerateCachePath(const std::string& path, const std::string& name)
+    {
+        const auto slash = path.find_last_of("/\\");
+        const std::string folder = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+        return folder + name + CACHE_EXTENSION;
+    }
+}
+
+Shader::Shader(const std::string& name, 
+               const std::string& path,
+               const ShaderConstants& constants)
+    : Shader(name, path, path, constants)
 {
-    sm_constants = constants;
 }
 
 Shader::Shader(const std::string& name, 
-               const std::string& path)
+               const std::string& vertexPath,
+               const std::string& fragmentPath,
+               const ShaderConstants& constants)
     : m_name(name)
-    , m_fragmentFile(path + FRAGMENT_SHADER)
-    , m_vertexFile(path + VERTEX_SHADER)
+    , m_fragmentFile(fragmentPath + FRAGMENT_SHADER)
+    , m_vertexFile(vertexPath + VERTEX_SHADER)
+    , m_cacheFile(GenerateCachePath(vertexPath, name))
+    , m_defines(GenerateDefines(constants))
 {
 }
 
@@ -69,58 +152,160 @@ Shader::~Shader()
     }
 }
 
+bool Shader::Load()
+{
+    if (!m_loaded)
+    {
+        m_loaded = LoadShaderFile(m_vertexFile, m_vertexText) &&
+            LoadShaderFile(m_fragmentFile, m_fragmentText);
+
+        m_sourceHash = HashText(m_vertexText.c_str(), m_vertexText.size(), HASH_OFFSET);
+        m_sourceHash = HashText(m_fragmentText.c_str(), m_fragmentText.size(), m_sourceHash);
+    }
+    return m_loaded;
+}
+
 bool Shader::Initialise()
 {
-    if (LoadShaderFile(m_vertexFile, m_vertexText) &&
-        LoadShaderFile(m_fragmentFile, m_fragmentText))
+    if (Load())
     {
-        m_vs = glCreateShader(GL_VERTEX_SHADER);
-        m_fs = glCreateShader(GL_FRAGMENT_SHADER);
         m_program = glCreateProgram();
 
-        if (CompileShader("vertex", m_vs, m_vertexText) &&
-            CompileShader("fragment", m_fs, m_fragmentText) &&
-            LinkShaderProgram() && 
-            BindVertexAttributes() &&
+        const uint64_t key = HashDriver(m_sourceHash);
+        const bool cached = LoadProgramBinary(key);
+        if (!cached)
+        {
+            m_vs = glCreateShader(GL_VERTEX_SHADER);
+            m_fs = glCreateShader(GL_FRAGMENT_SHADER);
+            glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+            if (!CompileShader("vertex", m_vs, m_vertexText) ||
+                !CompileShader("fragment", m_fs, m_fragmentText) ||
+                !LinkShaderProgram())
+            {
+                return false;
+            }
+
+            SaveProgramBinary(key);
+        }
+
+        if (BindVertexAttributes() &&
             BindFragmentAttributes() && 
             FindShaderUniforms())
         {
-            LogInfo("Shader: " + m_name + " compiled");
+            BindUniformBlocks();
+            LogInfo("Shader: " + m_name + (cached ? " loaded from cache" : " compiled"));
             return true;
         }
     }
     return false;
 }
 
-bool Shader::LoadShaderFile(const std::string& loadPath, std::string& text)
+bool Shader::LoadProgramBinary(uint64_t key)
 {
-    std::ifstream file(loadPath.c_str(), std::ios_base::in|std::ios_base::_Nocreate);
-    if(!file.is_open())
+    MappedFile file;
+    if (!file.Open(m_cacheFile) || file.Size() < sizeof(CacheHeader))
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.Data(), sizeof(CacheHeader));
+
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CACHE_VERSION ||
+        header.key != key ||
+        file.Size() != sizeof(CacheHeader) + header.length)
     {
-        LogShader("Could not open " + loadPath);
         return false;
     }
 
-    while (!file.eof())
+    glProgramBinary(m_program, header.format, 
+        file.Data() + sizeof(CacheHeader), header.length);
+
+    // The driver may still reject the binary, in which case the shader is compiled
+    GLint success = GL_FALSE;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+    glGetError();
+    return success == GL_TRUE;
+}
+
+void Shader::SaveProgramBinary(uint64_t key) const
+{
+    GLint length = 0;
+    glGetProgramiv(m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(m_program, length, nullptr, &format, binary.data());
+    if (HasCallFailed())
     {
-        std::string line;
-        std::getline(file, line);
+        LogError("Shader " + m_name + ": Could not get program binary");
+        return;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.format = static_cast<uint32_t>(format);
+    header.length = static_cast<uint32_t>(length);
 
-        for (const auto& constant : sm_constants)
+    // Written to a temporary file then renamed so a partial cache is never read
+    const std::string tempPath(m_cacheFile + ".tmp");
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+        if (!file.good())
         {
-            int index = line.find(constant.first);
-            while (index != -1)
-            {
-                const int size = static_cast<int>(constant.first.size());
-                line.replace(index, size, constant.second);
-                index = line.find(constant.first);
-            }
+            LogError("Could not write program cache " + m_cacheFile);
+            return;
         }
+    }
 
-        text += line + "\n";
+    std::remove(m_cacheFile.c_str());
+    if (std::rename(tempPath.c_str(), m_cacheFile.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
     }
+}
 
+bool Shader::LoadShaderFile(const std::string& loadPath, std::string& text)
+{
+    std::ifstream file(loadPath.c_str(), std::ios_base::in|std::ios_base::_Nocreate);
+    if(!file.is_open())
+    {
+        LogShader("Could not open " + loadPath);
+        return false;
+    }
+
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    const std::string source(stream.str());
     file.close();
+
+    // Constants are defined after the version directive which must come first
+    size_t start = 0;
+    const size_t version = source.find("#version");
+    if (version != std::string::npos)
+    {
+        start = source.find('\n', version);
+        start = start == std::string::npos ? source.size() : start + 1;
+    }
+
+    // Keeps the line numbers in compilation errors matching the file
+    const auto line = std::count(source.begin(), source.begin() + start, '\n') + 1;
+
+    text.reserve(source.size() + m_defines.size() + 16);
+    text.append(source, 0, start);
+    text.append(m_defines);
+    text.append("#line " + std::to_string(line) + "\n");
+    text.append(source, start, std::string::npos);
     return true;
 }
 
@@ -196,6 +381,15 @@ bool Shader::BindFragmentAttributes()
     return true;
 }
 
+void Shader::BindUniformBlocks()
+{
+    const GLuint frameBlock = glGetUniformBlockIndex(m_program, "FrameConstants");
+    if (frameBlock != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(m_program, frameBlock, FRAME_BINDING);
+    }
+}
+
 bool Shader::FindShaderUniforms()
 {
     int maxLength;
@@ -210,6 +404,8 @@ bool Shader::FindShaderUniforms()
         return false;
     }
 
+    glUseProgram(m_program);
+
     int samplerSlot = 0;
     for (int i = 0; i < uniformCount; ++i)
     {
@@ -231,6 +427,15 @@ bool Shader::FindShaderUniforms()
             return false;
         }
 
+        // Members of uniform blocks are filled from buffers, not set individually
+        GLint blockIndex = -1;
+        const GLuint uniformIndex = static_cast<GLuint>(i);
+        glGetActiveUniformsiv(m_program, 1, &uniformIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+        if (blockIndex != -1)
+        {
+            continue;
+        }
+
         GLint location = glGetUniformLocation(m_program, name.c_str());
         if(HasCallFailed() || location == -1)
         {
@@ -238,8 +443,12 @@ bool Shader::FindShaderUniforms()
             return false;
         }
         
-        if(type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_MULTISAMPLE || type == GL_SAMPLER_CUBE)
+        if(type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_MULTISAMPLE || 
+           type == GL_SAMPLER_2D_ARRAY || type == GL_SAMPLER_CUBE)
         {
+            // Units never change so are set once rather than with every texture
+            glUniform1i(location, samplerSlot);
+
             m_samplers[name].location = location;
             m_samplers[name].type = type;
             m_samplers[name].slot = samplerSlot;
@@ -259,6 +468,7 @@ bool Shader::FindShaderUniforms()
         }
     }
 
+    glUseProgram(0);
     return true;
 }
 
@@ -291,25 +501,27 @@ void Shader::UpdateUniformArray(const std::string& name, const float* value, int
             itr->second.scratch[i] = value[j];
         }
 
-        itr->second.updated = true;
+        if (!itr->second.updated)
+        {
+            itr->second.updated = true;
+            m_updatedUniforms.push_back(&*itr);
+        }
     }
 }
 
 void Shader::SendUniformArrays()
 {
-    for (auto& uniform : m_uniforms)
+    for (auto* uniform : m_updatedUniforms)
     {
-        if (uniform.second.updated)
-        {
-            uniform.second.updated = false;
-            SendUniformFloat(
-                uniform.first, 
-                &uniform.second.scratch[0],
-                uniform.second.location,
-                uniform.second.size,
-                uniform.second.type);
-        }
+        uniform->second.updated = false;
+        SendUniformFloat(
+            uniform->first, 
+            &uniform->second.scratch[0],
+            uniform->second.location,
+            uniform->second.size,
+            uniform->second.type);
     }
+    m_updatedUniforms.clear();
 }
 
 void Shader::SendUniformFloat(const std::string& name, 
@@ -394,7 +606,6 @@ bool Shader::BindVertexAttributes()
         return false;
     }
 
-    m_stride = 0;
     for (int i = 0; i < attributeCount; ++i)
     {
         int size;
@@ -430,13 +641,7 @@ bool Shader::BindVertexAttributes()
         m_attributes.emplace_back();
         m_attributes[i].location = location;
         m_attributes[i].name = name;
-
-        // Pass position as a vec3 into a vec4 slot to use the optimization
-        // where the 'w' component is automatically set as 1.0
-        const bool isPosition = IsStrEqual(m_attributes[i].name, ATTRIBUTE_MAP[IN_POSITION_ID]);
-        m_attributes[i].components = GetComponents(isPosition ? GL_FLOAT_VEC3 : type);
-
-        m_stride += m_attributes[i].components;
+        m_attributeMask |= 1u << location;
     }
 
     std::sort(m_attributes.begin(), m_attributes.end(), [](const AttributeData& d1, const AttributeData& d2)
@@ -461,36 +666,19 @@ bool Shader::BindVertexAttributes()
 void Shader::EnableShader()
 {
     SendUniformArrays();
+}
 
-    int offset = 0;
-    for(const AttributeData& attr : m_attributes)
-    {
-        glEnableVertexAttribArray(attr.location);
-
-        if(HasCallFailed())
-        {
-            LogShader("Could not enable attribute " + attr.name);
-        }
-    
-        glVertexAttribPointer(attr.location, attr.components, GL_FLOAT, 
-            GL_FALSE, m_stride*sizeof(GLfloat), (void*)(offset*sizeof(GLfloat)));
-
-        if(HasCallFailed())
-        {
-            LogShader("Could not set attribute " + attr.name);
-        }
-    
-        offset += attr.components;
-    }
+unsigned int Shader::AttributeMask() const
+{
+    return m_attributeMask;
 }
 
-void Shader::ClearTexture(const std::string& sampler, bool multisample)
+void Shader::ClearTexture(const std::string& sampler, GLenum type)
 {
     auto samplerItr = m_samplers.find(sampler);
     if (samplerItr != m_samplers.end())
     {
-        glActiveTexture(GetTexture(samplerItr->second.slot));
-        glBindTexture(!multisample ? GL_TEXTURE_2D : GL_TEXTURE_2D_MULTISAMPLE, 0);
+        BindTexture(samplerItr->second.slot, type, 0);
 
         if (HasCallFailed())
         {
@@ -501,77 +689,41 @@ void Shader::ClearTexture(const std::string& sampler, bool multisample)
 
 void Shader::SendTexture(const std::string& sampler, const RenderTarget& target, int ID)
 {
-    SendTexture(sampler, target.GetTexture(ID), target.IsMultisampled());
+    SendTexture(sampler, target.GetTexture(ID), target.IsMultisampled() ?
+        GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D);
 }
 
 void Shader::ClearTexture(const std::string& sampler, const RenderTarget& target)
 {
-    ClearTexture(sampler, target.IsMultisampled());
+    ClearTexture(sampler, target.IsMultisampled() ? 
+        GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D);
 }
 
 void Shader::SendTexture(const std::string& sampler, GLuint id)
 {
-    SendTexture(sampler, id, false);
+    SendTexture(sampler, id, GL_TEXTURE_2D);
 }
 
-void Shader::SendTexture(const std::string& sampler, GLuint id, bool multisample)
+void Shader::SendTexture(const std::string& sampler, const Texture& texture)
 {
-    auto samplerItr = m_samplers.find(sampler);
-    if (samplerItr != m_samplers.end())
-    {
-        if (samplerItr->second.allocated != id)
-        {
-            samplerItr->second.allocated = id;
-
-            glActiveTexture(GetTexture(samplerItr->second.slot));
-            glBindTexture(!multisample ? GL_TEXTURE_2D : GL_TEXTURE_2D_MULTISAMPLE, id);
-
-            glUniform1i(samplerItr->second.location, samplerItr->second.slot);
-
-            if (HasCallFailed())
-            {
-                LogShader("Could not send texture");
-            }
-        }
-    }
+    SendTexture(sampler, texture.GetID(), texture.GetType());
 }
 
-void Shader::SetActive()
+void Shader::SendTexture(const std::string& sampler, GLuint id, GLenum type)
 {
-    glUseProgram(m_program);
-
-    for (auto& sampler : m_samplers)
+    // Bindings are cached per unit so survive switching between shaders
+    auto samplerItr = m_samplers.find(sampler);
+    if (samplerItr != m_samplers.end() && 
+        BindTexture(samplerItr->second.slot, type, id) && 
+        HasCallFailed())
     {
-        sampler.second.allocated = -1;
+        LogShader("Could not send texture");
     }
 }
 
-unsigned int Shader::GetTexture(int slot)
+void Shader::SetActive()
 {
-    switch(slot)
-    {
-    case 0:
-        return GL_TEXTURE0;
-    case 1:
-        return GL_TEXTURE1;
-    case 2:
-        return GL_TEXTURE2;
-    case 3:
-        return GL_TEXTURE3;
-    case 4:
-        return GL_TEXTURE4;
-    case 5:
-        return GL_TEXTURE5;
-    case 6:
-        return GL_TEXTURE6;
-    case 7:
-        return GL_TEXTURE7;
-    case 8:
-        return GL_TEXTURE8;
-    default:
-        LogError("GetTexture: Unknown slot");
-        return 0;
-    }
+    glUseProgram(m_program);
 }
 
 int Shader::GetComponents(GLenum type)
@@ -11,8 +11,10 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <cstdint>
 
 class RenderTarget;
+class Texture;
 
 /**
 * Shader used to render a mesh
@@ -21,12 +23,32 @@ class Shader
 {
 public:
 
+    /**
+    * Constant names and the values to define for them in the shader text
+    */
+    typedef std::vector<std::pair<std::string, std::string>> ShaderConstants;
+
     /**
     * Constructor
     * @param name The name of the shader
     * @param path The path to the shader
+    * @param constants The constants to define at the start of the shader
+    */
+    Shader(const std::string& name, 
+           const std::string& path,
+           const ShaderConstants& constants);
+
+    /**
+    * Constructor
+    * @param name The name of the shader
+    * @param vertexPath The path to the vertex shader
+    * @param fragmentPath The path to the fragment shader
+    * @param constants The constants to define at the start of the shader
     */
-    Shader(const std::string& name, const std::string& path);
+    Shader(const std::string& name, 
+           const std::string& vertexPath,
+           const std::string& fragmentPath,
+           const ShaderConstants& constants);
 
     /**
     * Destructor
@@ -34,7 +56,14 @@ public:
     ~Shader();
 
     /**
-    * Initialises the shader
+    * Reads the shader files into memory
+    * @note does not require the OpenGL context and can be called from any thread
+    * @return whether reading was successful
+    */
+    bool Load();
+
+    /**
+    * Initialises the shader, reading the files if not already loaded
     * @return whether initialisation was successful
     */
     bool Initialise();
@@ -84,12 +113,16 @@ public:
     void SendUniform(const std::string& name, const glm::vec4& value, int offset = -1);
 
     /**
-    * Enables the vertex shader 'in' attributes for the shader
-    * This is required after the shader is active and when a mesh buffer is bound
-    * Also sends any arrays in the scratch buffer to the shader
+    * Sends any arrays in the scratch buffer to the shader
+    * This is required after the shader is active and before rendering
     */
     void EnableShader();
 
+    /**
+    * @return mask of the vertex attribute locations read by the shader
+    */
+    unsigned int AttributeMask() const;
+
     /**
     * Sends a texture to the shader
     * @param sampler Name of the shader texture sampler to use
@@ -97,6 +130,13 @@ public:
     */
     void SendTexture(const std::string& sampler, GLuint id);
 
+    /**
+    * Sends a texture to the shader, which may be a layer of a texture array
+    * @param sampler Name of the shader texture sampler to use
+    * @param texture The texture to send
+    */
+    void SendTexture(const std::string& sampler, const Texture& texture);
+
     /**
     * Sends the render target texture to the shader
     * @param sampler Name of the shader texture sampler to use
@@ -118,13 +158,6 @@ public:
     */
     const std::string& Name() const;
 
-    /**
-    * Initialises the defined constants in the shaders
-    * @param constants The constants to set
-    */
-    typedef std::vector<std::pair<std::string, std::string>> ShaderConstants;
-    static void InitialiseConstants(const ShaderConstants& constants);
-
 private:
 
     /**
@@ -141,7 +174,7 @@ private:
     void LogShader(const std::string& text);
 
     /**
-    * Sends the array buffers to the shader if they have been updated
+    * Sends the array buffers to the shader that have been updated
     */
     void SendUniformArrays();
 
@@ -173,28 +206,41 @@ private:
     void SendUniformFloat(const std::string& name, const float* value, 
                           int location, int size, GLenum type);
 
+    /**
+    * Links the program from a cached binary
+    * @param key Hash of the shader text and driver the binary must match
+    * @return whether the cache exists, matches and was accepted by the driver
+    */
+    bool LoadProgramBinary(uint64_t key);
+
+    /**
+    * Writes the linked program binary to the cache
+    * @param key Hash of the shader text and driver the binary was built with
+    */
+    void SaveProgramBinary(uint64_t key) const;
+
     /**
     * Generates a shader from the given shader file
     * @param loadPath The path to the file
-    * @param text The container to save the text to
+    * @param text The container to save the text with the constants defined
     * @return whether the file was successfully loaded
     */
     bool LoadShaderFile(const std::string& loadPath, std::string& text);
 
     /**
-    * Sends a texture to the shader
+    * Binds a texture to the unit of the sampler
     * @param sampler Name of the shader texture sampler to use
     * @param id The unique id for the opengl texture
-    * @param multisample Whether this texture is to be multisampled
+    * @param type The type of opengl texture to bind
     */
-    void SendTexture(const std::string& sampler, GLuint id, bool multisample);
+    void SendTexture(const std::string& sampler, GLuint id, GLenum type);
 
     /**
     * Clears the current texture set
     * @param sampler Name of the shader texture sampler to use
-    * @param multisample Whether this texture is to be multisampled
+    * @param type The type of opengl texture to clear
     */
-    void ClearTexture(const std::string& sampler, bool multisample);
+    void ClearTexture(const std::string& sampler, GLenum type);
 
     /**
     * Determines the output fragment attributes and binds them
@@ -214,6 +260,12 @@ private:
     */
     bool FindShaderUniforms();
 
+    /**
+    * Binds the uniform blocks shared by the scene shaders to their binding points
+    * @note required as #version 150 shaders can't set the binding themselves
+    */
+    void BindUniformBlocks();
+
     /**
     * Generates the shader for the engine
     * @param shader The description of the shader (vertex or fragment)
@@ -228,13 +280,7 @@ private:
     * @return if the call was successful
     */
     bool LinkShaderProgram();
-                    
-    /**
-    * Determines the unique ID of the texture slot
-    * @param slot The slot in the shader the texture will fill
-    * @return the unique ID of the texture
-    */
-    static unsigned int GetTexture(int slot);
+
 
     /**
     * Determines the amount of float components from the OpenGL type
@@ -248,7 +294,6 @@ private:
     */
     struct AttributeData
     {
-        int components = 0;  ///< Number of float components in the type
         int location = 0;    ///< The index location of the attribute
         std::string name;    ///< The name of the attribute
     };
@@ -271,10 +316,9 @@ private:
     */
     struct SamplerData
     {
-        int slot = 0;               ///< Order of usage in shader
-        int allocated = -1;         ///< Currently allocated texture to this slot
+        int slot = 0;               ///< Texture unit the sampler reads from
         int location = 0;           ///< Unique location within the shader
-        GLenum type = 0;            ///< Whether a texture, cubemap or ms
+        GLenum type = 0;            ///< Whether a texture, array, cubemap or ms
     };
 
     typedef std::unordered_map<std::string, UniformData> UniformMap;
@@ -285,14 +329,18 @@ private:
     UniformMap m_uniforms;                    ///< Vertex and fragment non-attribute uniform data
     SamplerMap m_samplers;                    ///< Fragment shader sampler locations
     std::vector<AttributeData> m_attributes;  ///< Vertex shader input attributes
+    unsigned int m_attributeMask = 0;         ///< Mask of the vertex attribute locations
+    std::vector<UniformMap::value_type*> m_updatedUniforms; ///< Arrays updated since last sent
     GLint m_program = -1;                     ///< Shader program
     GLint m_vs = -1;                          ///< GLSL Vertex Shader
     GLint m_fs = -1;                          ///< GLSL Fragment Shader
-    GLsizei m_stride = 0;                     ///< Stride required for vertex attributes
     const std::string m_name;                 ///< name of the shader
     const std::string m_vertexFile;           ///< filename of the glsl shader
     const std::string m_fragmentFile;         ///< filename of the glsl shader
+    const std::string m_cacheFile;            ///< filename of the program binary cache
     std::string m_vertexText;                 ///< The vertex shader string
     std::string m_fragmentText;               ///< The fragment shader string
-    static ShaderConstants sm_constants;      ///< Holds constant data to substitute into shaders
+    bool m_loaded = false;                    ///< Whether the shader files have been read
+    uint64_t m_sourceHash = 0;                ///< Hash of the vertex and fragment shader text
+    const std::string m_defines;              ///< Preamble defining the constants for the shader
 };                              
\ No newline at end of file
@@ -5,12 +5,8 @@
 #include "SoundEngine.h"
 #include "Logger.h"
 
-SoundEngine* SoundEngine::sm_engine = nullptr;
-
 SoundEngine::SoundEngine()
 {
-    sm_engine = this;
- 
     InitialiseFmod();
 
     m_sounds.resize(NUMBER_OF_SOUNDS);
@@ -43,22 +39,22 @@ SoundEngine::~SoundEngine()
 
 void SoundEngine::PlaySoundEffect(Sound ID)
 {
-    sm_engine->m_system->playSound(sm_engine->m_sounds[ID], 0, false, &sm_engine->m_sfxChannel);
+    m_system->playSound(m_sounds[ID], 0, false, &m_sfxChannel);
 }
 
 void SoundEngine::PlayMusic(Sound ID)
 {
-    sm_engine->m_nextTrack = ID;
+    m_nextTrack = ID;
 
-    if (sm_engine->m_currentTrack == NOTRACK)
+    if (m_currentTrack == NOTRACK)
     {
-        sm_engine->PlayMusic();
+        PlayMusic();
     }
     else
     {
-        sm_engine->m_shouldFade = true;
-        sm_engine->m_fadeIn = false;
-        sm_engine->m_musicChannel->getVolume(&sm_engine->m_volume);
+        m_shouldFade = true;
+        m_fadeIn = false;
+        m_musicChannel->getVolume(&m_volume);
     }
 }
 
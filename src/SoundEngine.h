@@ -6,10 +6,14 @@
 
 #include "fmod/include/fmod.h"
 #include "fmod/include/fmod.hpp"
+#include "SoundSink.h"
 
 #include <vector>
 
-class SoundEngine
+/**
+* Plays sounds and music through FMOD
+*/
+class SoundEngine : public SoundSink
 {
 public:
 
@@ -23,21 +27,6 @@ public:
     */
     ~SoundEngine();
 
-    /**
-    * Avaliable sounds to play
-    */
-    enum Sound
-    { 
-        NOTRACK = -1,
-        GAME = 0,
-        CLICK, 
-        SHOOT, 
-        BANG, 
-        EXPLODE, 
-        WALLBANG, 
-        NUMBER_OF_SOUNDS 
-    };
-    
     /**
     * Updates the engine
     */
@@ -47,16 +36,22 @@ public:
     * Plays a sound effect
     * @param ID the ID of the sound
     */
-    static void PlaySoundEffect(Sound ID);
+    virtual void PlaySoundEffect(Sound ID) override;
 
     /**
     * Plays a music track
     * @param ID the ID of the sound
     */
-    static void PlayMusic(Sound ID);
+    void PlayMusic(Sound ID);
 
 private:
 
+    /**
+    * Prevent copying
+    */
+    SoundEngine(const SoundEngine&) = delete;
+    SoundEngine& operator=(const SoundEngine&) = delete;
+
     /**
     * Initialises the FMOD sound engine
     */
@@ -74,7 +69,6 @@ private:
 
 private:
 
-    static SoundEngine* sm_engine;                 ///< Sound engine singleton
     FMOD::System* m_system = nullptr;              ///< FMOD System controller
     FMOD::Channel* m_musicChannel = nullptr;       ///< Current channel music is played on
     FMOD::Channel* m_sfxChannel = nullptr;         ///< Current channel sounds are played on
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - SoundSink.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/**
+* Destination for sounds requested by the game
+* Allows each game instance to own where its sounds are sent
+*/
+class SoundSink
+{
+public:
+
+    /**
+    * Avaliable sounds to play
+    */
+    enum Sound
+    { 
+        NOTRACK = -1,
+        GAME = 0,
+        CLICK, 
+        SHOOT, 
+        BANG, 
+        EXPLODE, 
+        WALLBANG, 
+        NUMBER_OF_SOUNDS 
+    };
+
+    /**
+    * Destructor
+    */
+    virtual ~SoundSink() = default;
+
+    /**
+    * Plays a sound effect
+    * @param ID the ID of the sound
+    */
+    virtual void PlaySoundEffect(Sound ID) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - StaticBatch.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StaticBatch.h"
+
+#include <map>
+
+StaticBatch::StaticBatch(const std::string& name, int shaderID)
+    : Mesh(name, shaderID)
+{
+}
+
+bool StaticBatch::Build(const std::vector<Mesh*>& meshes,
+                        bool createBuffers,
+                        std::vector<std::unique_ptr<Mesh>>& batches)
+{
+    // Instances sharing a shader and texture are drawn together
+    std::map<std::pair<int, int>, StaticBatch*> materials;
+
+    for (Mesh* mesh : meshes)
+    {
+        for (int i = 0; i < mesh->Instances(); ++i)
+        {
+            if (!mesh->Visible(i))
+            {
+                continue;
+            }
+
+            const auto material = std::make_pair(mesh->ShaderID(), mesh->GetTexture(i));
+            auto& batch = materials[material];
+            if (!batch)
+            {
+                auto newBatch = std::make_unique<StaticBatch>(
+                    "batch" + std::to_string(batches.size()), mesh->ShaderID());
+
+                newBatch->SetBackfaceCull(mesh->BackfaceCull());
+                newBatch->SetRenderWithLights(mesh->RenderWithLights());
+                newBatch->SetAlphaBlending(mesh->AlphaBlending());
+                newBatch->SetDepthWrite(mesh->DepthWrite());
+
+                batch = newBatch.get();
+                batches.push_back(std::move(newBatch));
+            }
+
+            if (!batch->Add(*mesh, i))
+            {
+                return false;
+            }
+
+            mesh->SetVisible(false, i);
+        }
+    }
+
+    for (const auto& material : materials)
+    {
+        StaticBatch& batch = *material.second;
+        if (!batch.Initialise(1, createBuffers))
+        {
+            LogError("Could not initialise " + batch.Name());
+            return false;
+        }
+
+        batch.SetTexture(material.first.second);
+        batch.UpdateTransforms();
+
+        LogInfo("Batch: " + batch.Name() + " created with " +
+            std::to_string(batch.Indices().size() / 3) + " triangles");
+    }
+
+    return true;
+}
+
+bool StaticBatch::Add(Mesh& mesh, int instance)
+{
+    const int componentCount = mesh.VertexComponentCount();
+    if (mesh.LevelsOfDetail() > 1)
+    {
+        LogError("Batch: " + mesh.Name() + " has levels of detail and can't be batched");
+        return false;
+    }
+
+    if (!m_vertices.empty() && componentCount != m_vertexComponentCount)
+    {
+        LogError("Batch: " + mesh.Name() + " vertices don't match " + Name());
+        return false;
+    }
+
+    // Normals follow the inverse transpose so non-uniform scale keeps them perpendicular
+    const glm::mat4& world = mesh.GetWorld(instance);
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(world)));
+    const int normalOffset = componentCount == 8 ? 5 : 3;
+    const bool hasNormals = componentCount >= 6;
+
+    const auto& vertices = mesh.Vertices();
+    const unsigned int first = static_cast<unsigned int>(m_vertices.size()) / componentCount;
+
+    m_vertexComponentCount = componentCount;
+    m_vertices.reserve(m_vertices.size() + vertices.size());
+
+    for (unsigned int v = 0; v < vertices.size(); v += componentCount)
+    {
+        const glm::vec3 position(world * glm::vec4(
+            vertices[v], vertices[v + 1], vertices[v + 2], 1.0f));
+
+        const unsigned int start = static_cast<unsigned int>(m_vertices.size());
+        m_vertices.insert(m_vertices.end(),
+            vertices.begin() + v, vertices.begin() + v + componentCount);
+
+        m_vertices[start] = position.x;
+        m_vertices[start + 1] = position.y;
+        m_vertices[start + 2] = position.z;
+
+        if (hasNormals)
+        {
+            float* normal = &m_vertices[start + normalOffset];
+            const glm::vec3 transformed = glm::normalize(
+                normalMatrix * glm::vec3(normal[0], normal[1], normal[2]));
+
+            normal[0] = transformed.x;
+            normal[1] = transformed.y;
+            normal[2] = transformed.z;
+        }
+    }
+
+    for (unsigned int index : mesh.Indices())
+    {
+        m_indices.push_back(first + index);
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - StaticBatch.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Mesh.h"
+
+#include <memory>
+
+/**
+* Mesh holding world space copies of instances which never move
+* Allows drawing many static instances sharing a material with a single call
+*/
+class StaticBatch : public Mesh
+{
+public:
+
+    /**
+    * Constructor
+    * @param name The name of the batch
+    * @param shaderID The ID of the shader to use
+    */
+    StaticBatch(const std::string& name, int shaderID);
+
+    /**
+    * Bakes the visible instances of the meshes into batches, one for each
+    * shader and texture, and hides the instances so only the batches render
+    * @param meshes The meshes whose instances will no longer move
+    * @param createBuffers Whether to create the buffers used for rendering
+    * @param batches The container to add the batches to
+    * @return whether all batches were created
+    */
+    static bool Build(const std::vector<Mesh*>& meshes,
+                      bool createBuffers,
+                      std::vector<std::unique_ptr<Mesh>>& batches);
+
+    /**
+    * Adds a world space copy of the mesh instance
+    * @param mesh The mesh to copy
+    * @param instance The instance of the mesh to copy
+    * @return whether the instance could be added
+    */
+    bool Add(Mesh& mesh, int instance);
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    StaticBatch(const StaticBatch&) = delete;
+    StaticBatch& operator=(const StaticBatch&) = delete;
+};
\ No newline at end of file
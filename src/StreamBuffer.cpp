@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - StreamBuffer.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StreamBuffer.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace
+{
+    const GLuint64 FENCE_TIMEOUT = 1000000;  ///< Nanoseconds to wait for a fence each attempt
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (Region& region : m_regions)
+    {
+        if (region.fence)
+        {
+            glDeleteSync(region.fence);
+            region.fence = nullptr;
+        }
+    }
+
+    if (m_id != 0)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glDeleteBuffers(1, &m_id);
+        m_id = 0;
+    }
+}
+
+bool StreamBuffer::IsSupported()
+{
+    const int version = ogl_GetMajorVersion() * 10 + ogl_GetMinorVersion();
+    return version >= 44 && glBufferStorage != nullptr;
+}
+
+bool StreamBuffer::Initialise(GLsizeiptr frameSize, int regions)
+{
+    m_regions.resize(std::max(regions, 1));
+    const GLsizeiptr regionCount = static_cast<GLsizeiptr>(m_regions.size());
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_uniformAlignment = alignment > 0 ? alignment : m_uniformAlignment;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_storageAlignment = alignment > 0 ? alignment : m_storageAlignment;
+
+    // Keeps each frame region aligned for any use of the buffer
+    const GLintptr regionAlignment = std::max(m_uniformAlignment, m_storageAlignment);
+    m_frameSize = (frameSize + regionAlignment - 1) / regionAlignment * regionAlignment;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_id);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, m_frameSize * regionCount, nullptr, flags);
+    m_mapped = static_cast<char*>(glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, 0, m_frameSize * regionCount, flags));
+
+    if (HasCallFailed() || !m_mapped)
+    {
+        LogError("Stream: Failed to map buffer");
+        return false;
+    }
+
+    LogInfo("Stream: Mapped " + std::to_string(m_frameSize * regionCount) + " bytes");
+    return true;
+}
+
+void StreamBuffer::BeginFrame()
+{
+    // The region was last written frames ago and the GPU may still be reading it
+    const int region = (m_frame + 1) % static_cast<int>(m_regions.size());
+    WaitForRegion(region, true);
+    BeginWrite(region);
+}
+
+void StreamBuffer::EndFrame()
+{
+    EndWrite();
+    FenceRegion(m_frame);
+}
+
+void StreamBuffer::BeginWrite(int region)
+{
+    m_frame = region;
+    m_used = 0;
+}
+
+void StreamBuffer::EndWrite()
+{
+    m_regions[m_frame].used = m_used;
+}
+
+void StreamBuffer::FenceRegion(int region)
+{
+    m_regions[region].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_bytesStreamed = static_cast<int>(m_regions[region].used);
+    m_fenceWaits = m_frameWaits;
+    m_frameWaits = 0;
+}
+
+bool StreamBuffer::WaitForRegion(int region, bool wait)
+{
+    GLsync& fence = m_regions[region].fence;
+    if (fence)
+    {
+        GLbitfield flags = 0;
+        for (;;)
+        {
+            const GLenum result = glClientWaitSync(fence, flags, flags ? FENCE_TIMEOUT : 0);
+            if (result == GL_ALREADY_SIGNALED ||
+                result == GL_CONDITION_SATISFIED ||
+                result == GL_WAIT_FAILED)
+            {
+                break;
+            }
+            else if (!wait)
+            {
+                return false;
+            }
+
+            // Commands must be flushed or the fence may never signal
+            ++m_frameWaits;
+            flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    return true;
+}
+
+void* StreamBuffer::Allocate(GLsizeiptr size, GLintptr alignment, GLintptr& offset)
+{
+    const GLsizeiptr start = (m_used + alignment - 1) / alignment * alignment;
+    if (start + size > m_frameSize)
+    {
+        LogError("Stream: Frame region of " + std::to_string(m_frameSize) + " bytes is full");
+        return nullptr;
+    }
+
+    m_used = start + size;
+    offset = m_frame * m_frameSize + start;
+    return m_mapped + offset;
+}
+
+bool StreamBuffer::Write(const void* data, GLsizeiptr size, GLintptr alignment, GLintptr& offset)
+{
+    void* memory = Allocate(size, alignment, offset);
+    if (memory)
+    {
+        std::memcpy(memory, data, size);
+        return true;
+    }
+    return false;
+}
+
+GLuint StreamBuffer::GetID() const
+{
+    return m_id;
+}
+
+int StreamBuffer::BytesStreamed() const
+{
+    return m_bytesStreamed;
+}
+
+int StreamBuffer::FenceWaits() const
+{
+    return m_fenceWaits;
+}
+
+GLintptr StreamBuffer::UniformAlignment() const
+{
+    return m_uniformAlignment;
+}
+
+GLintptr StreamBuffer::StorageAlignment() const
+{
+    return m_storageAlignment;
+}
\ No newline at end of file
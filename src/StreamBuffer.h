@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - StreamBuffer.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OpenGL.h"
+
+#include <vector>
+
+/**
+* Persistently mapped ring buffer for data written every frame
+* Each frame writes into its own region which is fenced once submitted, so
+* uploads are a copy into mapped memory without any driver round trip
+* Regions can be written on a thread without the context as only waiting
+* for and fencing a region calls OpenGL
+*/
+class StreamBuffer
+{
+public:
+
+    /**
+    * Constructor
+    */
+    StreamBuffer() = default;
+
+    /**
+    * Destructor
+    */
+    ~StreamBuffer();
+
+    /**
+    * @return whether the OpenGL context supports persistent mapping
+    * @note requires an OpenGL context to be created
+    */
+    static bool IsSupported();
+
+    /**
+    * Creates and maps the buffer
+    * @param frameSize The number of bytes available to each frame
+    * @param regions The number of frames which can be in flight
+    * @return whether initialisation was successful
+    */
+    bool Initialise(GLsizeiptr frameSize, int regions);
+
+    /**
+    * Moves to the next frame region, waiting if the GPU is still reading it
+    */
+    void BeginFrame();
+
+    /**
+    * Fences the region written this frame
+    */
+    void EndFrame();
+
+    /**
+    * Starts writing into a region without waiting for the GPU
+    * @param region The index of the region, which the GPU must have finished reading
+    * @note does not call OpenGL so can be used on any thread
+    */
+    void BeginWrite(int region);
+
+    /**
+    * Finishes writing into the current region
+    * @note does not call OpenGL so can be used on any thread
+    */
+    void EndWrite();
+
+    /**
+    * Fences a region once the commands reading it have been submitted
+    * @param region The index of the region
+    */
+    void FenceRegion(int region);
+
+    /**
+    * Checks whether the GPU has finished reading a region
+    * @param region The index of the region
+    * @param wait Whether to block until the GPU has finished
+    * @return whether the region can be written to
+    */
+    bool WaitForRegion(int region, bool wait);
+
+    /**
+    * Reserves memory in the current frame region
+    * @param size The number of bytes to reserve
+    * @param alignment The alignment required for the offset
+    * @param offset The offset of the memory from the start of the buffer
+    * @return the mapped memory to write to or null if the region is full
+    */
+    void* Allocate(GLsizeiptr size, GLintptr alignment, GLintptr& offset);
+
+    /**
+    * Reserves and fills memory in the current frame region
+    * @param data The data to copy
+    * @param size The number of bytes to copy
+    * @param alignment The alignment required for the offset
+    * @param offset The offset of the memory from the start of the buffer
+    * @return whether the region had enough space
+    */
+    bool Write(const void* data, GLsizeiptr size, GLintptr alignment, GLintptr& offset);
+
+    /**
+    * @return the unique ID of the buffer
+    */
+    GLuint GetID() const;
+
+    /**
+    * @return the number of bytes written in the last frame
+    */
+    int BytesStreamed() const;
+
+    /**
+    * @return the number of times the last frame waited for the GPU
+    */
+    int FenceWaits() const;
+
+    /**
+    * @return the alignment required for uniform buffer offsets
+    */
+    GLintptr UniformAlignment() const;
+
+    /**
+    * @return the alignment required for storage buffer offsets
+    */
+    GLintptr StorageAlignment() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+    * Part of the buffer written by a single frame
+    */
+    struct Region
+    {
+        GLsync fence = nullptr;                  ///< Signalled once the GPU has read the region
+        GLsizeiptr used = 0;                     ///< Bytes written by the last frame
+    };
+
+private:
+
+    GLuint m_id = 0;                             ///< Unique ID of the buffer
+    char* m_mapped = nullptr;                    ///< Persistently mapped memory of the buffer
+    GLsizeiptr m_frameSize = 0;                  ///< Number of bytes in each frame region
+    std::vector<Region> m_regions;               ///< Each frame that can be in flight
+    int m_frame = 0;                             ///< Region being written to
+    GLsizeiptr m_used = 0;                       ///< Bytes used in the current region
+    int m_bytesStreamed = 0;                     ///< Bytes written in the last frame
+    int m_fenceWaits = 0;                        ///< Times the last frame waited for the GPU
+    int m_frameWaits = 0;                        ///< Times the current frame waited for the GPU
+    GLintptr m_uniformAlignment = 256;           ///< Alignment required for uniform offsets
+    GLintptr m_storageAlignment = 256;           ///< Alignment required for storage offsets
+};
\ No newline at end of file
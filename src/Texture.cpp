@@ -21,9 +21,15 @@ Texture::~Texture()
 {
     if(m_initialised)
     {
+        ForgetTextureBinding(m_id);
         glDeleteTextures(1, &m_id);
         m_initialised = false;
     }
+    if(m_pixels)
+    {
+        SOIL_free_image_data(m_pixels);
+        m_pixels = nullptr;
+    }
 }
 
 const std::string& Texture::Name() const
@@ -36,74 +42,153 @@ const std::string& Texture::Path() const
     return m_path;
 }
 
+bool Texture::Load()
+{
+    if(!m_pixels)
+    {
+        m_pixels = SOIL_load_image(m_path.c_str(), &m_width, &m_height, 0, SOIL_LOAD_RGBA);
+        if(!m_pixels)
+        {
+            LogError("Failed to decode " + m_path + " texture");
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Texture::Initialise()
 {
+    if(!Load())
+    {
+        return false;
+    }
+
     glGenTextures(1, &m_id);
     m_initialised = true;
-    glBindTexture(GL_TEXTURE_2D, m_id);
+    m_type = GL_TEXTURE_2D;
+    BindTexture(0, m_type, m_id);
+
+    if (!UploadTexture(m_type))
+    {
+        return false;
+    }
 
-    return LoadTexture(GL_TEXTURE_2D, m_path) && 
-        CreateMipMaps() && !HasCallFailed();
+    if (!SetFiltering(m_type, m_filter))
+    {
+        LogError("Failed to set filtering for " + m_name);
+        return false;
+    }
+
+    if (!CreateMipMaps(m_type, m_filter))
+    {
+        LogError("Mipmap creation failed for " + m_name);
+        return false;
+    }
+
+    return !HasCallFailed();
 }
 
-bool Texture::SetFiltering()
+bool Texture::InitialiseLayer(unsigned int arrayID, int layer)
 {
-    const auto type = GL_TEXTURE_2D;
-    const auto magFilter = m_filter == Texture::NEAREST ? GL_NEAREST : GL_LINEAR;
-    const auto minFilter = m_filter == Texture::NEAREST ? GL_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+    if(!Load())
+    {
+        return false;
+    }
+
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_width, m_height, 1, 
+        GL_RGBA, GL_UNSIGNED_BYTE, m_pixels);
+
+    SOIL_free_image_data(m_pixels);
+    m_pixels = nullptr;
+
+    // The array is owned by the texture array so is never deleted here
+    m_id = arrayID;
+    m_type = GL_TEXTURE_2D_ARRAY;
+    m_layer = layer;
+
+    if(HasCallFailed())
+    {
+        LogError("Failed to load " + m_path + " texture into array");
+        return false;
+    }
+    return true;
+}
+
+bool Texture::SetFiltering(int type, Filter filter)
+{
+    const auto magFilter = filter == Texture::NEAREST ? GL_NEAREST : GL_LINEAR;
+    const auto minFilter = filter == Texture::NEAREST ? GL_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
 
     glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(type, GL_TEXTURE_MIN_FILTER, minFilter);
     glTexParameteri(type, GL_TEXTURE_MAG_FILTER, magFilter);
 
-    if (m_filter == Texture::ANISOTROPIC)
+    if (filter == Texture::ANISOTROPIC)
     {
         const float MAX_ANISOTROPY = 16.0f;
         const auto GL_TEXTURE_MAX_ANISOTROPY_EXT = 0x84FE;
         glTexParameterf(type, GL_TEXTURE_MAX_ANISOTROPY_EXT, MAX_ANISOTROPY);
     }
 
-    if(HasCallFailed())
-    {
-        LogError("Failed to set filtering for " + m_name);
-        return false;
-    }
-    return true;
+    return !HasCallFailed();
 }
 
-bool Texture::CreateMipMaps()
+bool Texture::CreateMipMaps(int type, Filter filter)
 {
-    if (m_filter != Texture::NEAREST)
+    if (filter != Texture::NEAREST)
     {
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        if(HasCallFailed())
-        {
-            LogError("Mipmap creation failed for " + m_name);
-            return false;
-        }
+        glGenerateMipmap(type);
+        return !HasCallFailed();
     }
     return true;
 }
 
-bool Texture::LoadTexture(int type, const std::string& path)
+bool Texture::UploadTexture(int type)
 {
-    int width, height;
-    unsigned char* image = SOIL_load_image(path.c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
-    glTexImage2D(type, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    SOIL_free_image_data(image);
+    glTexImage2D(type, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels);
+    SOIL_free_image_data(m_pixels);
+    m_pixels = nullptr;
 
     if(HasCallFailed())
     {
-        LogError("Failed to load " + path + " texture");
+        LogError("Failed to load " + m_path + " texture");
         return false;
     }
-
-    return SetFiltering();
+    return true;
 }
 
 unsigned int Texture::GetID() const
 {
     return m_id;
+}
+
+unsigned int Texture::GetType() const
+{
+    return m_type;
+}
+
+bool Texture::IsPacked() const
+{
+    return m_type == GL_TEXTURE_2D_ARRAY;
+}
+
+int Texture::Layer() const
+{
+    return m_layer;
+}
+
+Texture::Filter Texture::GetFilter() const
+{
+    return m_filter;
+}
+
+int Texture::Width() const
+{
+    return m_width;
+}
+
+int Texture::Height() const
+{
+    return m_height;
 }
\ No newline at end of file
@@ -40,11 +40,42 @@ public:
     ~Texture();
 
     /**
-    * Initialises the texture
+    * Decodes the texture file into memory
+    * @note does not require the OpenGL context and can be called from any thread
+    * @return whether decoding was successful
+    */
+    bool Load();
+
+    /**
+    * Initialises the texture, decoding the file if not already loaded
     * @return whether initialisation was successful
     */
     bool Initialise();
 
+    /**
+    * Uploads the decoded texture as a layer of a texture array instead of its own texture
+    * @param arrayID The unique ID of the texture array, which must be bound
+    * @param layer The layer of the array to fill
+    * @return whether uploading was successful
+    */
+    bool InitialiseLayer(unsigned int arrayID, int layer);
+
+    /**
+    * Sets the filtering for the bound texture
+    * @param type The type of opengl texture bound
+    * @param filter The type of filtering to use
+    * @return whether setting was successful
+    */
+    static bool SetFiltering(int type, Filter filter);
+
+    /**
+    * Creates the mipmaps for the bound texture if the filtering uses them
+    * @param type The type of opengl texture bound
+    * @param filter The type of filtering used
+    * @return whether creation was successful
+    */
+    static bool CreateMipMaps(int type, Filter filter);
+
     /**
     * @return the filename of the texture
     */
@@ -56,43 +87,65 @@ public:
     const std::string& Path() const;
 
     /**
-    * @return the unique ID for the texture
+    * @return the unique ID for the texture, or of its texture array if packed
     */
     unsigned int GetID() const;
 
-private:
+    /**
+    * @return the type of opengl texture holding the texture
+    */
+    unsigned int GetType() const;
 
     /**
-    * Prevent copying
+    * @return whether the texture is a layer of a texture array
     */
-    Texture(const Texture&) = delete;
-    Texture& operator=(const Texture&) = delete;
+    bool IsPacked() const;
 
     /**
-    * Creates the mipmaps for the texture
-    * @return whether creation was successful
+    * @return the layer of the texture array holding the texture
     */
-    bool CreateMipMaps();
+    int Layer() const;
 
     /**
-    * Sets the filtering for the texture
-    * @return whether setting was successful
+    * @return the type of filtering for this texture
+    */
+    Filter GetFilter() const;
+
+    /**
+    * @return the width of the decoded texture
+    */
+    int Width() const;
+
+    /**
+    * @return the height of the decoded texture
     */
-    bool SetFiltering();
+    int Height() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
 
     /**
-    * Loads a texture from file
-    * @param type The type of opengl texture to load
-    * @param path The path to the texture
-    * @return whether loading was successful
+    * Sends the decoded texture to the GPU
+    * @param type The type of opengl texture to upload to
+    * @return whether uploading was successful
     */
-    bool LoadTexture(int type, const std::string& path);
+    bool UploadTexture(int type);
 
 private:
 
     Filter m_filter;             ///< The type of filtering for this texture
     bool m_initialised = false;  ///< Whether this texture is initialised
     unsigned int m_id = 0;       ///< Unique id for the texture
+    unsigned int m_type = 0;     ///< Type of opengl texture holding the texture
+    int m_layer = 0;             ///< Layer of the texture array holding the texture
     std::string m_name;          ///< Name of the texture
     std::string m_path;          ///< Path to the texture
+    unsigned char* m_pixels = nullptr;  ///< Decoded texture waiting to be uploaded
+    int m_width = 0;                    ///< Width of the decoded texture
+    int m_height = 0;                   ///< Height of the decoded texture
 };
\ No newline at end of file
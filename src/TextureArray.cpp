@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - TextureArray.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TextureArray.h"
+#include "OpenGL.h"
+
+#include <map>
+#include <tuple>
+
+TextureArray::TextureArray(const std::string& name)
+    : m_name(name)
+{
+}
+
+TextureArray::~TextureArray()
+{
+    if(m_initialised)
+    {
+        ForgetTextureBinding(m_id);
+        glDeleteTextures(1, &m_id);
+        m_initialised = false;
+    }
+}
+
+bool TextureArray::Build(const std::vector<std::unique_ptr<Texture>>& textures,
+                         std::vector<std::unique_ptr<TextureArray>>& arrays)
+{
+    // Layers keep the order of the textures so packing is the same every run
+    typedef std::tuple<int, int, Texture::Filter> Format;
+    std::map<Format, std::vector<Texture*>> formats;
+    for (const auto& texture : textures)
+    {
+        if (texture && texture->Load())
+        {
+            formats[Format(texture->Width(), texture->Height(), 
+                texture->GetFilter())].push_back(texture.get());
+        }
+    }
+
+    bool success = true;
+    for (const auto& format : formats)
+    {
+        const auto& layers = format.second;
+        arrays.push_back(std::make_unique<TextureArray>(layers[0]->Name() + " array"));
+        success &= arrays.back()->Initialise(layers);
+    }
+
+    LogInfo("Textures: Packed " + std::to_string(textures.size()) + 
+        " textures into " + std::to_string(arrays.size()) + " arrays");
+    return success;
+}
+
+bool TextureArray::Initialise(const std::vector<Texture*>& layers)
+{
+    const Texture& first = *layers[0];
+    m_layers = static_cast<int>(layers.size());
+
+    glGenTextures(1, &m_id);
+    m_initialised = true;
+    BindTexture(0, GL_TEXTURE_2D_ARRAY, m_id);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, first.Width(), first.Height(), 
+        m_layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    if(HasCallFailed())
+    {
+        LogError("Failed to create " + m_name + " texture array");
+        return false;
+    }
+
+    for (int i = 0; i < m_layers; ++i)
+    {
+        if (!layers[i]->InitialiseLayer(m_id, i))
+        {
+            return false;
+        }
+    }
+
+    if (!Texture::SetFiltering(GL_TEXTURE_2D_ARRAY, first.GetFilter()))
+    {
+        LogError("Failed to set filtering for " + m_name);
+        return false;
+    }
+
+    if (!Texture::CreateMipMaps(GL_TEXTURE_2D_ARRAY, first.GetFilter()))
+    {
+        LogError("Mipmap creation failed for " + m_name);
+        return false;
+    }
+
+    return true;
+}
+
+const std::string& TextureArray::Name() const
+{
+    return m_name;
+}
+
+unsigned int TextureArray::GetID() const
+{
+    return m_id;
+}
+
+int TextureArray::Layers() const
+{
+    return m_layers;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - TextureArray.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Texture.h"
+
+#include <memory>
+
+/**
+* Texture array holding textures of the same size and filtering as layers
+* Allows switching between the textures with a layer index instead of a bind
+*/
+class TextureArray
+{
+public:
+
+    /**
+    * Constructor
+    * @param name The name of the texture array
+    */
+    TextureArray(const std::string& name);
+
+    /**
+    * Destructor
+    */
+    ~TextureArray();
+
+    /**
+    * Packs the decoded textures into arrays, one for each size and filtering
+    * @param textures The decoded textures to pack, which become layers of the arrays
+    * @param arrays The container to add the arrays to
+    * @return whether all arrays were created
+    */
+    static bool Build(const std::vector<std::unique_ptr<Texture>>& textures,
+                      std::vector<std::unique_ptr<TextureArray>>& arrays);
+
+    /**
+    * Creates the array and uploads the textures into it
+    * @param layers The decoded textures to upload, all of the same size and filtering
+    * @return whether initialisation was successful
+    */
+    bool Initialise(const std::vector<Texture*>& layers);
+
+    /**
+    * @return the name of the texture array
+    */
+    const std::string& Name() const;
+
+    /**
+    * @return the unique ID for the texture array
+    */
+    unsigned int GetID() const;
+
+    /**
+    * @return the number of layers in the array
+    */
+    int Layers() const;
+
+private:
+
+    /**
+    * Prevent copying
+    */
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+
+private:
+
+    bool m_initialised = false;  ///< Whether this array is initialised
+    unsigned int m_id = 0;       ///< Unique id for the texture array
+    int m_layers = 0;            ///< Number of layers in the array
+    std::string m_name;          ///< Name of the texture array
+};
\ No newline at end of file
@@ -7,14 +7,14 @@
 
 #include <Windows.h>
 
-LARGE_INTEGER START = {};
-LARGE_INTEGER CURRENT = {};
-LARGE_INTEGER FREQUENCY = {};
-
 Timer::Timer()
 {
-    QueryPerformanceFrequency(&FREQUENCY);
-    QueryPerformanceCounter(&START);
+    LARGE_INTEGER frequency = {};
+    LARGE_INTEGER start = {};
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    m_frequency = frequency.QuadPart;
+    m_start = start.QuadPart;
 }
 
 void Timer::AddToTweaker(Tweaker& tweaker)
@@ -27,8 +27,9 @@ void Timer::AddToTweaker(Tweaker& tweaker)
 void Timer::UpdateTimer()
 {
     m_previousElapsedMilliseconds = m_elapsedMilliseconds;
-    QueryPerformanceCounter(&CURRENT);
-    m_elapsedMilliseconds = (CURRENT.QuadPart - START.QuadPart) * 1000.0 / FREQUENCY.QuadPart;
+    LARGE_INTEGER current = {};
+    QueryPerformanceCounter(&current);
+    m_elapsedMilliseconds = (current.QuadPart - m_start) * 1000.0 / m_frequency;
     m_deltaTime = static_cast<float>(m_elapsedMilliseconds - m_previousElapsedMilliseconds);
     m_deltaTimeCounter += m_deltaTime;
 
@@ -42,5 +42,7 @@ private:
     unsigned int m_fps = 0;
     unsigned int m_fpsCounter = 0;
     float m_deltaTimeCounter = 0.0f;
+    long long m_start = 0;
+    long long m_frequency = 1;
 };
 
@@ -28,6 +28,19 @@ void ToonText::Show(const glm::vec3& position)
 
 void ToonText::Tick(const Camera& camera, float deltatime)
 {
+    for (int i = 0; i < Instances(); ++i)
+    {
+        Tick(camera, deltatime, i);
+    }
+}
+
+void ToonText::Tick(const Camera& camera, float deltatime, int index)
+{
+    if (!Visible(index))
+    {
+        return;
+    }
+
     const auto& cameraPosition = camera.Position();
     const auto& cameraUp = camera.Up();
 
@@ -36,59 +49,53 @@ void ToonText::Tick(const Camera& camera, float deltatime)
     const float maxScaleIncrease = 4.0f;
     const float maxScale = minScale + maxScaleIncrease;
 
-    for (int i = 0; i < Instances(); ++i)
+    auto scale = Scale(index);
+    scale.y = scale.y + (scale.z == 0.0f ? deltatime : -deltatime);
+    scale.x = minScale + std::min((scale.y / maxTimeScaling) * maxScaleIncrease, maxScaleIncrease);
+
+    if (scale.z == 0.0f && scale.x >= maxScale)
     {
-        if (Visible(i))
-        {
-            auto scale = Scale(i);
-            scale.y = scale.y + (scale.z == 0.0f ? deltatime : -deltatime);
-            scale.x = minScale + std::min((scale.y / maxTimeScaling) * maxScaleIncrease, maxScaleIncrease);
-
-            if (scale.z == 0.0f && scale.x >= maxScale)
-            {
-                scale.y = maxTimeScaling;
-                scale.z = 1.0f;
-            }
-            else if (scale.z != 0.0f && scale.x <= 0.0f)
-            {
-                SetVisible(false, i);
-                continue;
-            }
-
-            const auto& position = Position(i);
-
-            glm::vec3 right, up, forward;
-            forward.x = cameraPosition.x - position.x;
-            forward.y = cameraPosition.y - position.y;
-            forward.z = cameraPosition.z - position.z;
-
-            forward = glm::normalize(forward);
-            right = glm::cross(forward, cameraUp);
-            up = glm::cross(forward, right);
-
-            glm::mat4 scaleMatrix;
-            scaleMatrix[0][0] = -scale.x;
-            scaleMatrix[1][1] = scale.x;
-            scaleMatrix[2][2] = -scale.x;
-
-            glm::mat4 rotateMatrix;
-            rotateMatrix[0][0] = right.x;
-            rotateMatrix[0][1] = right.y;
-            rotateMatrix[0][2] = right.z;
-            rotateMatrix[1][0] = up.x;
-            rotateMatrix[1][1] = up.y;
-            rotateMatrix[1][2] = up.z;
-            rotateMatrix[2][0] = forward.x;
-            rotateMatrix[2][1] = forward.y;
-            rotateMatrix[2][2] = forward.z;
-
-            glm::mat4 translateMatrix;
-            translateMatrix[3][0] = position.x;
-            translateMatrix[3][1] = position.y;
-            translateMatrix[3][2] = position.z;
-
-            Scale(scale, i);
-            SetWorld(translateMatrix * rotateMatrix * scaleMatrix, i);
-        }
+        scale.y = maxTimeScaling;
+        scale.z = 1.0f;
+    }
+    else if (scale.z != 0.0f && scale.x <= 0.0f)
+    {
+        SetVisible(false, index);
+        return;
     }
+
+    const auto& position = Position(index);
+
+    glm::vec3 right, up, forward;
+    forward.x = cameraPosition.x - position.x;
+    forward.y = cameraPosition.y - position.y;
+    forward.z = cameraPosition.z - position.z;
+
+    forward = glm::normalize(forward);
+    right = glm::cross(forward, cameraUp);
+    up = glm::cross(forward, right);
+
+    glm::mat4 scaleMatrix;
+    scaleMatrix[0][0] = -scale.x;
+    scaleMatrix[1][1] = scale.x;
+    scaleMatrix[2][2] = -scale.x;
+
+    glm::mat4 rotateMatrix;
+    rotateMatrix[0][0] = right.x;
+    rotateMatrix[0][1] = right.y;
+    rotateMatrix[0][2] = right.z;
+    rotateMatrix[1][0] = up.x;
+    rotateMatrix[1][1] = up.y;
+    rotateMatrix[1][2] = up.z;
+    rotateMatrix[2][0] = forward.x;
+    rotateMatrix[2][1] = forward.y;
+    rotateMatrix[2][2] = forward.z;
+
+    glm::mat4 translateMatrix;
+    translateMatrix[3][0] = position.x;
+    translateMatrix[3][1] = position.y;
+    translateMatrix[3][2] = position.z;
+
+    Scale(scale, index);
+    SetWorld(translateMatrix * rotateMatrix * scaleMatrix, index);
 }
\ No newline at end of file
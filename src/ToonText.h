@@ -31,4 +31,10 @@ public:
     * Ticks all instances of the toon text and faces them towards the camera
     */
     void Tick(const Camera& camera, float deltatime);
+
+    /**
+    * Ticks a single instance of the toon text and faces it towards the camera
+    * @note only modifies the given instance so may be called in parallel
+    */
+    void Tick(const Camera& camera, float deltatime, int index);
 };
\ No newline at end of file
@@ -9,8 +9,8 @@
 #include <string>
 #include <algorithm>
 
-constexpr int WINDOW_WIDTH = 800;
-constexpr int WINDOW_HEIGHT = 600;
+constexpr int WINDOW_WIDTH = 800;   ///< Width the window is created with
+constexpr int WINDOW_HEIGHT = 600;  ///< Height the window is created with
 
 /**
 * Converts degrees to radians
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - VertexFormat.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VertexFormat.h"
+
+#include "glm/gtc/packing.hpp"
+
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    const int POSITION_COMPONENTS = 3;
+    const int UV_COMPONENTS = 2;
+    const float MAX_HALF_UV = 2.0f;               ///< Larger UVs lose too much precision as half floats
+    const unsigned int MAX_SHORT_VERTICES = 65536; ///< Vertices addressable with 16-bit indices
+}
+
+void VertexFormat::Initialise(const std::vector<float>& vertices, int componentCount)
+{
+    *this = VertexFormat();
+    m_componentCount = componentCount;
+    const bool hasUVs = componentCount == 5 || componentCount == 8;
+    const bool hasNormals = componentCount >= 6;
+
+    // Pass position as a vec3 into a vec4 slot to use the optimization
+    // where the 'w' component is automatically set as 1.0
+    Element& position = m_elements[POSITION];
+    position.used = true;
+    position.components = POSITION_COMPONENTS;
+    position.type = GL_FLOAT;
+    position.offset = 0;
+    m_stride = POSITION_COMPONENTS * sizeof(float);
+
+    if (hasUVs)
+    {
+        float maxUV = 0.0f;
+        for (unsigned int i = POSITION_COMPONENTS; i + 1 < vertices.size(); i += componentCount)
+        {
+            maxUV = std::max(maxUV, std::max(std::abs(vertices[i]), std::abs(vertices[i + 1])));
+        }
+
+        const bool halfFloat = maxUV <= MAX_HALF_UV;
+        Element& uvs = m_elements[UVS];
+        uvs.used = true;
+        uvs.components = UV_COMPONENTS;
+        uvs.type = halfFloat ? GL_HALF_FLOAT : GL_FLOAT;
+        uvs.offset = m_stride;
+        m_stride += halfFloat ? sizeof(uint32_t) : UV_COMPONENTS * sizeof(float);
+    }
+
+    if (hasNormals)
+    {
+        // Packed types require all four components, the shader ignores 'w'
+        Element& normal = m_elements[NORMAL];
+        normal.used = true;
+        normal.components = 4;
+        normal.type = GL_INT_2_10_10_10_REV;
+        normal.normalized = GL_TRUE;
+        normal.offset = m_stride;
+        m_stride += sizeof(uint32_t);
+    }
+
+    const unsigned int vertexCount = componentCount > 0 ? vertices.size() / componentCount : 0;
+    m_indexType = vertexCount <= MAX_SHORT_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void VertexFormat::PackVertices(const std::vector<float>& vertices, std::vector<char>& buffer) const
+{
+    const unsigned int vertexCount = vertices.size() / m_componentCount;
+    buffer.resize(vertexCount * m_stride);
+
+    const Element& uvs = m_elements[UVS];
+    const Element& normal = m_elements[NORMAL];
+
+    for (unsigned int i = 0; i < vertexCount; ++i)
+    {
+        const float* source = &vertices[i * m_componentCount];
+        char* destination = &buffer[i * m_stride];
+
+        std::memcpy(destination, source, POSITION_COMPONENTS * sizeof(float));
+        source += POSITION_COMPONENTS;
+
+        if (uvs.used)
+        {
+            if (uvs.type == GL_HALF_FLOAT)
+            {
+                const uint32_t packed = glm::packHalf2x16(glm::vec2(source[0], source[1]));
+                std::memcpy(destination + uvs.offset, &packed, sizeof(packed));
+            }
+            else
+            {
+                std::memcpy(destination + uvs.offset, source, UV_COMPONENTS * sizeof(float));
+            }
+            source += UV_COMPONENTS;
+        }
+
+        if (normal.used)
+        {
+            const uint32_t packed = glm::packSnorm3x10_1x2(
+                glm::vec4(source[0], source[1], source[2], 0.0f));
+            std::memcpy(destination + normal.offset, &packed, sizeof(packed));
+        }
+    }
+}
+
+void VertexFormat::PackIndices(const std::vector<unsigned int>& indices, std::vector<char>& buffer) const
+{
+    if (m_indexType == GL_UNSIGNED_SHORT)
+    {
+        buffer.resize(indices.size() * sizeof(uint16_t));
+        uint16_t* destination = reinterpret_cast<uint16_t*>(buffer.data());
+        for (unsigned int i = 0; i < indices.size(); ++i)
+        {
+            destination[i] = static_cast<uint16_t>(indices[i]);
+        }
+    }
+    else
+    {
+        buffer.resize(indices.size() * sizeof(uint32_t));
+        std::memcpy(buffer.data(), indices.data(), buffer.size());
+    }
+}
+
+const VertexFormat::Element& VertexFormat::GetElement(int attribute) const
+{
+    return m_elements[attribute];
+}
+
+void VertexFormat::EnableAttributes(unsigned int attributes) const
+{
+    for (int attribute = 0; attribute < MAX_ATTRIBUTES; ++attribute)
+    {
+        const Element& element = m_elements[attribute];
+        if (element.used && (attributes & (1u << attribute)))
+        {
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribPointer(attribute, element.components, element.type,
+                element.normalized, m_stride, BufferOffset(element.offset));
+        }
+    }
+}
+
+GLsizei VertexFormat::Stride() const
+{
+    return m_stride;
+}
+
+GLenum VertexFormat::IndexType() const
+{
+    return m_indexType;
+}
+
+int VertexFormat::IndexSize() const
+{
+    return m_indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+}
\ No newline at end of file
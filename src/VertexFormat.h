@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - VertexFormat.h
+////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OpenGL.h"
+
+#include <vector>
+
+/**
+* Describes how the vertices and indices of a mesh are packed for the GPU
+* Meshes keep full precision floats while the buffers use the most compact format
+*/
+class VertexFormat
+{
+public:
+
+    /**
+    * Attributes of a vertex, matching the location in the shader
+    */
+    enum Attribute
+    {
+        POSITION,
+        UVS,
+        NORMAL,
+        INSTANCE,       ///< Index into the per-instance data, set by indirect rendering
+        MAX_ATTRIBUTES
+    };
+
+    /**
+    * Information for a single attribute within the packed vertex
+    */
+    struct Element
+    {
+        bool used = false;                 ///< Whether the vertex contains this attribute
+        GLint components = 0;              ///< Number of components passed to the shader
+        GLenum type = GL_FLOAT;            ///< Type of each component
+        GLboolean normalized = GL_FALSE;   ///< Whether integer components are normalized
+        int offset = 0;                    ///< Byte offset from the start of the vertex
+    };
+
+    /**
+    * Chooses the most compact format able to hold the mesh
+    * @param vertices The interleaved position/uv/normal float vertices
+    * @param componentCount The number of floats in each vertex
+    * @note UVs are present for 5 or 8 components and normals for 6 or 8 components
+    */
+    void Initialise(const std::vector<float>& vertices, int componentCount);
+
+    /**
+    * Packs the float vertices into the format
+    * @param vertices The interleaved position/uv/normal float vertices
+    * @param buffer The container to fill with the packed vertices
+    */
+    void PackVertices(const std::vector<float>& vertices, std::vector<char>& buffer) const;
+
+    /**
+    * Packs the indices into the format
+    * @param indices The indices for the vertices
+    * @param buffer The container to fill with the packed indices
+    */
+    void PackIndices(const std::vector<unsigned int>& indices, std::vector<char>& buffer) const;
+
+    /**
+    * @param attribute The attribute of the vertex
+    * @return information for the attribute within the packed vertex
+    */
+    const Element& GetElement(int attribute) const;
+
+    /**
+    * Enables and points each attribute at the bound vertex buffer
+    * @param attributes Mask of the attributes read by the shader
+    * @note records into the bound vertex array, attributes missing from
+    *       the vertex stay disabled and use the default value
+    */
+    void EnableAttributes(unsigned int attributes) const;
+
+    /**
+    * @return the number of bytes in a packed vertex
+    */
+    GLsizei Stride() const;
+
+    /**
+    * @return the type of each packed index
+    */
+    GLenum IndexType() const;
+
+    /**
+    * @return the number of bytes in each packed index
+    */
+    int IndexSize() const;
+
+private:
+
+    Element m_elements[MAX_ATTRIBUTES];   ///< Information for each attribute
+    GLsizei m_stride = 0;                 ///< Number of bytes in a packed vertex
+    int m_componentCount = 0;             ///< Number of floats in each unpacked vertex
+    GLenum m_indexType = GL_UNSIGNED_INT; ///< Type of each packed index
+};
\ No newline at end of file
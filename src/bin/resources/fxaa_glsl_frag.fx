@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - fxaa_glsl_frag.fx
+////////////////////////////////////////////////////////////////////////////////////////
+
+#version 150
+
+in vec2 ex_UVs;
+out vec4 out_Color;
+
+uniform sampler2D SceneSampler;
+uniform vec2 uvScale;
+
+uniform float fxaaSpanMax;
+uniform float fxaaReduceMul;
+uniform float fxaaReduceMin;
+uniform float fxaaEdgeThreshold;
+uniform float fxaaEdgeThresholdMin;
+
+float Luma(vec3 colour)
+{
+    return dot(colour, vec3(0.299, 0.587, 0.114));
+}
+
+vec3 Sample(vec2 uvs)
+{
+    // Keeps samples inside the area of the target the scene was rendered to
+    vec2 uvMax = uvScale - 0.5 / vec2(textureSize(SceneSampler, 0));
+    return texture(SceneSampler, min(uvs, uvMax)).rgb;
+}
+ 
+void main(void)
+{
+    vec2 texel = 1.0 / vec2(textureSize(SceneSampler, 0));
+
+    // Luma of the pixel and the four diagonal corners around it
+    vec3 rgbM = Sample(ex_UVs);
+    float lumaM = Luma(rgbM);
+    float lumaNW = Luma(Sample(ex_UVs + vec2(-1.0, -1.0) * texel));
+    float lumaNE = Luma(Sample(ex_UVs + vec2(1.0, -1.0) * texel));
+    float lumaSW = Luma(Sample(ex_UVs + vec2(-1.0, 1.0) * texel));
+    float lumaSE = Luma(Sample(ex_UVs + vec2(1.0, 1.0) * texel));
+
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // Low contrast pixels are not edges so skip searching along them
+    if (lumaMax - lumaMin < max(fxaaEdgeThresholdMin, lumaMax * fxaaEdgeThreshold))
+    {
+        out_Color = vec4(rgbM, 1.0);
+        return;
+    }
+
+    // Direction along the edge, scaled so the shortest axis is one pixel
+    vec2 direction;
+    direction.x = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+    direction.y = ((lumaNW + lumaSW) - (lumaNE + lumaSE));
+
+    float reduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * fxaaReduceMul, fxaaReduceMin);
+    float scale = 1.0 / (min(abs(direction.x), abs(direction.y)) + reduce);
+    direction = clamp(direction * scale, vec2(-fxaaSpanMax), vec2(fxaaSpanMax)) * texel;
+
+    // Blend samples along the edge, falling back to the nearer pair if the wider one overshoots
+    vec3 rgbA = 0.5 * (
+        Sample(ex_UVs + direction * (1.0 / 3.0 - 0.5)) +
+        Sample(ex_UVs + direction * (2.0 / 3.0 - 0.5)));
+
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (
+        Sample(ex_UVs + direction * -0.5) +
+        Sample(ex_UVs + direction * 0.5));
+
+    float lumaB = Luma(rgbB);
+    out_Color = vec4((lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB, 1.0);
+}
\ No newline at end of file
@@ -7,53 +7,21 @@
 in vec2 ex_UVs;
 out vec4 out_Color;
 
-uniform sampler2DMS SceneSampler;
-uniform sampler2DMS NormalSampler;
-
-uniform float finalMask;
-uniform float sceneMask;
-uniform float normalMask;
-uniform float toonlineMask;
+uniform sampler2D SceneSampler;
+uniform sampler2D NormalSampler;
+uniform sampler2D ToonlineSampler;
  
 void main(void)
 {
-    // Multisampling for main scene
-    vec2 window = vec2(WINDOW_WIDTH, WINDOW_HEIGHT);
-    ivec2 uvs = ivec2(ex_UVs.x * window.x, ex_UVs.y * window.y);
-    vec4 scene = vec4(0, 0, 0, 0);
-    for (int i = 0; i < SAMPLES; ++i)
-    {
-        scene += texelFetch(SceneSampler, uvs, i);
-    }
-    scene *= (1.0 / SAMPLES);
-    vec4 final = scene;
-
-    // Sample normals of four corners around pixel
-    float offset = 0.0009;
-    vec4 normal = texelFetch(NormalSampler, uvs, 0);
-
-    uvs = ivec2((ex_UVs.x - offset) * window.x, (ex_UVs.y - offset) * window.y);
-    vec4 n1 = texelFetch(NormalSampler, uvs, 0);
-
-    uvs = ivec2((ex_UVs.x + offset) * window.x, (ex_UVs.y + offset) * window.y);
-    vec4 n2 = texelFetch(NormalSampler, uvs, 0);
-
-    uvs = ivec2((ex_UVs.x + offset) * window.x, (ex_UVs.y - offset) * window.y);
-    vec4 n3 = texelFetch(NormalSampler, uvs, 0);
-
-    uvs = ivec2((ex_UVs.x - offset) * window.x, (ex_UVs.y + offset) * window.y);
-    vec4 n4 = texelFetch(NormalSampler, uvs, 0);
-
-    // Determine the estimated difference between the pixel normal and surrounding
-    vec4 diagonal1 = abs(n1 - n2);
-    vec4 diagonal2 = abs(n3 - n4);
-    vec4 diagonalDelta = diagonal1 + diagonal2;
-    float edgeAmount = 1.0 - clamp(length(diagonalDelta), 0.0, 1.0);
-    final *= edgeAmount;
-
-    // Masking the selected texture
-    out_Color.rgb = final.rgb * finalMask;
-    out_Color.rgb += scene.rgb * sceneMask;
-    out_Color.rgb += normal.rgb * normalMask;
-    out_Color.rgb += vec3(edgeAmount) * toonlineMask;
+    // POST_MAP selects the permutation so only the displayed map is sampled
+#if POST_MAP == FINAL_MAP
+    vec3 scene = texture(SceneSampler, ex_UVs).rgb;
+    out_Color = vec4(scene * texture(ToonlineSampler, ex_UVs).r, 1.0);
+#elif POST_MAP == SCENE_MAP
+    out_Color = vec4(texture(SceneSampler, ex_UVs).rgb, 1.0);
+#elif POST_MAP == NORMAL_MAP
+    out_Color = vec4(texture(NormalSampler, ex_UVs).rgb, 1.0);
+#else
+    out_Color = vec4(texture(ToonlineSampler, ex_UVs).rrr, 1.0);
+#endif
 }
\ No newline at end of file
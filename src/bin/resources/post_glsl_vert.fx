@@ -7,9 +7,12 @@
 in vec4 in_Position;
 in vec2 in_UVs;
 out vec2 ex_UVs;
+
+uniform vec2 uvScale;
  
 void main(void)
 {
     gl_Position = in_Position;
-    ex_UVs = in_UVs;
+    // Only part of the target is used when the scene renders below full resolution
+    ex_UVs = in_UVs * uvScale;
 }
\ No newline at end of file
@@ -6,7 +6,13 @@
 
 in vec4 in_Position;
 uniform mat4 world;
-uniform mat4 viewProjection;
+
+// Bound to FRAME_BINDING by the shader as #version 150 can't set the binding
+layout(std140) uniform FrameConstants
+{
+    mat4 viewProjection;
+    mat4 shadowProjection;
+};
  
 void main(void)
 {
@@ -12,20 +12,18 @@ out vec2 ex_UVs;
 out vec3 ex_Normal;
 
 uniform mat4 world;
-uniform mat4 viewProjection;
-uniform vec3 planePosition;
-uniform vec3 planeNormal;
 
-void main(void)
+// Bound to FRAME_BINDING by the shader as #version 150 can't set the binding
+layout(std140) uniform FrameConstants
 {
-    float distance = abs(dot((in_Position.xyz - planePosition), planeNormal));
-    vec3 pointToPlane = -distance * planeNormal;
-
-    vec4 position;
-    position.xyz = in_Position.xyz + pointToPlane;
-    position.w = in_Position.w;
+    mat4 viewProjection;
+    mat4 shadowProjection;
+};
 
-    gl_Position = viewProjection * world * position;
+void main(void)
+{
+    // Projection flattens the world position onto the ground plane
+    gl_Position = shadowProjection * world * in_Position;
 
     ex_UVs = in_UVs;
     ex_Normal = (world * vec4(in_Normal, 0.0)).xyz;
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - shadowinstanced_glsl_vert.fx
+////////////////////////////////////////////////////////////////////////////////////////
+
+#version 430
+
+// Locations match VertexFormat::Attribute
+layout(location = 0) in vec4 in_Position;
+layout(location = 1) in vec2 in_UVs;
+layout(location = 2) in vec3 in_Normal;
+
+out vec2 ex_UVs;
+out vec3 ex_Normal;
+
+layout(std430, binding = INSTANCE_BINDING) readonly buffer InstanceData
+{
+    mat4 worlds[];
+};
+
+layout(std140, binding = FRAME_BINDING) uniform FrameConstants
+{
+    mat4 viewProjection;
+    mat4 shadowProjection;
+};
+
+void main(void)
+{
+    mat4 world = worlds[gl_InstanceID];
+
+    // Projection flattens the world position onto the ground plane
+    gl_Position = shadowProjection * world * in_Position;
+
+    ex_UVs = in_UVs;
+    ex_Normal = (world * vec4(in_Normal, 0.0)).xyz;
+}
@@ -8,10 +8,19 @@ out vec4 out_Color[SCENE_TEXTURES];
 
 in vec2 ex_UVs;
 
+#ifdef TEXTURE_ARRAYS
+flat in float ex_Layer;
+uniform sampler2DArray DiffuseSampler;
+#else
 uniform sampler2D DiffuseSampler;
+#endif
  
 void main(void)
 {
+#ifdef TEXTURE_ARRAYS
+    out_Color[ID_COLOUR].rgba = texture(DiffuseSampler, vec3(ex_UVs, ex_Layer)).rgba;
+#else
     out_Color[ID_COLOUR].rgba = texture(DiffuseSampler, ex_UVs).rgba;
+#endif
     out_Color[ID_NORMAL].rgba = vec4(0.0, 0.0, 0.0, out_Color[ID_COLOUR].a);
 }
\ No newline at end of file
@@ -10,10 +10,24 @@ in vec2 in_UVs;
 out vec2 ex_UVs;
 
 uniform mat4 world;
-uniform mat4 viewProjection;
+
+// Bound to FRAME_BINDING by the shader as #version 150 can't set the binding
+layout(std140) uniform FrameConstants
+{
+    mat4 viewProjection;
+    mat4 shadowProjection;
+};
+
+#ifdef TEXTURE_ARRAYS
+flat out float ex_Layer;
+uniform float diffuseLayer;
+#endif
 
 void main(void)
 {
     gl_Position = viewProjection * world * in_Position;
     ex_UVs = in_UVs;
+#ifdef TEXTURE_ARRAYS
+    ex_Layer = diffuseLayer;
+#endif
 }
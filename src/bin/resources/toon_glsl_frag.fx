@@ -13,11 +13,20 @@ in vec3 ex_Normal;
 uniform vec3 lightPosition[MAX_LIGHTS];
 uniform vec3 lightDiffuse[MAX_LIGHTS];
 
+#ifdef TEXTURE_ARRAYS
+flat in float ex_Layer;
+uniform sampler2DArray DiffuseSampler;
+#else
 uniform sampler2D DiffuseSampler;
+#endif
 
 void main(void)
 {
+#ifdef TEXTURE_ARRAYS
+    vec4 diffuseTex = texture(DiffuseSampler, vec3(ex_UVs, ex_Layer));
+#else
     vec4 diffuseTex = texture(DiffuseSampler, ex_UVs);
+#endif
     vec3 diffuse = vec3(0.0, 0.0, 0.0);
     vec3 normal = normalize(ex_Normal);
 
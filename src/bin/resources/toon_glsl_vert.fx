@@ -13,12 +13,26 @@ out vec3 ex_PositionWorld;
 out vec3 ex_Normal;
 
 uniform mat4 world;
-uniform mat4 viewProjection;
+
+// Bound to FRAME_BINDING by the shader as #version 150 can't set the binding
+layout(std140) uniform FrameConstants
+{
+    mat4 viewProjection;
+    mat4 shadowProjection;
+};
+
+#ifdef TEXTURE_ARRAYS
+flat out float ex_Layer;
+uniform float diffuseLayer;
+#endif
  
 void main(void)
 {
     gl_Position = viewProjection * world * in_Position;
     ex_UVs = in_UVs;
+#ifdef TEXTURE_ARRAYS
+    ex_Layer = diffuseLayer;
+#endif
     ex_PositionWorld = (world * in_Position).xyz;
     ex_Normal = (world * vec4(in_Normal, 0.0)).xyz;
 }
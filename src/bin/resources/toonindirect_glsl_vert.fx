@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - toonindirect_glsl_vert.fx
+////////////////////////////////////////////////////////////////////////////////////////
+
+#version 430
+
+// Locations match VertexFormat::Attribute
+layout(location = 0) in vec4 in_Position;
+layout(location = 1) in vec2 in_UVs;
+layout(location = 2) in vec3 in_Normal;
+layout(location = 3) in uint in_Instance;
+
+out vec2 ex_UVs;
+out vec3 ex_PositionWorld;
+out vec3 ex_Normal;
+
+layout(std430, binding = INSTANCE_BINDING) readonly buffer InstanceData
+{
+    mat4 worlds[];
+};
+
+#ifdef TEXTURE_ARRAYS
+flat out float ex_Layer;
+
+layout(std430, binding = LAYER_BINDING) readonly buffer InstanceLayers
+{
+    float layers[];
+};
+#endif
+
+layout(std140, binding = FRAME_BINDING) uniform FrameConstants
+{
+    mat4 viewProjection;
+    mat4 shadowProjection;
+};
+ 
+void main(void)
+{
+    mat4 world = worlds[in_Instance];
+    gl_Position = viewProjection * world * in_Position;
+    ex_UVs = in_UVs;
+#ifdef TEXTURE_ARRAYS
+    ex_Layer = layers[in_Instance];
+#endif
+    ex_PositionWorld = (world * in_Position).xyz;
+    ex_Normal = (world * vec4(in_Normal, 0.0)).xyz;
+}
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - toonline_glsl_frag.fx
+////////////////////////////////////////////////////////////////////////////////////////
+
+#version 150
+
+in vec2 ex_UVs;
+out vec4 out_Color;
+
+uniform sampler2D NormalSampler;
+uniform vec2 uvScale;
+ 
+void main(void)
+{
+    // Sample normals of four corners around pixel
+    vec2 offset = vec2(0.0009) * uvScale;
+    vec4 n1 = texture(NormalSampler, ex_UVs + vec2(-offset.x, -offset.y));
+    vec4 n2 = texture(NormalSampler, ex_UVs + vec2(offset.x, offset.y));
+    vec4 n3 = texture(NormalSampler, ex_UVs + vec2(offset.x, -offset.y));
+    vec4 n4 = texture(NormalSampler, ex_UVs + vec2(-offset.x, offset.y));
+
+    // Determine the estimated difference between the pixel normal and surrounding
+    vec4 diagonal1 = abs(n1 - n2);
+    vec4 diagonal2 = abs(n3 - n4);
+    vec4 diagonalDelta = diagonal1 + diagonal2;
+    float edgeAmount = 1.0 - clamp(length(diagonalDelta), 0.0, 1.0);
+
+    out_Color = vec4(edgeAmount);
+}
\ No newline at end of file
@@ -4,8 +4,12 @@
 
 #include "RandomGenerator.h"
 #include "Application.h"
+#include "Logger.h"
+#include "CommandLine.h"
 
 #include <iostream>
+#include <string>
+#include <algorithm>
 
 #ifndef _DEBUG
     // Disable console window
@@ -14,14 +18,52 @@
 
 /**
 * Main entry point
+* @note pass --pipelined to simulate the next frame while rendering
+* @note pass --render-thread to submit frames from a thread which owns the context
+* @note pass --frames-in-flight <value> to set how far recording can run ahead of the GPU
+* @note pass --seed <value> to use a fixed seed for the game
 */
-int main()
+int main(int argc, char* argv[])
 {
     bool pauseConsole = true;
+    auto threading = Application::SEQUENTIAL;
+    int framesInFlight = 3;
+    unsigned int seed = Random::TimeSeed();
 
-    Random::Initialise();
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument(argv[i]);
+        if (argument == "--pipelined")
+        {
+            threading = Application::PIPELINED;
+        }
+        else if (argument == "--render-thread")
+        {
+            threading = Application::RENDER_THREAD;
+        }
+        else if (argument == "--frames-in-flight" && i + 1 < argc)
+        {
+            // The engine limits the count as each frame streams into its own region
+            const std::string value(argv[++i]);
+            if (!ReadInt(value, framesInFlight))
+            {
+                LogError("Invalid frames in flight " + value + ", using " + 
+                    std::to_string(framesInFlight));
+            }
+        }
+        else if (argument == "--seed" && i + 1 < argc)
+        {
+            const std::string value(argv[++i]);
+            if (!ReadUnsigned(value, seed))
+            {
+                LogError("Invalid seed " + value + ", using the time instead");
+            }
+        }
+    }
+
+    LogInfo("Starting initialisation with seed " + std::to_string(seed));
 
-    auto application = std::make_unique<Application>();
+    auto application = std::make_unique<Application>(seed, threading, framesInFlight);
     if (application->Initialise())
     {
         pauseConsole = false;
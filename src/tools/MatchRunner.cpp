@@ -0,0 +1,405 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - MatchRunner.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Game.h"
+#include "Scene.h"
+#include "Camera.h"
+#include "PhysicsEngine.h"
+#include "JobSystem.h"
+#include "SoundSink.h"
+#include "RandomGenerator.h"
+#include "CommandLine.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+    const int DEFAULT_MATCHES = 8;
+    const int DEFAULT_TICK_LIMIT = 18000;
+    const unsigned int DEFAULT_SEED = 1;
+    const float DEFAULT_DELTA_TIME = 1000.0f / 60.0f;  ///< Milliseconds simulated each tick
+    const float TIME_TO_AUTOPILOT_UPDATE = 500.0f;    ///< Milliseconds between player decisions
+
+    /**
+    * Options for all matches
+    */
+    struct Settings
+    {
+        int matches = DEFAULT_MATCHES;
+        int threads = 0;
+        int tickLimit = DEFAULT_TICK_LIMIT;
+        unsigned int seed = DEFAULT_SEED;
+        float deltaTime = DEFAULT_DELTA_TIME;
+        SceneSettings scene;
+    };
+
+    /**
+    * Statistics for a single match
+    */
+    struct MatchResult
+    {
+        unsigned int seed = 0;
+        std::string outcome = "failed";
+        int ticks = 0;
+        int enemiesAlive = 0;
+        bool playerAlive = false;
+        double simulatedSeconds = 0.0;
+        double wallSeconds = 0.0;
+        std::array<int, SoundSink::NUMBER_OF_SOUNDS> sounds = {};
+        std::map<std::string, double> timings;
+    };
+
+    /**
+    * Counts sounds requested by the game instead of playing them
+    */
+    class SoundCounter : public SoundSink
+    {
+    public:
+
+        virtual void PlaySoundEffect(Sound ID) override
+        {
+            ++m_sounds[ID];
+        }
+
+        const std::array<int, NUMBER_OF_SOUNDS>& Sounds() const
+        {
+            return m_sounds;
+        }
+
+    private:
+
+        std::array<int, NUMBER_OF_SOUNDS> m_sounds = {};
+    };
+
+    /**
+    * Sends random held requests for the player in place of keyboard input
+    */
+    class Autopilot
+    {
+    public:
+
+        Autopilot(unsigned int seed)
+            : m_random(seed)
+        {
+        }
+
+        void Update(Game& game, float deltaTime)
+        {
+            m_timePassed += deltaTime;
+            const bool decide = m_timePassed >= TIME_TO_AUTOPILOT_UPDATE;
+            if (decide)
+            {
+                m_timePassed = 0.0f;
+                m_move = m_random.Generate(-1, 1);
+                m_rotate = m_random.Generate(-1, 1);
+                m_rotateGun = m_random.Generate(-1, 1);
+            }
+
+            if (m_move != 0)
+            {
+                game.MovePlayer(m_move > 0);
+            }
+            if (m_rotate != 0)
+            {
+                game.RotatePlayer(m_rotate > 0);
+            }
+            if (m_rotateGun != 0)
+            {
+                game.RotatePlayerGun(m_rotateGun > 0);
+            }
+            if (decide && m_random.Generate(0, 3) == 0)
+            {
+                game.FirePlayer();
+            }
+        }
+
+    private:
+
+        Random m_random;
+        float m_timePassed = 0.0f;
+        int m_move = 0;
+        int m_rotate = 0;
+        int m_rotateGun = 0;
+    };
+
+    /**
+    * Simulates a single match until one side is destroyed or the tick limit is reached
+    */
+    MatchResult RunMatch(const Settings& settings, unsigned int seed)
+    {
+        MatchResult result;
+        result.seed = seed;
+
+        Camera camera;
+        PhysicsEngine physics;
+        SoundCounter sound;
+        Scene scene;
+        Game game(camera, physics, sound, seed);
+        Autopilot autopilot(seed);
+
+        // Matches are already spread across threads so each one runs serially
+        JobSystem jobs(0);
+
+        if (!scene.Initialise(physics, jobs, settings.scene) ||
+            !game.Initialise(scene.GetSceneData()))
+        {
+            return result;
+        }
+
+        const float physicsDeltaTime = PhysicsEngine::GetPhysicsDeltaTime(settings.deltaTime);
+        const float physicsTimeStep = PhysicsEngine::GetTimeStep(physicsDeltaTime);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        while (result.ticks < settings.tickLimit &&
+               game.IsPlayerAlive() &&
+               game.GetEnemiesAlive() > 0)
+        {
+            autopilot.Update(game, settings.deltaTime);
+
+            const auto prePhysics = game.AddPrePhysicsJobs(
+                jobs, settings.deltaTime, physicsDeltaTime, {});
+
+            const auto physicsTick = jobs.Add("Physics", [&physics, physicsTimeStep]()
+            {
+                physics.Tick(physicsTimeStep);
+            }, { prePhysics });
+
+            const auto postPhysics = game.AddPostPhysicsJobs(
+                jobs, settings.deltaTime, { physicsTick });
+
+            scene.AddTickJobs(jobs, { postPhysics });
+            jobs.Execute();
+            ++result.ticks;
+        }
+
+        result.wallSeconds = std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        result.simulatedSeconds = result.ticks * settings.deltaTime / 1000.0;
+        result.playerAlive = game.IsPlayerAlive();
+        result.enemiesAlive = game.GetEnemiesAlive();
+        result.sounds = sound.Sounds();
+        result.timings = jobs.GetTotalTimings();
+
+        if (!result.playerAlive && result.enemiesAlive == 0)
+        {
+            result.outcome = "draw";
+        }
+        else if (!result.playerAlive)
+        {
+            result.outcome = "enemies";
+        }
+        else if (result.enemiesAlive == 0)
+        {
+            result.outcome = "player";
+        }
+        else
+        {
+            result.outcome = "timeout";
+        }
+
+        return result;
+    }
+
+    /**
+    * @return the simulated seconds per wall second
+    */
+    double GetThroughput(double simulatedSeconds, double wallSeconds)
+    {
+        return wallSeconds > 0.0 ? simulatedSeconds / wallSeconds : 0.0;
+    }
+
+    /**
+    * Writes job timings as a JSON object
+    */
+    void WriteTimings(std::ostream& stream,
+                      const std::map<std::string, double>& timings,
+                      const std::string& indent)
+    {
+        stream << "{";
+        for (auto itr = timings.begin(); itr != timings.end(); ++itr)
+        {
+            stream << (itr == timings.begin() ? "\n" : ",\n")
+                << indent << "  \"" << itr->first << "\": " << itr->second;
+        }
+        stream << "\n" << indent << "}";
+    }
+
+    /**
+    * Writes all match results as JSON
+    */
+    void WriteResults(std::ostream& stream,
+                      const Settings& settings,
+                      int threads,
+                      const std::vector<MatchResult>& results,
+                      double wallSeconds)
+    {
+        int ticks = 0;
+        double simulatedSeconds = 0.0;
+        std::map<std::string, double> timings;
+        std::map<std::string, int> outcomes;
+
+        for (const auto& result : results)
+        {
+            ticks += result.ticks;
+            simulatedSeconds += result.simulatedSeconds;
+            ++outcomes[result.outcome];
+            for (const auto& timing : result.timings)
+            {
+                timings[timing.first] += timing.second;
+            }
+        }
+
+        stream << "{\n";
+        stream << "  \"settings\": {\n";
+        stream << "    \"matches\": " << settings.matches << ",\n";
+        stream << "    \"threads\": " << threads << ",\n";
+        stream << "    \"tanks\": " << settings.scene.tanks << ",\n";
+        stream << "    \"bullets\": " << settings.scene.bullets << ",\n";
+        stream << "    \"tickLimit\": " << settings.tickLimit << ",\n";
+        stream << "    \"seed\": " << settings.seed << ",\n";
+        stream << "    \"deltaTimeMs\": " << settings.deltaTime << "\n";
+        stream << "  },\n";
+
+        stream << "  \"matches\": [";
+        for (unsigned int i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+            stream << (i == 0 ? "\n" : ",\n");
+            stream << "    {\n";
+            stream << "      \"seed\": " << result.seed << ",\n";
+            stream << "      \"outcome\": \"" << result.outcome << "\",\n";
+            stream << "      \"ticks\": " << result.ticks << ",\n";
+            stream << "      \"playerAlive\": " << (result.playerAlive ? "true" : "false") << ",\n";
+            stream << "      \"enemiesAlive\": " << result.enemiesAlive << ",\n";
+            stream << "      \"shotsFired\": " << result.sounds[SoundSink::SHOOT] << ",\n";
+            stream << "      \"explosions\": " << result.sounds[SoundSink::EXPLODE] << ",\n";
+            stream << "      \"simulatedSeconds\": " << result.simulatedSeconds << ",\n";
+            stream << "      \"wallSeconds\": " << result.wallSeconds << ",\n";
+            stream << "      \"simulatedPerWallSecond\": "
+                << GetThroughput(result.simulatedSeconds, result.wallSeconds) << ",\n";
+            stream << "      \"timingsMs\": ";
+            WriteTimings(stream, result.timings, "      ");
+            stream << "\n    }";
+        }
+        stream << "\n  ],\n";
+
+        stream << "  \"totals\": {\n";
+        stream << "    \"outcomes\": {";
+        for (auto itr = outcomes.begin(); itr != outcomes.end(); ++itr)
+        {
+            stream << (itr == outcomes.begin() ? " " : ", ")
+                << "\"" << itr->first << "\": " << itr->second;
+        }
+        stream << " },\n";
+        stream << "    \"ticks\": " << ticks << ",\n";
+        stream << "    \"simulatedSeconds\": " << simulatedSeconds << ",\n";
+        stream << "    \"wallSeconds\": " << wallSeconds << ",\n";
+        stream << "    \"simulatedPerWallSecond\": "
+            << GetThroughput(simulatedSeconds, wallSeconds) << ",\n";
+        stream << "    \"timingsMs\": ";
+        WriteTimings(stream, timings, "    ");
+        stream << "\n  }\n";
+        stream << "}" << std::endl;
+    }
+
+    /**
+    * Reads the command line options
+    * @return whether all options were valid
+    */
+    bool ReadSettings(int argc, char* argv[], Settings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option(argv[i]);
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+
+            const std::string value(argv[++i]);
+            int number = 0;
+            unsigned int seed = 0;
+            float decimal = 0.0f;
+            if (option == "--matches" && ReadInt(value, number))
+            {
+                settings.matches = std::max(number, 1);
+            }
+            else if (option == "--threads" && ReadInt(value, number))
+            {
+                settings.threads = std::max(number, 1);
+            }
+            else if (option == "--tanks" && ReadInt(value, number))
+            {
+                settings.scene.tanks = std::max(number, 2);
+            }
+            else if (option == "--bullets" && ReadInt(value, number))
+            {
+                settings.scene.bullets = std::max(number, 1);
+            }
+            else if (option == "--ticks" && ReadInt(value, number))
+            {
+                settings.tickLimit = std::max(number, 1);
+            }
+            else if (option == "--seed" && ReadUnsigned(value, seed))
+            {
+                settings.seed = seed;
+            }
+            else if (option == "--dt" && ReadFloat(value, decimal))
+            {
+                settings.deltaTime = std::max(decimal, 0.001f);
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+* Runs headless matches across a thread pool and reports the results as JSON
+* Usage: MatchRunner [--matches N] [--threads N] [--tanks N] [--bullets N]
+*                    [--ticks N] [--seed N] [--dt milliseconds]
+*/
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    settings.scene.headless = true;
+
+    if (!ReadSettings(argc, argv, settings))
+    {
+        std::cerr << "Usage: MatchRunner [--matches N] [--threads N] [--tanks N] "
+            "[--bullets N] [--ticks N] [--seed N] [--dt milliseconds]" << std::endl;
+        return 1;
+    }
+
+    // Engine logging is moved to stderr so only the results are written to stdout
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::vector<MatchResult> matches(settings.matches);
+    JobSystem pool(settings.threads - 1);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    pool.AddParallelFor("Matches", settings.matches, 1, [&settings, &matches](int index)
+    {
+        matches[index] = RunMatch(settings, settings.seed + index);
+    });
+    pool.Execute();
+
+    const double wallSeconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    WriteResults(results, settings, pool.Threads(), matches, wallSeconds);
+
+    std::cout.rdbuf(results.rdbuf());
+    return 0;
+}
\ No newline at end of file
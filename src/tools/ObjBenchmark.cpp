@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - ObjBenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ObjReader.h"
+
+#include "assimp/include/scene.h"
+#include "assimp/include/Importer.hpp"
+#include "assimp/include/postprocess.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+    const int DEFAULT_ITERATIONS = 20;
+    const std::string DEFAULT_PATH(".//resources//");
+
+    /**
+    * All meshes bundled with the game including those not currently used
+    */
+    const std::vector<std::string> MESHES =
+    {
+        "bottle", "bullet", "bulletproxy", "camera", "ground", "groundproxy",
+        "gunshadow", "tank", "tankgun", "tankgunproxy", "tankp1", "tankp1proxy",
+        "tankp2", "tankp2proxy", "tankp3", "tankp3proxy", "tankp4", "tankp4proxy",
+        "tankproxy", "tankshadow", "toontext", "wall", "wallbox", "wallproxy", "world"
+    };
+
+    /**
+    * Times a function over a number of iterations
+    * @return the average milliseconds for a single iteration
+    */
+    template<typename T> double Time(int iterations, T function)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            function();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    }
+
+    /**
+    * Imports through Assimp with the same post processing used by MeshFile
+    * @return the number of triangles imported
+    */
+    unsigned int ImportAssimp(const std::string& path)
+    {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate|
+            aiProcess_JoinIdenticalVertices|aiProcess_SortByPType|aiProcess_GenSmoothNormals|
+            aiProcess_RemoveRedundantMaterials|aiProcess_OptimizeMeshes);
+
+        unsigned int triangles = 0;
+        for (unsigned int i = 0; scene && i < scene->mNumMeshes; ++i)
+        {
+            triangles += scene->mMeshes[i]->mNumFaces;
+        }
+        return triangles;
+    }
+}
+
+/**
+* Compares the native OBJ reader against Assimp for all bundled meshes
+* Usage: ObjBenchmark [resource path] [iterations]
+*/
+int main(int argc, char* argv[])
+{
+    const std::string path = argc > 1 ? argv[1] : DEFAULT_PATH;
+    const int iterations = argc > 2 ? std::max(std::stoi(argv[2]), 1) : DEFAULT_ITERATIONS;
+
+    ObjReader reader;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    int componentCount = 0;
+
+    double totalAssimp = 0.0;
+    double totalNative = 0.0;
+
+    std::cout << std::left << std::setw(16) << "Mesh"
+        << std::setw(12) << "Triangles"
+        << std::setw(14) << "Assimp (ms)"
+        << std::setw(14) << "Native (ms)"
+        << "Speedup" << std::endl;
+
+    for (const auto& mesh : MESHES)
+    {
+        const std::string file = path + mesh + ".obj";
+        if (!reader.Read(file, true, true, vertices, indices, componentCount))
+        {
+            std::cout << std::setw(16) << mesh << reader.GetError() << std::endl;
+            continue;
+        }
+
+        const unsigned int triangles = static_cast<unsigned int>(indices.size() / 3);
+        if (ImportAssimp(file) != triangles)
+        {
+            std::cout << std::setw(16) << mesh << "Triangle count does not match Assimp" << std::endl;
+        }
+
+        const double assimp = Time(iterations, [&file]()
+        {
+            ImportAssimp(file);
+        });
+
+        const double native = Time(iterations, [&]()
+        {
+            reader.Read(file, true, true, vertices, indices, componentCount);
+        });
+
+        totalAssimp += assimp;
+        totalNative += native;
+
+        std::cout << std::setw(16) << mesh
+            << std::setw(12) << triangles
+            << std::setw(14) << assimp
+            << std::setw(14) << native
+            << assimp / native << std::endl;
+    }
+
+    std::cout << std::setw(16) << "Total"
+        << std::setw(12) << ""
+        << std::setw(14) << totalAssimp
+        << std::setw(14) << totalNative
+        << totalAssimp / totalNative << std::endl;
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - RenderRunner.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OpenGLEngine.h"
+#include "Game.h"
+#include "Scene.h"
+#include "Camera.h"
+#include "PhysicsEngine.h"
+#include "JobSystem.h"
+#include "SoundSink.h"
+#include "RenderSnapshot.h"
+#include "RenderCommandList.h"
+#include "SceneRecorder.h"
+#include "NullBackend.h"
+#include "Utils.h"
+#include "CommandLine.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+    const int DEFAULT_FRAMES = 300;
+    const int DEFAULT_WARMUP = 30;
+    const unsigned int DEFAULT_SEED = 1;
+    const float DEFAULT_DELTA_TIME = 1000.0f / 60.0f;  ///< Milliseconds simulated each frame
+
+    /**
+    * Options for the run
+    */
+    struct Settings
+    {
+        int frames = DEFAULT_FRAMES;
+        int warmup = DEFAULT_WARMUP;
+        unsigned int seed = DEFAULT_SEED;
+        float deltaTime = DEFAULT_DELTA_TIME;
+        OpenGLEngine::AntiAliasing antiAliasing = OpenGLEngine::MSAA;
+        bool nullBackend = false;
+        bool textureArrays = false;
+        std::string capture;
+    };
+
+    /**
+    * Statistics for the measured frames
+    */
+    struct RenderResult
+    {
+        double wallSeconds = 0.0;
+        double sceneGpuMs = 0.0;
+        double postGpuMs = 0.0;
+        double recordMs = 0.0;
+        int driverErrors = 0;
+        int textureBinds = 0;
+        int commands = 0;
+        int drawCalls = 0;
+        int shadowDrawCalls = 0;
+    };
+
+    /**
+    * Discards sounds requested by the game
+    */
+    class SilentSound : public SoundSink
+    {
+    public:
+
+        virtual void PlaySoundEffect(Sound) override
+        {
+        }
+    };
+
+    /**
+    * Simulates a frame with no player input and fills the snapshot to render
+    */
+    void SimulateFrame(const Settings& settings,
+                       Game& game,
+                       Scene& scene,
+                       Camera& camera,
+                       PhysicsEngine& physics,
+                       JobSystem& jobs,
+                       RenderSnapshot& snapshot)
+    {
+        const float physicsDeltaTime = PhysicsEngine::GetPhysicsDeltaTime(settings.deltaTime);
+        const float physicsTimeStep = PhysicsEngine::GetTimeStep(physicsDeltaTime);
+
+        const auto prePhysics = game.AddPrePhysicsJobs(
+            jobs, settings.deltaTime, physicsDeltaTime, {});
+
+        const auto physicsTick = jobs.Add("Physics", [&physics, physicsTimeStep]()
+        {
+            physics.Tick(physicsTimeStep);
+        }, { prePhysics });
+
+        const auto postPhysics = game.AddPostPhysicsJobs(
+            jobs, settings.deltaTime, { physicsTick });
+
+        scene.AddTickJobs(jobs, { postPhysics });
+        jobs.Execute();
+
+        camera.UpdateView();
+        snapshot.viewProjection = camera.ViewProjection();
+        snapshot.projection = camera.Projection();
+        snapshot.cameraPosition = camera.Position();
+        scene.FillSnapshot(snapshot);
+    }
+
+    /**
+    * Renders the match through OpenGL with a headless context
+    * @return whether the run completed
+    */
+    bool RunOpenGL(const Settings& settings, RenderResult& result)
+    {
+        Camera camera;
+        PhysicsEngine physics;
+        SilentSound sound;
+        JobSystem jobs;
+        RenderSnapshot snapshot;
+        SceneSettings sceneSettings;
+        sceneSettings.textureArrays = settings.textureArrays;
+        auto scene = std::make_unique<Scene>();
+        auto game = std::make_unique<Game>(camera, physics, sound, settings.seed);
+        auto engine = std::make_unique<OpenGLEngine>(scene->GetSceneData(), true);
+
+        bool success = false;
+        if (engine->Initialise() &&
+            scene->Initialise(physics, jobs, sceneSettings) &&
+            game->Initialise(scene->GetSceneData()) &&
+            engine->InitialiseScene())
+        {
+            engine->SetAntiAliasing(settings.antiAliasing);
+            camera.SetAspectRatio(engine->AspectRatio());
+
+            for (int i = 0; i < settings.frames + settings.warmup; ++i)
+            {
+                if (i == settings.warmup)
+                {
+                    result = RenderResult();
+                }
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                SimulateFrame(settings, *game, *scene, camera, physics, jobs, snapshot);
+                engine->RenderScene(snapshot);
+                engine->EndRender();
+                if (i + 1 == settings.frames + settings.warmup)
+                {
+                    glFinish();
+                }
+
+                result.wallSeconds += std::chrono::duration<double>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+                result.sceneGpuMs += engine->SceneMilliseconds();
+                result.postGpuMs += engine->PostMilliseconds();
+                result.driverErrors += engine->DriverErrors();
+                result.textureBinds += engine->TextureBinds();
+            }
+
+            success = settings.capture.empty() || engine->SaveBackBuffer(settings.capture);
+        }
+
+        // All OpenGL resources must be released before the engine
+        game.reset();
+        scene.reset();
+        engine.reset();
+        return success;
+    }
+
+    /**
+    * Records the match into a command list executed by the null backend
+    * Requires no context so measures the cost of recording alone
+    * @return whether the run completed
+    */
+    bool RunNull(const Settings& settings, RenderResult& result)
+    {
+        SceneSettings sceneSettings;
+        sceneSettings.headless = true;
+
+        Camera camera;
+        PhysicsEngine physics;
+        SilentSound sound;
+        JobSystem jobs;
+        RenderSnapshot snapshot;
+        RenderCommandList commands;
+        NullBackend backend;
+        Scene scene;
+        Game game(camera, physics, sound, settings.seed);
+
+        if (!scene.Initialise(physics, jobs, sceneSettings) ||
+            !game.Initialise(scene.GetSceneData()))
+        {
+            return false;
+        }
+
+        SceneRecorder recorder(scene.GetSceneData());
+
+        for (int i = 0; i < settings.frames + settings.warmup; ++i)
+        {
+            if (i == settings.warmup)
+            {
+                result = RenderResult();
+            }
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            SimulateFrame(settings, game, scene, camera, physics, jobs, snapshot);
+
+            const auto recordStart = std::chrono::high_resolution_clock::now();
+            commands.Clear();
+            recorder.Record(snapshot, WINDOW_HEIGHT, commands);
+            backend.Execute(commands);
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            result.wallSeconds += std::chrono::duration<double>(end - start).count();
+            result.recordMs += std::chrono::duration<double, std::milli>(end - recordStart).count();
+            result.commands += backend.Total();
+            result.drawCalls += recorder.DrawCalls();
+            result.shadowDrawCalls += recorder.ShadowDrawCalls();
+        }
+        return true;
+    }
+
+    /**
+    * Writes the run results as JSON
+    */
+    void WriteResults(std::ostream& stream, 
+                      const Settings& settings, 
+                      const RenderResult& result)
+    {
+        const double frames = std::max(settings.frames, 1);
+
+        stream << "{\n";
+        stream << "  \"settings\": {\n";
+        stream << "    \"frames\": " << settings.frames << ",\n";
+        stream << "    \"warmup\": " << settings.warmup << ",\n";
+        stream << "    \"seed\": " << settings.seed << ",\n";
+        stream << "    \"deltaTimeMs\": " << settings.deltaTime << ",\n";
+        stream << "    \"antiAliasing\": \"" 
+            << OpenGLEngine::GetAntiAliasingName(settings.antiAliasing) << "\",\n";
+        stream << "    \"backend\": \"" << (settings.nullBackend ? "null" : "opengl") << "\",\n";
+        stream << "    \"textures\": \"" << (settings.textureArrays ? "arrays" : "separate") << "\"\n";
+        stream << "  },\n";
+        stream << "  \"wallSeconds\": " << result.wallSeconds << ",\n";
+        stream << "  \"frameMs\": " << result.wallSeconds * 1000.0 / frames << ",\n";
+        stream << "  \"sceneGpuMs\": " << result.sceneGpuMs / frames << ",\n";
+        stream << "  \"postGpuMs\": " << result.postGpuMs / frames << ",\n";
+        stream << "  \"recordMs\": " << result.recordMs / frames << ",\n";
+        stream << "  \"commands\": " << result.commands / frames << ",\n";
+        stream << "  \"drawCalls\": " << result.drawCalls / frames << ",\n";
+        stream << "  \"shadowDrawCalls\": " << result.shadowDrawCalls / frames << ",\n";
+        stream << "  \"textureBinds\": " << result.textureBinds / frames << ",\n";
+        stream << "  \"driverErrors\": " << result.driverErrors << "\n";
+        stream << "}" << std::endl;
+    }
+
+    /**
+    * Reads the command line options
+    * @return whether all options were valid
+    */
+    bool ReadSettings(int argc, char* argv[], Settings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option(argv[i]);
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+
+            const std::string value(argv[++i]);
+            int number = 0;
+            unsigned int seed = 0;
+            float decimal = 0.0f;
+            if (option == "--frames" && ReadInt(value, number))
+            {
+                settings.frames = std::max(number, 1);
+            }
+            else if (option == "--warmup" && ReadInt(value, number))
+            {
+                settings.warmup = std::max(number, 0);
+            }
+            else if (option == "--seed" && ReadUnsigned(value, seed))
+            {
+                settings.seed = seed;
+            }
+            else if (option == "--dt" && ReadFloat(value, decimal))
+            {
+                settings.deltaTime = std::max(decimal, 0.001f);
+            }
+            else if (option == "--aa" && (value == "msaa" || value == "fxaa"))
+            {
+                settings.antiAliasing = value == "msaa" ? OpenGLEngine::MSAA : OpenGLEngine::FXAA;
+            }
+            else if (option == "--backend" && (value == "opengl" || value == "null"))
+            {
+                settings.nullBackend = value == "null";
+            }
+            else if (option == "--textures" && (value == "separate" || value == "arrays"))
+            {
+                settings.textureArrays = value == "arrays";
+            }
+            else if (option == "--capture")
+            {
+                settings.capture = value;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+* Renders a fixed seed match offscreen and reports the frame timings as JSON
+* Runs without a display or GPU through a software EGL driver such as llvmpipe,
+* with the final frame optionally saved for comparing against a golden image
+* The null backend records the same frames without a context to isolate the CPU cost
+* Usage: RenderRunner [--frames N] [--warmup N] [--seed N] [--dt milliseconds]
+*                     [--aa msaa|fxaa] [--backend opengl|null]
+*                     [--textures separate|arrays] [--capture path.png]
+*/
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    if (!ReadSettings(argc, argv, settings))
+    {
+        std::cerr << "Usage: RenderRunner [--frames N] [--warmup N] [--seed N] "
+            "[--dt milliseconds] [--aa msaa|fxaa] [--backend opengl|null] "
+            "[--textures separate|arrays] [--capture path.png]" << std::endl;
+        return 1;
+    }
+
+    // Engine logging is moved to stderr so only the results are written to stdout
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    RenderResult result;
+    const bool success = settings.nullBackend ? 
+        RunNull(settings, result) : RunOpenGL(settings, result);
+
+    if (success)
+    {
+        WriteResults(results, settings, result);
+    }
+
+    std::cout.rdbuf(results.rdbuf());
+    return success ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////////////
+// Kara Jensen - mail@karajensen.com - TransformBenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "InstanceTransforms.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+    const int DEFAULT_INSTANCES = 50000;
+    const int DEFAULT_ITERATIONS = 100;
+
+    /**
+    * Previous array of structures instance layout
+    */
+    struct Instance
+    {
+        glm::mat4 world;
+        glm::vec3 position = glm::vec3(0,0,0);
+        glm::vec3 rotation = glm::vec3(0,0,0);
+        glm::vec3 scale = glm::vec3(1,1,1);
+        bool render = true;
+        bool requiresUpdate = false;
+        int texture = -1;
+    };
+
+    /**
+    * Previous per instance world matrix update
+    */
+    void UpdateInstances(std::vector<Instance>& instances)
+    {
+        for (auto& instance : instances)
+        {
+            if (instance.render && instance.requiresUpdate)
+            {
+                instance.requiresUpdate = false;
+
+                glm::mat4 scale;
+                scale[0][0] = instance.scale.x;
+                scale[1][1] = instance.scale.y;
+                scale[2][2] = instance.scale.z;
+
+                glm::mat4 translate;
+                translate[3][0] = instance.position.x;
+                translate[3][1] = instance.position.y;
+                translate[3][2] = instance.position.z;
+
+                glm::mat4 rotateX, rotateY, rotateZ;
+                rotateX = glm::rotate(rotateX, instance.rotation.x, glm::vec3(1, 0, 0));
+                rotateY = glm::rotate(rotateY, instance.rotation.y, glm::vec3(0, 1, 0));
+                rotateZ = glm::rotate(rotateZ, instance.rotation.z, glm::vec3(0, 0, 1));
+
+                instance.world = translate * (rotateZ * rotateX * rotateY) * scale;
+            }
+        }
+    }
+
+    /**
+    * Times a function over a number of iterations
+    * @return the average milliseconds for a single iteration
+    */
+    template<typename T> double Time(int iterations, T function)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            function();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    }
+}
+
+/**
+* Compares the structure of arrays SSE transform update against the previous path
+* Usage: TransformBenchmark [instances] [iterations]
+*/
+int main(int argc, char* argv[])
+{
+    const int count = argc > 1 ? std::max(std::stoi(argv[1]), 1) : DEFAULT_INSTANCES;
+    const int iterations = argc > 2 ? std::max(std::stoi(argv[2]), 1) : DEFAULT_ITERATIONS;
+
+    std::default_random_engine generator(0);
+    std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> degrees(-360.0f, 360.0f);
+    std::uniform_real_distribution<float> scales(0.1f, 4.0f);
+
+    std::vector<Instance> instances(count);
+    InstanceTransforms transforms;
+    transforms.Resize(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto& instance = instances[i];
+        instance.position = glm::vec3(positions(generator), positions(generator), positions(generator));
+        instance.rotation = glm::vec3(degrees(generator), degrees(generator), degrees(generator));
+        instance.scale = glm::vec3(scales(generator), scales(generator), scales(generator));
+
+        transforms.Position(instance.position, i);
+        transforms.Rotation(instance.rotation, i);
+        transforms.Scale(instance.scale, i);
+    }
+
+    const double previous = Time(iterations, [&instances]()
+    {
+        for (auto& instance : instances)
+        {
+            instance.requiresUpdate = true;
+        }
+        UpdateInstances(instances);
+    });
+
+    const double simd = Time(iterations, [&transforms, &instances, count]()
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            transforms.Scale(instances[i].scale, i);
+        }
+        transforms.Update();
+    });
+
+    float maxError = 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const auto& expected = instances[i].world;
+        const auto& actual = transforms.World(i);
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                maxError = std::max(maxError, std::abs(expected[column][row] - actual[column][row]));
+            }
+        }
+    }
+
+    std::cout << "Instances: " << count << std::endl;
+    std::cout << "Iterations: " << iterations << std::endl;
+    std::cout << "Previous (ms): " << previous << std::endl;
+    std::cout << "SIMD (ms): " << simd << std::endl;
+    std::cout << "Speedup: " << previous / simd << std::endl;
+    std::cout << "Max Error: " << maxError << std::endl;
+
+    return 0;
+}
\ No newline at end of file